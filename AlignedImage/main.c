@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Define BMP header size
+#define BMP_HEADER_SIZE 54
+// Size of color table for 8-bit BMP
+#define BMP_COLOR_TABLE_SIZE 1024
+// Alignment of every row in bytes (one cache line / AVX-512 register)
+#define ROW_ALIGNMENT 64
+
+// Round n up to a multiple of the (power of two) alignment a
+#define ALIGN_UP(n, a) (((n) + (a) - 1) & ~((a) - 1))
+
+// Structure to hold 8-bit BMP image data in a stride-aware, aligned buffer
+// Rows start on ROW_ALIGNMENT boundaries and are surrounded by a guard band
+// of `guard` pixels on every side, so neighborhood filters may read up to
+// `guard` pixels past the image border without bounds checks
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
+    unsigned char colorTable[BMP_COLOR_TABLE_SIZE]; // Color table for 8-bit BMP (256 * 4 bytes)
+    unsigned char *buffer;                          // Start of the aligned allocation
+    unsigned char *data;                            // First pixel of the first image row
+    int width;                                      // Image width in pixels
+    int height;                                     // Image height in pixels
+    int bitDepth;                                   // Bits per pixel (8 for grayscale)
+    int stride;                                     // Bytes between rows (multiple of ROW_ALIGNMENT)
+    int guard;                                      // Guard band width in pixels
+} BMP8Image;
+
+
+// Allocate an aligned image with the given geometry and guard band
+// Header and color table are left for the caller to fill
+BMP8Image* BMP8Create(int width, int height, int guard) {
+    BMP8Image *img = (BMP8Image*)malloc(sizeof(BMP8Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    img->width = width;
+    img->height = height;
+    img->bitDepth = 8;
+    img->guard = guard;
+
+    // Left guard is rounded up so the first image pixel of each row is aligned
+    int left = ALIGN_UP(guard, ROW_ALIGNMENT);
+    // Right side leaves room for whole 16-byte vectors plus the guard band
+    img->stride = ALIGN_UP(left + ALIGN_UP(width, 16) + guard, ROW_ALIGNMENT);
+
+    // aligned_alloc requires the size to be a multiple of the alignment
+    size_t size = (size_t)img->stride * (height + 2 * guard);
+    img->buffer = aligned_alloc(ROW_ALIGNMENT, size);
+    if (!img->buffer) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(img);
+        return NULL;
+    }
+    memset(img->buffer, 0, size);
+
+    img->data = img->buffer + (size_t)guard * img->stride + left;
+    return img;
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img) {
+    BMP8Image *copy = BMP8Create(img->width, img->height, img->guard);
+    if (!copy) {
+        return NULL;
+    }
+    memcpy(copy->header, img->header, BMP_HEADER_SIZE);
+    memcpy(copy->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    copy->bitDepth = img->bitDepth;
+    return copy;
+}
+
+// Function to read an 8-bit BMP image from a file into an aligned buffer
+// Rows are translated from the 4-byte on-disk padding to the aligned stride
+BMP8Image* BMP8read(const char* filename, int guard) {
+    // open file
+    FILE *fInput = fopen(filename, "rb");
+    if (!fInput) {
+        fprintf(stderr, "Unable to open file %s!\n", filename);
+        return NULL;
+    }
+
+    // Read header (54 bytes)
+    unsigned char header[BMP_HEADER_SIZE];
+    fread(header, sizeof(unsigned char), BMP_HEADER_SIZE, fInput);
+
+    // Extract metadata from header
+    int width = *(int*)&header[18];
+    int height = *(int*)&header[22];
+    int bitDepth = *(short*)&header[28];
+    if (bitDepth != 8) {
+        fprintf(stderr, "Not an 8-bit BMP\n");
+        fclose(fInput);
+        return NULL;
+    }
+
+    BMP8Image *img = BMP8Create(width, height, guard);
+    if (!img) {
+        fclose(fInput);
+        return NULL;
+    }
+    memcpy(img->header, header, BMP_HEADER_SIZE);
+
+    // Read color table
+    fread(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fInput);
+
+    // Read every padded row from disk into its aligned row
+    int rowSize = (width + 3) & ~3;
+    for (int y = 0; y < height; y++) {
+        unsigned char *row = img->data + (size_t)y * img->stride;
+        fread(row, sizeof(unsigned char), width, fInput);
+        // Skip on-disk padding bytes
+        fseek(fInput, rowSize - width, SEEK_CUR);
+    }
+
+    fclose(fInput);
+    return img;
+}
+
+// Function to save an 8-bit BMP image to a file
+// Rows are written with the 4-byte on-disk padding expected by BMP readers
+void BMP8save(const char* filename, BMP8Image* img) {
+    FILE *fOutput = fopen(filename, "wb");
+    if (!fOutput) {
+        fprintf(stderr, "Unable to create file %s!\n", filename);
+        return;
+    }
+
+    fwrite(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, fOutput);
+    fwrite(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fOutput);
+
+    int rowSize = (img->width + 3) & ~3;
+    unsigned char padding[3] = {0, 0, 0};
+    for (int y = 0; y < img->height; y++) {
+        fwrite(img->data + (size_t)y * img->stride, sizeof(unsigned char), img->width, fOutput);
+        fwrite(padding, sizeof(unsigned char), rowSize - img->width, fOutput);
+    }
+
+    fclose(fOutput);
+}
+
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->buffer);
+        free(img);
+    }
+}
+
+// Fill the guard band by replicating the nearest border pixel
+void BMP8ExtendBorder(BMP8Image* img) {
+    int left = img->data - (img->buffer + (size_t)img->guard * img->stride);
+    int right = img->stride - left - img->width;
+
+    // Left and right guard of every image row
+    for (int y = 0; y < img->height; y++) {
+        unsigned char *row = img->data + (size_t)y * img->stride;
+        memset(row - left, row[0], left);
+        memset(row + img->width, row[img->width - 1], right);
+    }
+
+    // Top and bottom guard rows are copies of the first and last rows
+    unsigned char *first = img->data - left;
+    unsigned char *last = first + (size_t)(img->height - 1) * img->stride;
+    for (int g = 1; g <= img->guard; g++) {
+        memcpy(first - (size_t)g * img->stride, first, img->stride);
+        memcpy(last + (size_t)g * img->stride, last, img->stride);
+    }
+}
+
+// Blur with a 3x3 averaging filter into a caller-supplied image of the same size
+// Relies on a guard band of at least one pixel, so borders need no special case
+// dst must not alias img (rows are read after neighbouring rows are written)
+bool BMP8Blur3x3Into(BMP8Image* img, BMP8Image* dst) {
+    if (!img || img->guard < 1) {
+        fprintf(stderr, "Blur Error: Image needs a guard band of at least 1 pixel.\n");
+        return false;
+    }
+    if (!dst || dst->width != img->width || dst->height != img->height) {
+        fprintf(stderr, "Blur Error: Destination size does not match the source.\n");
+        return false;
+    }
+    if (dst->data == img->data) {
+        fprintf(stderr, "Blur Error: In-place blur is not supported.\n");
+        return false;
+    }
+    BMP8Image *blurredImg = dst;
+
+    // Make sure reads past the border see replicated edge pixels
+    BMP8ExtendBorder(img);
+
+    for (int y = 0; y < img->height; y++) {
+        const unsigned char *above = img->data + (size_t)(y - 1) * img->stride;
+        const unsigned char *row = img->data + (size_t)y * img->stride;
+        const unsigned char *below = img->data + (size_t)(y + 1) * img->stride;
+        unsigned char *out = blurredImg->data + (size_t)y * blurredImg->stride;
+
+        int x = 0;
+#ifdef __SSE2__
+        // Vector path: 16 pixels per iteration, centre loads and stores are aligned
+        const __m128i zero = _mm_setzero_si128();
+        // 7282 / 65536 rounds every sum in [0, 2295] down to sum / 9 exactly
+        const __m128i ninth = _mm_set1_epi16(7282);
+        for (; x < img->width; x += 16) {
+            __m128i lo = zero, hi = zero;
+            const unsigned char *rows[3] = {above, row, below};
+            for (int r = 0; r < 3; r++) {
+                __m128i l = _mm_loadu_si128((const __m128i*)(rows[r] + x - 1));
+                __m128i c = _mm_load_si128((const __m128i*)(rows[r] + x));
+                __m128i h = _mm_loadu_si128((const __m128i*)(rows[r] + x + 1));
+                lo = _mm_add_epi16(lo, _mm_add_epi16(_mm_unpacklo_epi8(l, zero),
+                     _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(h, zero))));
+                hi = _mm_add_epi16(hi, _mm_add_epi16(_mm_unpackhi_epi8(l, zero),
+                     _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(h, zero))));
+            }
+            lo = _mm_mulhi_epu16(lo, ninth);
+            hi = _mm_mulhi_epu16(hi, ninth);
+            _mm_store_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        // Scalar path (and tail when SSE2 is not available)
+        for (; x < img->width; x++) {
+            int sum = above[x - 1] + above[x] + above[x + 1]
+                    + row[x - 1]   + row[x]   + row[x + 1]
+                    + below[x - 1] + below[x] + below[x + 1];
+            out[x] = (unsigned char)(sum / 9);
+        }
+    }
+
+    return true;
+}
+
+// Function to blur image using a 3x3 averaging filter
+BMP8Image* BMP8Blur3x3(BMP8Image* img) {
+    if (!img) {
+        fprintf(stderr, "Blur Error: Image does not exist.\n");
+        return NULL;
+    }
+
+    BMP8Image *blurredImg = BMP8CreateLike(img);
+    if (!blurredImg) {
+        return NULL;
+    }
+    if (!BMP8Blur3x3Into(img, blurredImg)) {
+        BMP8Free(blurredImg);
+        return NULL;
+    }
+    return blurredImg;
+}
+
+int main() {
+    const char *inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
+    const char *outputFile = "images/lizard_blurred_3x3.bmp";
+
+    // Read BMP image into aligned rows with a 1-pixel guard band
+    BMP8Image *image = BMP8read(inputFile, 1);
+    if (!image) {
+        return 1;
+    }
+
+    // Blur including the border pixels (guard band replicates the edges)
+    BMP8Image *blurred = BMP8Blur3x3(image);
+    if (blurred) {
+        BMP8save(outputFile, blurred);
+        BMP8Free(blurred);
+    }
+
+    BMP8Free(image);
+
+    printf("Aligned blur completed! Saved result as %s\n", outputFile);
+    return 0;
+}
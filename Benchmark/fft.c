@@ -0,0 +1,166 @@
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include "fft.h"
+
+// Columns transformed together so that each pass reads whole cache lines
+#define FFT_COLUMN_BLOCK 8
+
+static fftPlan *planCache = NULL;
+static pthread_mutex_t planLock = PTHREAD_MUTEX_INITIALIZER;
+
+int fftNextPowerOfTwo(int n) {
+    int p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// Build the tables of a new plan
+static fftPlan* planCreate(int n) {
+    fftPlan *plan = malloc(sizeof(fftPlan));
+    if (!plan) {
+        return NULL;
+    }
+    plan->n = n;
+    plan->log2n = 0;
+    while ((1 << plan->log2n) < n) {
+        plan->log2n++;
+    }
+    plan->twiddle = malloc((n / 2 + 1) * sizeof(complexf));
+    plan->bitReverse = malloc(n * sizeof(int));
+    plan->next = NULL;
+    if (!plan->twiddle || !plan->bitReverse) {
+        free(plan->twiddle);
+        free(plan->bitReverse);
+        free(plan);
+        return NULL;
+    }
+
+    // Twiddles in double precision, rounded once
+    for (int k = 0; k < n / 2; k++) {
+        double angle = -2.0 * M_PI * k / n;
+        plan->twiddle[k].re = (float)cos(angle);
+        plan->twiddle[k].im = (float)sin(angle);
+    }
+    for (int i = 0; i < n; i++) {
+        int r = 0;
+        for (int b = 0; b < plan->log2n; b++) {
+            r |= ((i >> b) & 1) << (plan->log2n - 1 - b);
+        }
+        plan->bitReverse[i] = r;
+    }
+    return plan;
+}
+
+const fftPlan* fftPlanGet(int n) {
+    if (n < 1 || (n & (n - 1)) != 0) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&planLock);
+    fftPlan *plan = planCache;
+    while (plan && plan->n != n) {
+        plan = plan->next;
+    }
+    if (!plan) {
+        plan = planCreate(n);
+        if (plan) {
+            plan->next = planCache;
+            planCache = plan;
+        }
+    }
+    pthread_mutex_unlock(&planLock);
+    return plan;
+}
+
+void fftTransform(const fftPlan* plan, complexf* data, bool inverse) {
+    int n = plan->n;
+
+    // Reorder into bit-reversed positions
+    for (int i = 0; i < n; i++) {
+        int r = plan->bitReverse[i];
+        if (i < r) {
+            complexf t = data[i];
+            data[i] = data[r];
+            data[r] = t;
+        }
+    }
+
+    // Iterative decimation-in-time butterflies
+    for (int half = 1; half < n; half <<= 1) {
+        int step = n / (2 * half);
+        for (int start = 0; start < n; start += 2 * half) {
+            for (int k = 0; k < half; k++) {
+                complexf w = plan->twiddle[k * step];
+                if (inverse) {
+                    w.im = -w.im;
+                }
+                complexf *a = &data[start + k];
+                complexf *b = &data[start + k + half];
+                float re = b->re * w.re - b->im * w.im;
+                float im = b->re * w.im + b->im * w.re;
+                b->re = a->re - re;
+                b->im = a->im - im;
+                a->re += re;
+                a->im += im;
+            }
+        }
+    }
+}
+
+bool fft2D(complexf* data, int rows, int cols, bool inverse) {
+    const fftPlan *rowPlan = fftPlanGet(cols);
+    const fftPlan *colPlan = fftPlanGet(rows);
+    complexf *scratch = malloc((size_t)rows * FFT_COLUMN_BLOCK * sizeof(complexf));
+    if (!rowPlan || !colPlan || !scratch) {
+        free(scratch);
+        return false;
+    }
+
+    // Rows are contiguous
+    for (int y = 0; y < rows; y++) {
+        fftTransform(rowPlan, data + (size_t)y * cols, inverse);
+    }
+
+    // Columns: gather a block of columns, transform each, scatter back
+    for (int x0 = 0; x0 < cols; x0 += FFT_COLUMN_BLOCK) {
+        int block = cols - x0 < FFT_COLUMN_BLOCK ? cols - x0 : FFT_COLUMN_BLOCK;
+        for (int y = 0; y < rows; y++) {
+            for (int b = 0; b < block; b++) {
+                scratch[b * rows + y] = data[(size_t)y * cols + x0 + b];
+            }
+        }
+        for (int b = 0; b < block; b++) {
+            fftTransform(colPlan, scratch + b * rows, inverse);
+        }
+        for (int y = 0; y < rows; y++) {
+            for (int b = 0; b < block; b++) {
+                data[(size_t)y * cols + x0 + b] = scratch[b * rows + y];
+            }
+        }
+    }
+
+    if (inverse) {
+        float scale = 1.0f / ((float)rows * cols);
+        for (size_t i = 0; i < (size_t)rows * cols; i++) {
+            data[i].re *= scale;
+            data[i].im *= scale;
+        }
+    }
+    free(scratch);
+    return true;
+}
+
+void fftPlanCacheClear(void) {
+    pthread_mutex_lock(&planLock);
+    while (planCache) {
+        fftPlan *next = planCache->next;
+        free(planCache->twiddle);
+        free(planCache->bitReverse);
+        free(planCache);
+        planCache = next;
+    }
+    pthread_mutex_unlock(&planLock);
+}
@@ -0,0 +1,512 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "operators.h"
+#include "perfcounters.h"
+
+// Largest number of image sizes accepted on the command line
+#define MAX_SIZES 16
+// Upper bound on timed repetitions of one case
+#define MAX_REPETITIONS 1000
+// Buffer size used to measure peak memory bandwidth
+#define BANDWIDTH_BYTES (256u * 1024 * 1024)
+
+// Inputs shared by all operators at one image size
+typedef struct {
+    BMP8Image *src;         // 8-bit input
+    BMP8Image *dst;         // 8-bit output of the same size
+    BMP24Image *color;      // 24-bit input for colour conversion
+    mask *m;                // Convolution mask of the current case
+    float hist[256];        // Histogram output
+} benchContext;
+
+// One benchmarked operator configuration
+typedef struct {
+    const char *name;       // Operator name used for filtering and in the report
+    const char *param;      // Parameter description
+    int arg;                // Numeric parameter (mask side, kernel size, ...)
+    double readBytes;       // Bytes read per pixel (compulsory traffic)
+    double writeBytes;      // Bytes written per pixel (compulsory traffic)
+    bool (*run)(benchContext* ctx, int arg);
+} benchCase;
+
+// Measurement of one case at one size
+typedef struct {
+    int repetitions;
+    double bestSeconds;
+    double medianSeconds;
+    double cycles;          // TSC cycles of the best run (0 without a TSC)
+    double events[PERF_COUNTER_COUNT];  // Hardware counts per run, averaged over all runs
+    bool counted[PERF_COUNTER_COUNT];   // true when events holds a count
+} benchResult;
+
+static bool runConvolution(benchContext* ctx, int arg) {
+    (void)arg;
+    return BMP8ConvolutionInto(ctx->src, ctx->m, ctx->dst);
+}
+
+static bool runConvolutionConstant(benchContext* ctx, int arg) {
+    (void)arg;
+    return BMP8ConvolutionConstant3x3Into(ctx->src, ctx->dst);
+}
+
+static bool runMedian(benchContext* ctx, int arg) {
+    return BMP8FilterMedianInto(ctx->src, arg, ctx->dst);
+}
+
+static bool runBlur(benchContext* ctx, int arg) {
+    return BMP8BlurInto(ctx->src, arg, ctx->dst);
+}
+
+static bool runHistogram(benchContext* ctx, int arg) {
+    (void)arg;
+    return BMP8HistogramInto(ctx->src, ctx->hist);
+}
+
+static bool runRotation(benchContext* ctx, int arg) {
+    (void)arg;
+    // Square images keep their size under rotation, so dst can be reused
+    return BMP8RotateInto(ctx->src, CLOCKWISE, ctx->dst);
+}
+
+static bool runNoiseGaussian(benchContext* ctx, int arg) {
+    (void)arg;
+    return BMP8NoiseGaussianInto(ctx->src, 0.0f, 100.0f, ctx->dst);
+}
+
+static bool runNoiseSaltPepper(benchContext* ctx, int arg) {
+    (void)arg;
+    return BMP8NoiseSaltPepperInto(ctx->src, 0.05f, ctx->dst);
+}
+
+static bool runGreyscale(benchContext* ctx, int arg) {
+    (void)arg;
+    return BMP24ConvertTo8Into(ctx->color, ctx->dst);
+}
+
+static const benchCase cases[] = {
+    {"convolution", "3x3", 3, 1, 1, runConvolution},
+    {"convolution", "5x5", 5, 1, 1, runConvolution},
+    {"convolution", "7x7", 7, 1, 1, runConvolution},
+    // Large float masks: the FFT path when the cost model prefers it
+    {"convolution", "15x15", 15, 1, 1, runConvolution},
+    {"convolution", "31x31", 31, 1, 1, runConvolution},
+    // Negative arguments select an integral (Laplacian-like) mask of side -arg
+    {"convolution", "int3x3", -3, 1, 1, runConvolution},
+    {"convolution", "int5x5", -5, 1, 1, runConvolution},
+    {"convolution", "int7x7", -7, 1, 1, runConvolution},
+    {"convolution", "const3x3", 0, 1, 1, runConvolutionConstant},
+    {"median", "k=3", 3, 1, 1, runMedian},
+    {"median", "k=5", 5, 1, 1, runMedian},
+    {"median", "k=7", 7, 1, 1, runMedian},
+    {"median", "k=9", 9, 1, 1, runMedian},
+    {"median", "k=11", 11, 1, 1, runMedian},
+    {"median", "k=13", 13, 1, 1, runMedian},
+    {"median", "k=15", 15, 1, 1, runMedian},
+    {"median", "k=17", 17, 1, 1, runMedian},
+    {"median", "k=19", 19, 1, 1, runMedian},
+    {"median", "k=21", 21, 1, 1, runMedian},
+    {"blur", "3x3", 3, 1, 1, runBlur},
+    {"blur", "5x5", 5, 1, 1, runBlur},
+    {"histogram", "-", 0, 1, 0, runHistogram},
+    {"rotation", "cw", 0, 1, 1, runRotation},
+    {"noise_gaussian", "var=100", 0, 1, 1, runNoiseGaussian},
+    {"noise_saltpepper", "p=0.05", 0, 1, 1, runNoiseSaltPepper},
+    {"greyscale", "bgr24->8", 0, 3, 1, runGreyscale},
+};
+
+// Current monotonic time in seconds
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Time stamp counter, or 0 where none is available
+static uint64_t cycles(void) {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Best copy bandwidth in bytes per second (read + write traffic of memcpy)
+static double measurePeakBandwidth(void) {
+    unsigned char *a = malloc(BANDWIDTH_BYTES);
+    unsigned char *b = malloc(BANDWIDTH_BYTES);
+    if (!a || !b) {
+        free(a);
+        free(b);
+        return 0;
+    }
+    memset(a, 1, BANDWIDTH_BYTES);
+    memset(b, 2, BANDWIDTH_BYTES);
+
+    double best = 1e30;
+    for (int i = 0; i < 5; i++) {
+        double start = now();
+        memcpy((i & 1) ? a : b, (i & 1) ? b : a, BANDWIDTH_BYTES);
+        double elapsed = now() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    free(a);
+    free(b);
+    return 2.0 * BANDWIDTH_BYTES / best;
+}
+
+// Box mask of side arg (float coefficients), or for negative arg an integral
+// mask of side -arg: centre side*side-1, every other tap -1
+static mask* benchMask(int arg) {
+    int side = arg < 0 ? -arg : arg;
+    mask *m = maskCreate(side, side);
+    for (int i = 0; i < side * side; i++) {
+        if (arg > 0) {
+            m->data[i] = 1.0f / (side * side);
+        } else {
+            m->data[i] = i == side * side / 2 ? side * side - 1 : -1;
+        }
+    }
+    return m;
+}
+
+// Time one case: a warm-up run, then repetitions until minSeconds have passed
+// With counters, every event is counted over all timed repetitions
+static bool measure(const benchCase* c, benchContext* ctx, double minSeconds, perfCounters* counters, benchResult* result) {
+    static double times[MAX_REPETITIONS];
+    static double cycleCounts[MAX_REPETITIONS];
+
+    if (!c->run(ctx, c->arg)) {
+        return false;
+    }
+
+    int n = 0;
+    double total = 0;
+    if (counters) {
+        perfStart(counters);
+    }
+    while (n < MAX_REPETITIONS && (n == 0 || total < minSeconds)) {
+        uint64_t startCycles = cycles();
+        double start = now();
+        c->run(ctx, c->arg);
+        double elapsed = now() - start;
+        cycleCounts[n] = (double)(cycles() - startCycles);
+        times[n++] = elapsed;
+        total += elapsed;
+    }
+    if (counters) {
+        perfStop(counters);
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            result->counted[i] = counters->valid[i];
+            result->events[i] = counters->valid[i] ? (double)counters->value[i] / n : 0;
+        }
+    }
+
+    // Best run for cycles and bandwidth, median as a noise indicator
+    int best = 0;
+    for (int i = 1; i < n; i++) {
+        if (times[i] < times[best]) {
+            best = i;
+        }
+    }
+    result->repetitions = n;
+    result->bestSeconds = times[best];
+    result->cycles = cycleCounts[best];
+    qsort(times, n, sizeof(double), compareDoubles);
+    result->medianSeconds = times[n / 2];
+    return true;
+}
+
+// Parse "256,512,1024" into sizes (returns the count, -1 on error)
+static int parseSizes(const char* list, int* sizes) {
+    int count = 0;
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long value = strtol(p, &end, 10);
+        if (end == p || value < 8 || value > 65536 || count == MAX_SIZES) {
+            return -1;
+        }
+        sizes[count++] = (int)value;
+        p = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') {
+            return -1;
+        }
+    }
+    return count;
+}
+
+// True when the case matches the --ops filter (comma separated operator names)
+static bool selected(const char* filter, const char* name) {
+    if (!filter) {
+        return true;
+    }
+    size_t len = strlen(name);
+    for (const char *p = filter; p; p = strchr(p, ',')) {
+        if (*p == ',') {
+            p++;
+        }
+        if (strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Print "-" for an unavailable value, otherwise the value in the given width
+static void printOptional(FILE* out, bool available, double value, int width, int precision) {
+    if (available) {
+        fprintf(out, " %*.*f", width, precision, value);
+    } else {
+        fprintf(out, " %*s", width, "-");
+    }
+}
+
+// Table columns of the counters: instructions per cycle and misses per megapixel
+static void printCounters(FILE* out, const benchResult* r, double pixels) {
+    double megapixels = pixels / 1e6;
+    bool ipc = r->counted[PERF_CYCLES] && r->counted[PERF_INSTRUCTIONS] && r->events[PERF_CYCLES] > 0;
+    printOptional(out, ipc, ipc ? r->events[PERF_INSTRUCTIONS] / r->events[PERF_CYCLES] : 0, 6, 2);
+    printOptional(out, r->counted[PERF_CACHE_MISSES], r->events[PERF_CACHE_MISSES] / megapixels, 12, 0);
+    printOptional(out, r->counted[PERF_L1D_MISSES], r->events[PERF_L1D_MISSES] / megapixels, 12, 0);
+    printOptional(out, r->counted[PERF_BRANCH_MISSES], r->events[PERF_BRANCH_MISSES] / megapixels, 12, 0);
+}
+
+// JSON fields of the counters: every event per megapixel (null when unavailable) and IPC
+static void writeCounters(FILE* out, const benchResult* r, double pixels) {
+    double megapixels = pixels / 1e6;
+    fprintf(out, ", \"counters_per_megapixel\": {");
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        fprintf(out, "%s\"%s\": ", i ? ", " : "", perfCounterName(i));
+        if (r->counted[i]) {
+            fprintf(out, "%.1f", r->events[i] / megapixels);
+        } else {
+            fprintf(out, "null");
+        }
+    }
+    fprintf(out, "}, \"instructions_per_cycle\": ");
+    if (r->counted[PERF_CYCLES] && r->counted[PERF_INSTRUCTIONS] && r->events[PERF_CYCLES] > 0) {
+        fprintf(out, "%.3f", r->events[PERF_INSTRUCTIONS] / r->events[PERF_CYCLES]);
+    } else {
+        fprintf(out, "null");
+    }
+}
+
+// Write text as a quoted JSON string, escaping quotes, backslashes and control characters
+static void writeString(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(out, "\\u%04x", *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--sizes 256,512,...] [--ops name,...] [--min-time s] [--max-time s]\n"
+            "          [--json file|-] [--label text] [--perf]\n"
+            "Times every operator on synthetic square images and reports MP/s, TSC cycles\n"
+            "per pixel and memory bandwidth relative to a measured memcpy peak.\n"
+            "Cases whose extrapolated single run exceeds --max-time are skipped.\n"
+            "--perf adds perf_event_open counters (cycles, instructions, cache and\n"
+            "branch misses, page faults) per megapixel; counters the machine does not\n"
+            "provide are reported as unavailable.\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    int sizes[MAX_SIZES] = {256, 512, 1024, 2048, 4096, 8192};
+    int sizeCount = 6;
+    const char *opsFilter = NULL;
+    const char *jsonFile = NULL;
+    const char *label = "";
+    double minSeconds = 0.2;
+    double maxSeconds = 10.0;
+    bool usePerf = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--sizes") == 0 && hasValue) {
+            sizeCount = parseSizes(argv[++i], sizes);
+            if (sizeCount <= 0) {
+                fprintf(stderr, "Invalid size list.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--ops") == 0 && hasValue) {
+            opsFilter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && hasValue) {
+            minSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-time") == 0 && hasValue) {
+            maxSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonFile = argv[++i];
+        } else if (strcmp(argv[i], "--label") == 0 && hasValue) {
+            label = argv[++i];
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            usePerf = true;
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    FILE *json = NULL;
+    if (jsonFile) {
+        json = strcmp(jsonFile, "-") == 0 ? stdout : fopen(jsonFile, "w");
+        if (!json) {
+            fprintf(stderr, "Unable to create file %s!\n", jsonFile);
+            return 1;
+        }
+    }
+    // With JSON on stdout the human-readable table goes to stderr
+    FILE *table = json == stdout ? stderr : stdout;
+
+    perfCounters counters;
+    if (usePerf) {
+        int opened = perfOpen(&counters);
+        fprintf(table, "Performance counters: %d of %d available\n", opened, PERF_COUNTER_COUNT);
+        if (opened == 0) {
+            usePerf = false;
+        }
+    }
+
+    double peak = measurePeakBandwidth();
+    fprintf(table, "Peak copy bandwidth: %.2f GB/s\n", peak / 1e9);
+    fprintf(table, "%-18s %-9s %6s %6s %10s %10s %9s %6s",
+            "operator", "param", "size", "reps", "best [ms]", "MP/s", "cyc/px", "BW %");
+    if (usePerf) {
+        fprintf(table, " %6s %12s %12s %12s", "IPC", "LLCmiss/MP", "L1Dmiss/MP", "brmiss/MP");
+    }
+    fprintf(table, "\n");
+
+    if (json) {
+        char timestamp[32];
+        time_t t = time(NULL);
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+        fprintf(json, "{\n  \"benchmark\": \"operators\",\n  \"label\": ");
+        writeString(json, label);
+        fprintf(json, ",\n  \"timestamp\": \"%s\",\n  \"compiler\": ", timestamp);
+        writeString(json, __VERSION__);
+        fprintf(json, ",\n  \"cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+        fprintf(json, "  \"cycle_counter\": \"%s\",\n", cycles() ? "tsc" : "none");
+        fprintf(json, "  \"perf_counters\": %s,\n", usePerf ? "true" : "false");
+        fprintf(json, "  \"peak_bandwidth_bytes_per_second\": %.0f,\n  \"results\": [", peak);
+    }
+
+    int caseCount = sizeof(cases) / sizeof(cases[0]);
+    // Best time of every case at the previous size, used to skip hopeless runs
+    double *previous = calloc(caseCount, sizeof(double));
+    int previousSize = 0;
+    bool first = true;
+
+    for (int s = 0; s < sizeCount; s++) {
+        int size = sizes[s];
+        benchContext ctx;
+        ctx.src = BMP8CreateSynthetic(size, size);
+        ctx.dst = BMP8CreateSynthetic(size, size);
+        ctx.color = BMP24CreateSynthetic(size, size);
+        ctx.m = NULL;
+        if (!ctx.src || !ctx.dst || !ctx.color) {
+            fprintf(stderr, "Skipping %dx%d: not enough memory.\n", size, size);
+            BMP8Free(ctx.src);
+            BMP8Free(ctx.dst);
+            BMP24Free(ctx.color);
+            continue;
+        }
+        double pixels = (double)size * size;
+
+        for (int i = 0; i < caseCount; i++) {
+            const benchCase *c = &cases[i];
+            if (!selected(opsFilter, c->name)) {
+                continue;
+            }
+
+            // Operators are at least linear in the pixel count
+            double estimate = previous[i] * pixels / ((double)previousSize * previousSize + 1);
+            bool skip = previous[i] < 0 || estimate > maxSeconds;
+
+            benchResult r = {0};
+            bool ok = false;
+            if (!skip) {
+                ctx.m = c->run == runConvolution ? benchMask(c->arg) : NULL;
+                ok = measure(c, &ctx, minSeconds, usePerf ? &counters : NULL, &r);
+                maskFree(ctx.m);
+                ctx.m = NULL;
+            }
+            // A skipped case stays skipped at larger sizes
+            previous[i] = ok ? r.bestSeconds : -1;
+
+            if (json) {
+                fprintf(json, "%s\n    {\"operator\": \"%s\", \"param\": \"%s\", \"width\": %d, \"height\": %d",
+                        first ? "" : ",", c->name, c->param, size, size);
+                first = false;
+            }
+            if (!ok) {
+                fprintf(table, "%-18s %-9s %6d %6s %10s\n", c->name, c->param, size, "-", "skipped");
+                if (json) {
+                    fprintf(json, ", \"skipped\": \"%s\"}", skip ? "time budget" : "failed");
+                }
+                continue;
+            }
+
+            double mps = pixels / r.bestSeconds / 1e6;
+            double cyclesPerPixel = r.cycles / pixels;
+            double bandwidth = pixels * (c->readBytes + c->writeBytes) / r.bestSeconds;
+            double utilization = peak > 0 ? bandwidth / peak : 0;
+            fprintf(table, "%-18s %-9s %6d %6d %10.3f %10.1f %9.2f %6.1f",
+                    c->name, c->param, size, r.repetitions, r.bestSeconds * 1e3,
+                    mps, cyclesPerPixel, utilization * 100);
+            if (usePerf) {
+                printCounters(table, &r, pixels);
+            }
+            fprintf(table, "\n");
+            if (json) {
+                fprintf(json, ", \"repetitions\": %d, \"best_seconds\": %.9f, \"median_seconds\": %.9f, "
+                              "\"megapixels_per_second\": %.3f, \"cycles_per_pixel\": %.3f, "
+                              "\"bytes_per_second\": %.0f, \"bandwidth_utilization\": %.4f",
+                        r.repetitions, r.bestSeconds, r.medianSeconds, mps, cyclesPerPixel, bandwidth, utilization);
+                if (usePerf) {
+                    writeCounters(json, &r, pixels);
+                }
+                fprintf(json, "}");
+            }
+        }
+
+        previousSize = size;
+        BMP8Free(ctx.src);
+        BMP8Free(ctx.dst);
+        BMP24Free(ctx.color);
+    }
+
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        if (json != stdout) {
+            fclose(json);
+        }
+    }
+    free(previous);
+    if (usePerf) {
+        perfClose(&counters);
+    }
+    return 0;
+}
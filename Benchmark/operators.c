@@ -0,0 +1,907 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "operators.h"
+#include "kernels.h"
+#include "fft.h"
+
+// Operators benchmarked by this module are copies of the Into variants of
+// their modules; keep them in sync when a module's operator changes
+
+// Maximum value of a pixel
+#define MAX_BRIGHTNESS 255
+// Minimum value of a pixel
+#define MIN_BRIGHTNESS 0
+
+// Macro definitions for minimum and maximum values
+#define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
+#define MAX(a, b) ((a) > (b) ? (a) : (b))   // returns the larger of (a) and (b)
+
+BMP8Image* BMP8CreateSynthetic(int width, int height) {
+    BMP8Image *img = malloc(sizeof(BMP8Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    int rowSize = (width + 3) & ~3;
+    img->width = width;
+    img->height = height;
+    img->bitDepth = 8;
+    img->imgSize = rowSize * height;
+    img->data = malloc(img->imgSize);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(img);
+        return NULL;
+    }
+
+    // Header as written by RGBtoGreyScale, grey color table
+    memset(img->header, 0, BMP_HEADER_SIZE);
+    img->header[0] = 'B';
+    img->header[1] = 'M';
+    *(int*)&img->header[2] = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + img->imgSize;
+    *(int*)&img->header[10] = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE;
+    *(int*)&img->header[14] = 40;
+    *(int*)&img->header[18] = width;
+    *(int*)&img->header[22] = height;
+    *(short*)&img->header[26] = 1;
+    *(short*)&img->header[28] = 8;
+    *(int*)&img->header[34] = img->imgSize;
+    for (int i = 0; i < 256; i++) {
+        img->colorTable[i*4 + 0] = i;
+        img->colorTable[i*4 + 1] = i;
+        img->colorTable[i*4 + 2] = i;
+        img->colorTable[i*4 + 3] = 0;
+    }
+
+    // Smooth gradient with some texture, so sorting and branching behave as on photos
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < rowSize; x++) {
+            img->data[y * rowSize + x] = (unsigned char)((x + y) / 4 + ((x * 7 + y * 13) & 31));
+        }
+    }
+    return img;
+}
+
+BMP24Image* BMP24CreateSynthetic(int width, int height) {
+    BMP24Image *img = malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    img->width = width;
+    img->height = height;
+    img->bitDepth = 24;
+    img->rowSize = (width * 3 + 3) & (~3);
+    size_t size = (size_t)img->rowSize * height;
+    img->data = malloc(size);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(img);
+        return NULL;
+    }
+
+    memset(img->header, 0, BMP_HEADER_SIZE);
+    img->header[0] = 'B';
+    img->header[1] = 'M';
+    *(int*)&img->header[2] = BMP_HEADER_SIZE + (int)size;
+    *(int*)&img->header[10] = BMP_HEADER_SIZE;
+    *(int*)&img->header[14] = 40;
+    *(int*)&img->header[18] = width;
+    *(int*)&img->header[22] = height;
+    *(short*)&img->header[26] = 1;
+    *(short*)&img->header[28] = 24;
+    *(int*)&img->header[34] = (int)size;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < img->rowSize; x++) {
+            img->data[(size_t)y * img->rowSize + x] = (unsigned char)((x + 3 * y) / 8 + ((x * 5 + y * 11) & 63));
+        }
+    }
+    return img;
+}
+
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// ---- Common ----
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// ---- Convolution ----
+
+// Copy the coefficients of m into taps when all of them are whole numbers
+// Returns the sum of their magnitudes, or -1 when the mask needs the float path
+// (fractional coefficients, or sums too large to stay exact in float)
+static int maskIntegerTaps(mask* m, int* taps){
+    int absSum = 0;
+    for(unsigned int i = 0; i < m->rows * m->cols; i++){
+        float c = m->data[i];
+        if(c > 65535.0f || c < -65535.0f || c != (float)(int)c){
+            return -1;
+        }
+        taps[i] = (int)c;
+        absSum += abs(taps[i]);
+        // Float accumulation is exact below 2^24
+        if((long)absSum * MAX_BRIGHTNESS >= (1L << 24)){
+            return -1;
+        }
+    }
+    return absSum;
+}
+
+// Integer convolution of one pixel; taps outside the image are skipped (zero padding)
+static unsigned char convolveIntegerPixel(BMP8Image* img, int rowSize, const int* taps, int rows, int cols, int x, int y){
+    int val = 0;
+    for(int i = 0; i < rows; i++){
+        int idy = y + (i - rows / 2);
+        if(idy < 0 || idy >= img->height){
+            continue;
+        }
+        for(int j = 0; j < cols; j++){
+            int idx = x + (j - cols / 2);
+            if(idx >= 0 && idx < img->width){
+                val += taps[i * cols + j] * img->data[idy * rowSize + idx];
+            }
+        }
+    }
+    return (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+}
+
+// Convolution with integer taps, pixel for pixel equal to the float path
+// Where the whole mask is inside the image, sums use 16-bit lanes with a saturating
+// pack when they fit (absSum * 255 <= 32767) and 32-bit scalar accumulation otherwise
+// row, when given, is an unrolled kernel for this mask size or these coefficients
+static void BMP8ConvolutionInteger(BMP8Image* img, const int* taps, int rows, int cols, int absSum, kernelRow row, BMP8Image* dst){
+    int rowSize = (img->width + 3) & ~3;
+    int iCenter = rows / 2;
+    int jCenter = cols / 2;
+
+    // Rows and columns where every tap lies inside the image
+    int yBegin = iCenter, yEnd = img->height - (rows - 1 - iCenter);
+    int xBegin = jCenter, xEnd = img->width - (cols - 1 - jCenter);
+
+    for(int y = 0; y < img->height; y++){
+        unsigned char* out = dst->data + (size_t)y * rowSize;
+        if(y < yBegin || y >= yEnd || xBegin >= xEnd){
+            for(int x = 0; x < img->width; x++){
+                out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+            }
+            continue;
+        }
+
+        for(int x = 0; x < xBegin; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+        int x = xBegin;
+        if(row){
+            row(img->data + (size_t)(y - iCenter) * rowSize, rowSize, x, xEnd, out, taps, absSum * MAX_BRIGHTNESS <= 32767);
+            x = xEnd;
+        }
+#ifdef __SSE2__
+        // Vector path: 8 pixels per iteration, twice the lanes of a float kernel
+        if(absSum * MAX_BRIGHTNESS <= 32767){
+            const __m128i zero = _mm_setzero_si128();
+            for(; x + 8 <= xEnd; x += 8){
+                __m128i acc = zero;
+                for(int i = 0; i < rows; i++){
+                    const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                    for(int j = 0; j < cols; j++){
+                        int c = taps[i * cols + j];
+                        if(c != 0){
+                            __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + j)), zero);
+                            acc = _mm_add_epi16(acc, _mm_mullo_epi16(px, _mm_set1_epi16((short)c)));
+                        }
+                    }
+                }
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(acc, acc));
+            }
+        }
+#endif
+        // Scalar path (and tail): no bounds checks inside the image
+        for(; x < xEnd; x++){
+            int val = 0;
+            for(int i = 0; i < rows; i++){
+                const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                for(int j = 0; j < cols; j++){
+                    val += taps[i * cols + j] * src[j];
+                }
+            }
+            out[x] = (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+        }
+        for(; x < img->width; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+    }
+}
+
+// Function to apply convolution with a given mask, writing into a caller-supplied image
+// Current monotonic time in seconds
+static double secondsNow(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Direct convolution in float: every output pixel sums rows * cols products
+static void BMP8ConvolutionDirect(BMP8Image* img, mask* m, BMP8Image* dst){
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
+    // Compute center of the mask (for correct alignment during convolution)
+    int iCenter = m->rows / 2;
+    int jCenter = m->cols / 2;
+
+    // Iterate through every pixel in the image
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
+            float val = 0.0f;
+
+            // Apply convolution mask
+            for(int i = 0; i < (int)m->rows; i++){
+                for(int j = 0; j < (int)m->cols; j++){
+                    int idx = x + (j - jCenter);  // pixel x offset
+                    int idy = y + (i - iCenter);  // pixel y offset
+
+                    // Check if neighbor is inside image bounds
+                    if(idx >= 0 && idx < img->width && idy >= 0 && idy < img->height){
+                        float ms = m->data[i * m->cols + j];       // mask coefficient
+                        float im = img->data[idy * rowSize + idx]; // image pixel value
+                        val += ms * im;
+                    }
+                }
+            }
+
+            // Clamp to valid grayscale range [0..255]
+            val = MIN(val, MAX_BRIGHTNESS);
+            val = MAX(val, MIN_BRIGHTNESS);
+
+            // Store result pixel
+            dst->data[y * rowSize + x] = (unsigned char)val;
+        }
+    }
+}
+
+// Pick FFT tile sizes (powers of two) with the least transform work for the whole
+// image; returns that work in units of n*log2(n) for one transform of n points
+static double fftConvolutionWork(int width, int height, int rows, int cols, int* fftRows, int* fftCols){
+    double best = -1.0;
+    for(int nr = fftNextPowerOfTwo(rows); nr <= fftNextPowerOfTwo(height + rows - 1); nr *= 2){
+        for(int nc = fftNextPowerOfTwo(cols); nc <= fftNextPowerOfTwo(width + cols - 1); nc *= 2){
+            // Every tile yields (n - mask + 1) new output rows/columns
+            long tiles = (long)((height + nr - rows) / (nr - rows + 1)) * ((width + nc - cols) / (nc - cols + 1));
+            // Tiles are transformed in pairs, each pair forward and back
+            double work = (tiles + 1) / 2 * 2.0 * nr * nc * log2((double)nr * nc);
+            if(best < 0 || work < best){
+                best = work;
+                *fftRows = nr;
+                *fftCols = nc;
+            }
+        }
+    }
+    return best;
+}
+
+// Convolution through the FFT with overlap-add tiling; two real tiles share one
+// complex transform, one in the real and one in the imaginary part
+// Matches the direct float path up to rounding: pixels may differ by 1
+static bool BMP8ConvolutionFFT(BMP8Image* img, mask* m, BMP8Image* dst){
+    int rows = m->rows, cols = m->cols;
+    int nr = 0, nc = 0;
+    fftConvolutionWork(img->width, img->height, rows, cols, &nr, &nc);
+    int tileH = nr - rows + 1, tileW = nc - cols + 1;
+    int tilesX = (img->width + tileW - 1) / tileW;
+    int tiles = ((img->height + tileH - 1) / tileH) * tilesX;
+    int accW = img->width + cols - 1, accH = img->height + rows - 1;
+    int rowSize = (img->width + 3) & ~3;
+    size_t n = (size_t)nr * nc;
+
+    complexf* kernel = calloc(n, sizeof(complexf));
+    complexf* work = malloc(n * sizeof(complexf));
+    float* acc = calloc((size_t)accW * accH, sizeof(float));
+    bool ok = kernel && work && acc;
+
+    // Spectrum of the flipped mask: the direct path correlates rather than convolves
+    if(ok){
+        for(int i = 0; i < rows; i++){
+            for(int j = 0; j < cols; j++){
+                kernel[(size_t)(rows - 1 - i) * nc + (cols - 1 - j)].re = m->data[i * cols + j];
+            }
+        }
+        ok = fft2D(kernel, nr, nc, false);
+    }
+
+    for(int t = 0; ok && t < tiles; t += 2){
+        memset(work, 0, n * sizeof(complexf));
+        for(int k = 0; k < 2 && t + k < tiles; k++){
+            int y0 = (t + k) / tilesX * tileH, x0 = (t + k) % tilesX * tileW;
+            int h = MIN(tileH, img->height - y0), w = MIN(tileW, img->width - x0);
+            for(int y = 0; y < h; y++){
+                for(int x = 0; x < w; x++){
+                    float v = img->data[(y0 + y) * rowSize + x0 + x];
+                    if(k == 0){
+                        work[(size_t)y * nc + x].re = v;
+                    } else {
+                        work[(size_t)y * nc + x].im = v;
+                    }
+                }
+            }
+        }
+
+        ok = fft2D(work, nr, nc, false);
+        for(size_t i = 0; ok && i < n; i++){
+            complexf a = work[i], b = kernel[i];
+            work[i].re = a.re * b.re - a.im * b.im;
+            work[i].im = a.re * b.im + a.im * b.re;
+        }
+        ok = ok && fft2D(work, nr, nc, true);
+
+        // Overlap-add both full convolutions (tile + mask - 1 in each direction)
+        for(int k = 0; ok && k < 2 && t + k < tiles; k++){
+            int y0 = (t + k) / tilesX * tileH, x0 = (t + k) % tilesX * tileW;
+            int h = MIN(tileH, img->height - y0) + rows - 1, w = MIN(tileW, img->width - x0) + cols - 1;
+            for(int y = 0; y < h; y++){
+                float* row = acc + (size_t)(y0 + y) * accW + x0;
+                for(int x = 0; x < w; x++){
+                    row[x] += k == 0 ? work[(size_t)y * nc + x].re : work[(size_t)y * nc + x].im;
+                }
+            }
+        }
+    }
+
+    // Output (x, y) is element (x + cols - 1 - jCenter, y + rows - 1 - iCenter) of the full convolution
+    if(ok){
+        int yOffset = rows - 1 - rows / 2, xOffset = cols - 1 - cols / 2;
+        for(int y = 0; y < img->height; y++){
+            for(int x = 0; x < img->width; x++){
+                float val = acc[(size_t)(y + yOffset) * accW + x + xOffset];
+                val = MIN(val, MAX_BRIGHTNESS);
+                val = MAX(val, MIN_BRIGHTNESS);
+                dst->data[y * rowSize + x] = (unsigned char)val;
+            }
+        }
+    }
+
+    free(kernel);
+    free(work);
+    free(acc);
+    return ok;
+}
+
+// Measured seconds per direct multiply-add and per unit of FFT work
+static double directCost = 0.0;
+static double fftCost = 0.0;
+static pthread_once_t calibrateOnce = PTHREAD_ONCE_INIT;
+
+// Time both paths once on a small synthetic image (best of three runs each)
+static void calibrateConvolution(void){
+    const int side = 128, taps = 9;
+    BMP8Image probe = {0}, out = {0};
+    probe.width = probe.height = out.width = out.height = side;
+    probe.imgSize = out.imgSize = side * side;
+    probe.data = malloc(side * side);
+    out.data = malloc(side * side);
+    complexf* buffer = calloc(side * side, sizeof(complexf));
+    mask* m = maskCreate(taps, taps);
+    if(!probe.data || !out.data || !buffer || !m || !m->data){
+        // Without a measurement the FFT path is never chosen
+        directCost = 0.0;
+        fftCost = 1.0;
+    } else {
+        for(int i = 0; i < side * side; i++){
+            probe.data[i] = (unsigned char)(i * 7 + i / side * 13);
+        }
+        for(int i = 0; i < taps * taps; i++){
+            m->data[i] = 1.0f / (taps * taps);
+        }
+        double bestDirect = 1e30, bestFFT = 1e30;
+        for(int run = 0; run < 3; run++){
+            double start = secondsNow();
+            BMP8ConvolutionDirect(&probe, m, &out);
+            bestDirect = MIN(bestDirect, secondsNow() - start);
+            start = secondsNow();
+            fft2D(buffer, side, side, false);
+            fft2D(buffer, side, side, true);
+            bestFFT = MIN(bestFFT, secondsNow() - start);
+        }
+        directCost = bestDirect / ((double)side * side * taps * taps);
+        fftCost = bestFFT / (2.0 * side * side * log2((double)side * side));
+    }
+    free(probe.data);
+    free(out.data);
+    free(buffer);
+    maskFree(m);
+}
+
+// True when the FFT path is predicted to beat the direct one for this image and mask
+static bool convolutionPrefersFFT(BMP8Image* img, mask* m){
+    // Small masks never pay for the transforms
+    if(m->rows * m->cols < 49){
+        return false;
+    }
+    pthread_once(&calibrateOnce, calibrateConvolution);
+    int nr, nc;
+    double fft = fftConvolutionWork(img->width, img->height, m->rows, m->cols, &nr, &nc) * fftCost;
+    double direct = (double)img->width * img->height * m->rows * m->cols * directCost;
+    return fft < direct;
+}
+
+// dst must have the size of img and must not alias it (neighbors are read after writes)
+bool BMP8ConvolutionInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    // Integral masks (Sobel, Prewitt, Kirsch, Laplacian, ...) take the exact integer path
+    int* taps = malloc(m->rows * m->cols * sizeof(int));
+    int absSum = taps ? maskIntegerTaps(m, taps) : -1;
+    if(absSum >= 0){
+        BMP8ConvolutionInteger(img, taps, m->rows, m->cols, absSum, kernelRowFor(m->rows, m->cols), dst);
+        free(taps);
+        return true;
+    }
+    free(taps);
+
+    // Large fractional masks go through the FFT when the measured cost model favours it
+    if(convolutionPrefersFFT(img, m) && BMP8ConvolutionFFT(img, m, dst)){
+        return true;
+    }
+    BMP8ConvolutionDirect(img, m, dst);
+
+    return true;
+}
+
+// Convolution through the FFT regardless of the mask, writing into a caller-supplied image
+// Pixels may differ by 1 from the direct path; dst must not alias img
+bool BMP8ConvolutionFFTInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+    if(!BMP8ConvolutionFFT(img, m, dst)){
+        fprintf(stderr, "Convolution Error: Memory allocation failed!\n");
+        return false;
+    }
+    return true;
+}
+
+// Apply an integer mask fixed at compile time (see CONSTANT_KERNEL), writing into a
+// caller-supplied image; same result as BMP8ConvolutionInto with the equivalent mask
+bool BMP8ConvolutionKernelInto(BMP8Image* img, const constantKernel* k, BMP8Image* dst){
+    if(!img || !k){
+        fprintf(stderr, "Convolution Error: Either there is no image or kernel.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    int absSum = 0;
+    for(int i = 0; i < k->rows * k->cols; i++){
+        absSum += abs(k->taps[i]);
+    }
+    BMP8ConvolutionInteger(img, k->taps, k->rows, k->cols, absSum, k->row, dst);
+    return true;
+}
+
+// Same coefficients as the int3x3 case, fixed at compile time like the edge detectors' masks
+CONSTANT_KERNEL(benchConstant3x3, 3, 3,
+    -1, -1, -1,
+    -1,  8, -1,
+    -1, -1, -1)
+
+bool BMP8ConvolutionConstant3x3Into(BMP8Image* img, BMP8Image* dst){
+    return BMP8ConvolutionKernelInto(img, &benchConstant3x3, dst);
+}
+
+// ---- FilterMedian ----
+
+// Median filter writing into a caller-supplied image
+// dst must have the size of img and must not alias it; border pixels are copied unchanged
+bool BMP8FilterMedianInto(BMP8Image* img, int kernelSize, BMP8Image* dst){
+    if (!BMP8CheckDestination(img, dst)) {
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Filter Error: In-place median filtering is not supported.\n");
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
+    // Copy original image data
+    memcpy(dst->data, img->data, img->imgSize);
+
+    // The window spans -kernelSize/2..kernelSize/2, so even sizes round up
+    int windowSide = 2 * (kernelSize / 2) + 1;
+    int windowSize = windowSide * windowSide;
+    unsigned char* window = malloc(windowSize);
+    if (!window) {
+        fprintf(stderr, "Filter Error: Memory allocation failed for window!\n");
+        return false;
+    }
+
+    // Apply median filter
+    for(int j = kernelSize/2; j < (img->height - kernelSize/2); j++){
+        for(int i = kernelSize/2; i < (img->width - kernelSize/2); i++){
+            int count = 0;
+
+            // Collect values in the neighborhood
+            for (int y = -kernelSize/2; y <= kernelSize/2; y++) {
+                for (int x = -kernelSize/2; x <= kernelSize/2; x++) {
+                    window[count++] = img->data[(j + y) * rowSize + (i + x)];
+                }
+            }
+            // Sort values
+            for (int m = 0; m < count - 1; m++) {
+                for (int n = 0; n < count - m - 1; n++) {
+                    if (window[n] > window[n + 1]) {
+                        unsigned char tmp = window[n];
+                        window[n] = window[n + 1];
+                        window[n + 1] = tmp;
+                    }
+                }
+            }
+            // Pick the median value
+            unsigned char median = window[count / 2];
+            dst->data[j * rowSize + i] = median;
+        }
+    }
+
+    free(window);
+    return true;
+}
+
+// ---- Blur ----
+
+// Function to blur image using averaging filter, writing into a caller-supplied image
+// dst must have the size of img and must not alias it; border pixels are copied unchanged
+bool BMP8BlurInto(BMP8Image* img, unsigned int size, BMP8Image* dst) {
+    if (!img) {
+        fprintf(stderr, "Blur Error: No image provided.\n");
+        return false;
+    }
+    if (!BMP8CheckDestination(img, dst)) {
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Blur Error: In-place blur is not supported.\n");
+        return false;
+    }
+
+    // Compute padded row size (each row aligned to 4 bytes)
+    int rowSize = (img->width + 3) & ~3;
+
+    // Copy original image data to blurred image (so border pixels remain unchanged)
+    memcpy(dst->data, img->data, img->imgSize);
+
+    // Create averaging kernel of size (size × size)
+    float* kernel = malloc(size * size * sizeof(float));
+    if (!kernel) {
+        fprintf(stderr, "Memory allocation failed for kernel!\n");
+        return false;
+    }
+
+    // Fill kernel with equal weights
+    float value = 1.0f / (size * size);
+    for (unsigned int i = 0; i < size * size; i++) {
+        kernel[i] = value;
+    }
+
+    // Convolution offset (half of kernel size)
+    int offset = size / 2;
+
+    // Apply convolution (ignoring border pixels)
+    for (int y = offset; y < img->height - offset; y++) {
+        for (int x = offset; x < img->width - offset; x++) {
+            float sum = 0.0f;
+
+            for (int j = -offset; j <= offset; j++) {
+                for (int i = -offset; i <= offset; i++) {
+                    int pixelVal = img->data[(y + j) * rowSize + (x + i)];
+                    float weight = kernel[(j + offset) * size + (i + offset)];
+                    sum += weight * pixelVal;
+                }
+            }
+
+            // Clamp result to valid grayscale range [0, 255]
+            if (sum < 0) sum = 0;
+            if (sum > 255) sum = 255;
+
+            dst->data[y * rowSize + x] = (unsigned char)sum;
+        }
+    }
+
+    // Free kernel memory
+    free(kernel);
+
+    return true;
+}
+
+// ---- ImageRotation ----
+
+// Compute the size of an image after rotation
+static bool rotatedSize(BMP8Image* img, rotation r, int* newWidth, int* newHeight) {
+    // Determine new image dimensions based on rotation type
+    switch (r) {
+        case CLOCKWISE:
+        case COUNTER_CLOCKWISE:
+            // Width becomes original height
+            *newWidth = img->height;
+            // Height becomes original width
+            *newHeight = img->width;
+            return true;
+        case ROTATE_180:
+            // Width and height stay the same
+            *newWidth = img->width;
+            *newHeight = img->height;
+            return true;
+        default:
+            fprintf(stderr, "Unknown rotation type %d.\n", r);
+            return false;
+    }
+}
+
+// Rotate an image, writing into a caller-supplied image of the rotated size
+// dst must not alias img (pixels move to other rows and columns)
+bool BMP8RotateInto(BMP8Image* img, rotation r, BMP8Image* dst) {
+    if (!img || !dst || !dst->data) {
+        fprintf(stderr, "Image does not exists.\n");
+        return false;
+    }
+
+    int newWidth, newHeight;
+    if (!rotatedSize(img, r, &newWidth, &newHeight)) {
+        return false;
+    }
+    if (dst->width != newWidth || dst->height != newHeight) {
+        fprintf(stderr, "Destination size does not match the rotated image.\n");
+        return false;
+    }
+    if (dst->data == img->data) {
+        fprintf(stderr, "In-place rotation is not supported.\n");
+        return false;
+    }
+
+    // Copy header, bit depth and color table, then update width and height fields
+    memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+    *(int*)&dst->header[18] = newWidth;
+    *(int*)&dst->header[22] = newHeight;
+    dst->bitDepth = img->bitDepth;
+    if (img->bitDepth <= 8) {
+        memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    }
+
+    // Calculate padded row sizes
+    // Input row aligned to 4 bytes
+    int rowSizeIn = (img->width + 3) & ~3;
+    // Output row aligned to 4 bytes
+    int rowSizeOut = (newWidth + 3) & ~3;
+
+    // Pointer to original pixels
+    unsigned char* inData = img->data;
+    // Pointer to rotated pixels
+    unsigned char* outData = dst->data;
+
+    // Loop through all pixels of the original image
+    for (int y = 0; y < img->height; y++) {
+        for (int x = 0; x < img->width; x++) {
+            // Read pixel
+            unsigned char pixel = inData[y * rowSizeIn + x];
+
+            // Write pixel to new location based on rotation type
+            switch (r) {
+                case CLOCKWISE:
+                    outData[x * rowSizeOut + (newWidth - y - 1)] = pixel;
+                    break;
+                case COUNTER_CLOCKWISE:
+                    outData[(newHeight - x - 1) * rowSizeOut + y] = pixel;
+                    break;
+                case ROTATE_180:
+                    outData[(newHeight - y - 1) * rowSizeOut + (newWidth - x - 1)] = pixel;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return true;
+}
+
+// ---- NoiseGaussian ----
+
+// Add Gaussian noise to an image, writing into a caller-supplied image
+// dst may alias img (every pixel only depends on itself)
+bool BMP8NoiseGaussianInto(BMP8Image* img, float mean, float var, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Noise Error: Image does not exists.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
+    // Iterate through every pixel
+    for(int j = 0; j < img->height; j++){
+        for(int i = 0; i < img->width; i++){
+            // Generate two uniform random numbers in (0,1]
+            float u1 = ((float)rand() + 1) / ((float)RAND_MAX + 1);
+            float u2 = ((float)rand() + 1) / ((float)RAND_MAX + 1);
+
+            // Box-Muller transform to get standard normal variable
+            float z0 = sqrt(-2.0f * log(u1)) * cos(2.0f * M_PI * u2);
+
+            // Scale by variance and shift by mean
+            float noise = mean + sqrt(var) * z0;
+
+            // Add noise to the original pixel
+            float px = (float)img->data[j * rowSize + i] + noise;
+
+            // Clamp to valid range [0, 255]
+            px = MAX(MIN_BRIGHTNESS, px);
+            px = MIN(MAX_BRIGHTNESS, px);
+
+            // Store the result
+            dst->data[j * rowSize + i] = (unsigned char)px;
+        }
+    }
+
+    return true;
+}
+
+// ---- NoiseSaltPepper ----
+
+// Add salt and pepper noise to an image, writing into a caller-supplied image
+// dst may alias img (every pixel only depends on itself)
+bool BMP8NoiseSaltPepperInto(BMP8Image* img, float prob, BMP8Image* dst){
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
+    for(int j = 0; j < img->height; j++){
+        for(int i = 0; i < img->width; i++){
+            float r = (float)rand() / RAND_MAX;
+            if(r < prob / 2.0f){
+                dst->data[j * rowSize + i] = 0;
+            } else if(r > 1.0f - prob / 2.0f){
+                dst->data[j * rowSize + i] = 255;
+            } else {
+                dst->data[j * rowSize + i] = img->data[j * rowSize + i];
+            }
+        }
+    }
+
+    return true;
+}
+
+
+// ---- Histogram ----
+
+// Normalized histogram of BMP8Histogram, without writing the text file
+bool BMP8HistogramInto(BMP8Image* img, float* hist){
+    if(!img || !hist){
+        fprintf(stderr, "Histogram Error: Either there is no image or histogram.\n");
+        return false;
+    }
+
+    // Array to count pixel occurrences
+    long int ihist[256];
+    for(int i = 0; i < 256; i++){
+        ihist[i] = 0;
+    }
+
+    // Compute row size (padded to 4 bytes)
+    int rowSize = (img->width + 3) & ~3;
+
+    // Loop through all pixels and count occurrences of each intensity
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
+            unsigned char pixel = img->data[y * rowSize + x];
+            ihist[pixel]++;
+        }
+    }
+
+    // Normalize histogram (divide counts by total number of pixels)
+    long int sum = img->width * img->height;
+    for(int i = 0; i < 256; i++){
+        hist[i] = (float)ihist[i] / (float)sum;
+    }
+    return true;
+}
+
+// ---- RGBtoGreyScale ----
+
+// Convert RGB color to grayscale
+static unsigned char rgbToGray(unsigned char r, unsigned char g, unsigned char b) {
+    return (unsigned char)(0.3*r + 0.59*g + 0.11*b);
+}
+
+// Pixel loop of BMP24ConvertTo8, writing into a caller-supplied 8-bit image
+bool BMP24ConvertTo8Into(BMP24Image* img24, BMP8Image* dst) {
+    if (!img24 || !dst || !dst->data || dst->width != img24->width || dst->height != img24->height) {
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Row size with padding
+    int rowSize = (dst->width + 3) & (~3);
+
+    // Convert each pixel from 24-bit to 8-bit grayscale
+    for(int y = 0; y < dst->height; y++) {
+        unsigned char* row24 = img24->data + y * img24->rowSize;
+        unsigned char* row8 = dst->data + y * rowSize;
+
+        for(int x = 0; x < dst->width; x++) {
+            unsigned char* pixel24 = row24 + x*3;
+            row8[x] = rgbToGray(pixel24[2], pixel24[1], pixel24[0]);
+        }
+    }
+    return true;
+}
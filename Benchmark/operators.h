@@ -0,0 +1,81 @@
+#ifndef OPERATORS_H
+#define OPERATORS_H
+
+#include <stdbool.h>
+#include "mask.h"
+
+// Define BMP header size
+#define BMP_HEADER_SIZE 54
+// Size of color table for 8-bit BMP
+#define BMP_COLOR_TABLE_SIZE 1024
+
+/**
+ * @brief 8-bit BMP image, same layout as in every operator module.
+ */
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE];          /// BMP file header (54 bytes)
+    unsigned char colorTable[BMP_COLOR_TABLE_SIZE]; /// Color table for 8-bit BMP (256 * 4 bytes)
+    unsigned char *data;                            /// Pointer to pixel data
+    int width;                                      /// Image width in pixels
+    int height;                                     /// Image height in pixels
+    int bitDepth;                                   /// Bits per pixel (8 for grayscale)
+    int imgSize;                                    /// Total size of pixel data in bytes
+} BMP8Image;
+
+/**
+ * @brief 24-bit BMP image, same layout as in every operator module.
+ */
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; /// BMP file header
+    unsigned char *data;                   /// Pointer to pixel data (BGR format)
+    int width;                             /// Image width in pixels
+    int height;                            /// Image height in pixels
+    int bitDepth;                          /// Bits per pixel (should be 24)
+    int rowSize;                           /// Size of one row including padding
+} BMP24Image;
+
+/**
+ * @brief Rotation types (as in ImageRotation).
+ */
+typedef enum {
+    CLOCKWISE, COUNTER_CLOCKWISE, ROTATE_180
+} rotation;
+
+/**
+ * @brief Allocate a synthetic 8-bit image filled with a deterministic pattern.
+ *
+ * @param width Image width in pixels.
+ * @param height Image height in pixels.
+ * @return New image with a valid header and grey color table, or NULL.
+ */
+BMP8Image* BMP8CreateSynthetic(int width, int height);
+
+/**
+ * @brief Allocate a synthetic 24-bit image filled with a deterministic pattern.
+ */
+BMP24Image* BMP24CreateSynthetic(int width, int height);
+
+/**
+ * @brief Free memory used by an 8-bit image.
+ */
+void BMP8Free(BMP8Image* img);
+
+/**
+ * @brief Free memory used by a 24-bit image.
+ */
+void BMP24Free(BMP24Image* img24);
+
+// Copies of the operators under test; each matches the module named in operators.c
+
+bool BMP8ConvolutionInto(BMP8Image* img, mask* m, BMP8Image* dst);
+bool BMP8ConvolutionFFTInto(BMP8Image* img, mask* m, BMP8Image* dst);
+bool BMP8ConvolutionConstant3x3Into(BMP8Image* img, BMP8Image* dst);
+bool BMP8FilterMedianInto(BMP8Image* img, int kernelSize, BMP8Image* dst);
+bool BMP8BlurInto(BMP8Image* img, unsigned int size, BMP8Image* dst);
+bool BMP8HistogramInto(BMP8Image* img, float* hist);
+bool BMP8RotateInto(BMP8Image* img, rotation r, BMP8Image* dst);
+bool BMP8NoiseGaussianInto(BMP8Image* img, float mean, float var, BMP8Image* dst);
+bool BMP8NoiseSaltPepperInto(BMP8Image* img, float prob, BMP8Image* dst);
+bool BMP24ConvertTo8Into(BMP24Image* img24, BMP8Image* dst);
+
+#endif // OPERATORS_H
@@ -0,0 +1,120 @@
+#include <string.h>
+#include <unistd.h>
+#include "perfcounters.h"
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+static const char *counterNames[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "cache_references", "cache_misses",
+    "l1d_misses", "branches", "branch_misses", "page_faults"
+};
+
+const char* perfCounterName(perfCounter counter) {
+    return counterNames[counter];
+}
+
+#ifdef __linux__
+
+// Event type and configuration of every counter
+static const struct {
+    unsigned type;
+    unsigned long long config;
+} counterEvents[PERF_COUNTER_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+int perfOpen(perfCounters* counters) {
+    int opened = 0;
+    memset(counters, 0, sizeof(perfCounters));
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = counterEvents[i].type;
+        attr.config = counterEvents[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Independent events: one unsupported counter must not disable the others
+        counters->fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counters->fd[i] >= 0) {
+            opened++;
+        }
+    }
+    return opened;
+}
+
+void perfStart(perfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fd[i] >= 0) {
+            ioctl(counters->fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void perfStop(perfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fd[i] >= 0) {
+            ioctl(counters->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        counters->valid[i] = false;
+        // value, time enabled, time running
+        uint64_t data[3];
+        if (counters->fd[i] < 0 || read(counters->fd[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) {
+            continue;
+        }
+        // Extrapolate when the event only ran for part of the time
+        counters->value[i] = data[2] < data[1] ? (uint64_t)((double)data[0] * data[1] / data[2]) : data[0];
+        counters->valid[i] = true;
+    }
+}
+
+void perfClose(perfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fd[i] >= 0) {
+            close(counters->fd[i]);
+            counters->fd[i] = -1;
+        }
+    }
+}
+
+#else
+
+// No perf_event_open: every counter is unavailable
+int perfOpen(perfCounters* counters) {
+    memset(counters, 0, sizeof(perfCounters));
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        counters->fd[i] = -1;
+    }
+    return 0;
+}
+
+void perfStart(perfCounters* counters) {
+    (void)counters;
+}
+
+void perfStop(perfCounters* counters) {
+    (void)counters;
+}
+
+void perfClose(perfCounters* counters) {
+    (void)counters;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Hardware and software events counted around an operator call.
+ */
+typedef enum {
+    PERF_CYCLES,            /// core clock cycles
+    PERF_INSTRUCTIONS,      /// retired instructions
+    PERF_CACHE_REFERENCES,  /// last level cache accesses
+    PERF_CACHE_MISSES,      /// last level cache misses
+    PERF_L1D_MISSES,        /// level 1 data cache read misses
+    PERF_BRANCHES,          /// retired branch instructions
+    PERF_BRANCH_MISSES,     /// mispredicted branches
+    PERF_PAGE_FAULTS,       /// page faults (software event)
+    PERF_COUNTER_COUNT
+} perfCounter;
+
+/**
+ * @brief Set of perf_event_open counters for the calling thread.
+ *
+ * Counters the kernel or CPU does not provide (virtual machines often
+ * expose no PMU) stay unavailable and are reported as such; the others
+ * keep working.
+ */
+typedef struct {
+    int fd[PERF_COUNTER_COUNT];             /// event descriptors, -1 when unavailable
+    uint64_t value[PERF_COUNTER_COUNT];     /// counts of the last perfStart/perfStop pair
+    bool valid[PERF_COUNTER_COUNT];         /// true when value holds a count
+} perfCounters;
+
+/**
+ * @brief Short name of a counter as used in reports ("cycles", "cache_misses", ...).
+ */
+const char* perfCounterName(perfCounter counter);
+
+/**
+ * @brief Open every counter for the calling thread, user space only.
+ *
+ * @param counters Set to initialize.
+ * @return Number of counters that could be opened (0 without perf_event_open).
+ */
+int perfOpen(perfCounters* counters);
+
+/**
+ * @brief Reset and start every open counter.
+ */
+void perfStart(perfCounters* counters);
+
+/**
+ * @brief Stop every open counter and read the counts into value.
+ *
+ * Counts are scaled when the kernel had to multiplex the events.
+ */
+void perfStop(perfCounters* counters);
+
+/**
+ * @brief Close every counter.
+ */
+void perfClose(perfCounters* counters);
+
+#endif // PERFCOUNTERS_H
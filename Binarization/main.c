@@ -1,5 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 // Define BMP header size
 #define BMP_HEADER_SIZE 54
@@ -9,6 +16,8 @@
 #define BLACK 0
 // Size of color table for 8-bit BMP
 #define BMP_COLOR_TABLE_SIZE 1024
+// Size of color table for 1-bit BMP (black and white)
+#define BMP1_COLOR_TABLE_SIZE 8
 
 
 // Define a structure to hold 8-bit BMP image data
@@ -22,6 +31,25 @@ typedef struct {
     int imgSize;                                    // Total number of pixels
 } BMP8Image; // Structure holding 8-bit BMP image data
 
+// Binary image with one bit per pixel, 64 pixels per word
+// Pixel x of row y is bit (x % 64) of data[y * wordsPerRow + x / 64]; 1 is white.
+// Bits past the width in the last word of a row are always 0.
+typedef struct {
+    uint64_t *data;                                 // Pointer to packed pixel data
+    int width;                                      // Image width
+    int height;                                     // Image height
+    int wordsPerRow;                                // 64-bit words per row
+} BMP1Image; // Structure holding a packed binary image
+
+// Bitwise operations between binary images
+typedef enum {
+    BIT_AND,        // white where both are white
+    BIT_OR,         // white where either is white
+    BIT_XOR,        // white where exactly one is white
+    BIT_ANDNOT,     // white where the first is white and the second black
+    BIT_NOT         // inverse of the first (the second is ignored)
+} bitOperation;
+
  
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
@@ -47,7 +75,9 @@ BMP8Image* BMP8read(const char* filename) {
     img->width = *(int*)&img->header[18];
     img->height = *(int*)&img->header[22];
     img->bitDepth = *(short*)&img->header[28];
-    img->imgSize = img->width * img->height;
+    // Rows are padded to a multiple of 4 bytes
+    int rowSize = (img->width + 3) & ~3;
+    img->imgSize = rowSize * img->height;
 
     // Read color table if BMP is 8-bit or less
     if (img->bitDepth <= 8) {
@@ -112,6 +142,421 @@ void BMP8Free(BMP8Image* img) {
     }
 }
 
+// Function to allocate a black binary image
+BMP1Image* BMP1Create(int width, int height) {
+    if (width < 1 || height < 1) {
+        fprintf(stderr, "Binarization Error: Invalid binary image size %dx%d.\n", width, height);
+        return NULL;
+    }
+    BMP1Image *img = (BMP1Image*)malloc(sizeof(BMP1Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    img->width = width;
+    img->height = height;
+    img->wordsPerRow = (width + 63) / 64;
+    img->data = (uint64_t*)calloc((size_t)img->wordsPerRow * height, sizeof(uint64_t));
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        return NULL;
+    }
+    return img;
+}
+
+// Function to free memory used by BMP1Image structure
+void BMP1Free(BMP1Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Valid bits of the last word of a row
+static inline uint64_t BMP1TailMask(int width) {
+    return (width % 64) ? (((uint64_t)1 << (width % 64)) - 1) : ~(uint64_t)0;
+}
+
+// Mirror the bits of a byte: BMP files store the leftmost pixel in the top bit
+static inline unsigned char reverseBits(unsigned char b) {
+    b = (unsigned char)((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+    b = (unsigned char)((b & 0xCC) >> 2 | (b & 0x33) << 2);
+    return (unsigned char)((b & 0xAA) >> 1 | (b & 0x55) << 1);
+}
+
+// Function to binarize an 8-bit BMP image straight into a packed binary image
+// Pixels above the threshold become white; the 8-bit image is left unchanged
+BMP1Image* BMP8BinarizePacked(BMP8Image* img, int threshold) {
+    BMP1Image *bin = BMP1Create(img->width, img->height);
+    if (!bin) {
+        return NULL;
+    }
+    int rowSize = (img->width + 3) & ~3;
+    for (int y = 0; y < img->height; y++) {
+        const unsigned char *src = img->data + (size_t)y * rowSize;
+        uint64_t *dst = bin->data + (size_t)y * bin->wordsPerRow;
+        int x = 0;
+#ifdef __SSE2__
+        // 16 comparisons per instruction; movemask gathers their results into 16 bits.
+        // Bytes are compared as signed after flipping the top bit
+        if (threshold >= 0 && threshold < WHITE) {
+            const __m128i flip = _mm_set1_epi8((char)0x80);
+            const __m128i limit = _mm_set1_epi8((char)(threshold ^ 0x80));
+            for (; x + 16 <= img->width; x += 16) {
+                __m128i px = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + x)), flip);
+                uint64_t bits = (uint64_t)_mm_movemask_epi8(_mm_cmpgt_epi8(px, limit));
+                dst[x / 64] |= bits << (x % 64);
+            }
+        }
+#endif
+        for (; x < img->width; x++) {
+            if (src[x] > threshold) {
+                dst[x / 64] |= (uint64_t)1 << (x % 64);
+            }
+        }
+    }
+    return bin;
+}
+
+// Function to expand a packed binary image into an 8-bit image with the given header
+// and color table (taken from template, which must have the same size)
+BMP8Image* BMP1ToBMP8(BMP1Image* bin, BMP8Image* template) {
+    if (!bin || !template || bin->width != template->width || bin->height != template->height) {
+        fprintf(stderr, "Binarization Error: Binary image and template sizes differ.\n");
+        return NULL;
+    }
+    BMP8Image *img = (BMP8Image*)malloc(sizeof(BMP8Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    *img = *template;
+    img->data = (unsigned char*)calloc(img->imgSize, 1);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        return NULL;
+    }
+    int rowSize = (img->width + 3) & ~3;
+    for (int y = 0; y < img->height; y++) {
+        const uint64_t *src = bin->data + (size_t)y * bin->wordsPerRow;
+        unsigned char *dst = img->data + (size_t)y * rowSize;
+        for (int x = 0; x < img->width; x++) {
+            dst[x] = ((src[x / 64] >> (x % 64)) & 1) ? WHITE : BLACK;
+        }
+    }
+    return img;
+}
+
+// Function to read a 1-bit BMP image from a file
+// The palette entry with the brighter color becomes white
+BMP1Image* BMP1read(const char* filename) {
+    FILE *fInput = fopen(filename, "rb");
+    if (!fInput) {
+        fprintf(stderr, "Unable to open file %s!\n", filename);
+        return NULL;
+    }
+
+    // Read BMP header and check the bit depth
+    unsigned char header[BMP_HEADER_SIZE];
+    unsigned char colorTable[BMP1_COLOR_TABLE_SIZE];
+    if (fread(header, sizeof(unsigned char), BMP_HEADER_SIZE, fInput) != BMP_HEADER_SIZE ||
+        fread(colorTable, sizeof(unsigned char), BMP1_COLOR_TABLE_SIZE, fInput) != BMP1_COLOR_TABLE_SIZE) {
+        fprintf(stderr, "Binarization Error: %s is not a BMP file.\n", filename);
+        fclose(fInput);
+        return NULL;
+    }
+    int offset = *(int*)&header[10];
+    int width = *(int*)&header[18];
+    int height = *(int*)&header[22];
+    int bitDepth = *(short*)&header[28];
+    if (header[0] != 'B' || header[1] != 'M' || bitDepth != 1) {
+        fprintf(stderr, "Binarization Error: %s is not a 1-bit BMP file.\n", filename);
+        fclose(fInput);
+        return NULL;
+    }
+
+    BMP1Image *img = BMP1Create(width, height);
+    // Rows are padded to a multiple of 4 bytes
+    int rowBytes = ((width + 31) / 32) * 4;
+    unsigned char *row = (unsigned char*)malloc(rowBytes);
+    if (!img || !row || fseek(fInput, offset, SEEK_SET) != 0) {
+        fprintf(stderr, "Binarization Error: Unable to read %s.\n", filename);
+        BMP1Free(img);
+        free(row);
+        fclose(fInput);
+        return NULL;
+    }
+
+    // Index 1 is white unless the palette says otherwise
+    int luma0 = colorTable[0] + colorTable[1] + colorTable[2];
+    int luma1 = colorTable[4] + colorTable[5] + colorTable[6];
+    unsigned char invert = luma0 > luma1 ? 0xFF : 0x00;
+    uint64_t tail = BMP1TailMask(width);
+    for (int y = 0; y < height; y++) {
+        if (fread(row, sizeof(unsigned char), rowBytes, fInput) != (size_t)rowBytes) {
+            fprintf(stderr, "Binarization Error: %s is truncated.\n", filename);
+            BMP1Free(img);
+            free(row);
+            fclose(fInput);
+            return NULL;
+        }
+        uint64_t *dst = img->data + (size_t)y * img->wordsPerRow;
+        for (int i = 0; i < (width + 7) / 8; i++) {
+            dst[i / 8] |= (uint64_t)reverseBits(row[i] ^ invert) << (8 * (i % 8));
+        }
+        dst[img->wordsPerRow - 1] &= tail;
+    }
+    free(row);
+    fclose(fInput);
+    return img;
+}
+
+// Function to save a packed binary image as a 1-bit BMP file
+void BMP1save(const char* filename, BMP1Image* img) {
+    FILE *fOutput = fopen(filename, "wb");
+    if (!fOutput) {
+        fprintf(stderr, "Unable to create file %s!\n", filename);
+        return;
+    }
+
+    // Headers of a 1-bit BMP with a black and white palette
+    int rowBytes = ((img->width + 31) / 32) * 4;
+    int offset = BMP_HEADER_SIZE + BMP1_COLOR_TABLE_SIZE;
+    int dataSize = rowBytes * img->height;
+    unsigned char header[BMP_HEADER_SIZE] = {'B', 'M'};
+    *(int*)&header[2] = offset + dataSize;      // file size
+    *(int*)&header[10] = offset;                // pixel data offset
+    *(int*)&header[14] = 40;                    // info header size
+    *(int*)&header[18] = img->width;
+    *(int*)&header[22] = img->height;
+    *(short*)&header[26] = 1;                   // planes
+    *(short*)&header[28] = 1;                   // bits per pixel
+    *(int*)&header[34] = dataSize;
+    *(int*)&header[38] = 2835;                  // 72 dpi
+    *(int*)&header[42] = 2835;
+    *(int*)&header[46] = 2;                     // colors used
+    unsigned char colorTable[BMP1_COLOR_TABLE_SIZE] = {BLACK, BLACK, BLACK, 0, WHITE, WHITE, WHITE, 0};
+    fwrite(header, sizeof(unsigned char), BMP_HEADER_SIZE, fOutput);
+    fwrite(colorTable, sizeof(unsigned char), BMP1_COLOR_TABLE_SIZE, fOutput);
+
+    // Pixel rows, leftmost pixel in the top bit of each byte
+    unsigned char *row = (unsigned char*)calloc(rowBytes, 1);
+    if (!row) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(fOutput);
+        return;
+    }
+    for (int y = 0; y < img->height; y++) {
+        const uint64_t *src = img->data + (size_t)y * img->wordsPerRow;
+        for (int i = 0; i < (img->width + 7) / 8; i++) {
+            row[i] = reverseBits((unsigned char)(src[i / 8] >> (8 * (i % 8))));
+        }
+        fwrite(row, sizeof(unsigned char), rowBytes, fOutput);
+    }
+    free(row);
+    fclose(fOutput);
+}
+
+// Combine n words of a and b into out (out may be a or b)
+// The operation is chosen outside the loops; with SSE2 each instruction handles 128 pixels
+static void bitsCombine(uint64_t* out, const uint64_t* a, const uint64_t* b, int n, bitOperation op) {
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i ones = _mm_set1_epi32(-1);
+    for (; i + 2 <= n; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = op == BIT_NOT ? ones : _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i r;
+        switch (op) {
+            case BIT_AND: r = _mm_and_si128(va, vb); break;
+            case BIT_OR: r = _mm_or_si128(va, vb); break;
+            case BIT_XOR: r = _mm_xor_si128(va, vb); break;
+            case BIT_ANDNOT: r = _mm_andnot_si128(vb, va); break;
+            default: r = _mm_xor_si128(va, ones); break;
+        }
+        _mm_storeu_si128((__m128i*)(out + i), r);
+    }
+#endif
+    switch (op) {
+        case BIT_AND: for (; i < n; i++) out[i] = a[i] & b[i]; break;
+        case BIT_OR: for (; i < n; i++) out[i] = a[i] | b[i]; break;
+        case BIT_XOR: for (; i < n; i++) out[i] = a[i] ^ b[i]; break;
+        case BIT_ANDNOT: for (; i < n; i++) out[i] = a[i] & ~b[i]; break;
+        default: for (; i < n; i++) out[i] = ~a[i]; break;
+    }
+}
+
+// Function to apply a bitwise operation to whole binary images into dst
+// dst may be a or b; b is ignored (and may be NULL) for BIT_NOT
+bool BMP1LogicInto(BMP1Image* a, BMP1Image* b, bitOperation op, BMP1Image* dst) {
+    if (!a || !dst || (op != BIT_NOT && !b)) {
+        fprintf(stderr, "Binarization Error: Missing binary image.\n");
+        return false;
+    }
+    if ((op != BIT_NOT && (b->width != a->width || b->height != a->height)) ||
+        dst->width != a->width || dst->height != a->height) {
+        fprintf(stderr, "Binarization Error: Binary image sizes differ.\n");
+        return false;
+    }
+    // Rows are contiguous, so the images are combined as one array
+    bitsCombine(dst->data, a->data, op == BIT_NOT ? a->data : b->data, a->wordsPerRow * a->height, op);
+    if (op == BIT_NOT) {
+        uint64_t tail = BMP1TailMask(a->width);
+        for (int y = 0; y < a->height; y++) {
+            dst->data[(size_t)y * a->wordsPerRow + a->wordsPerRow - 1] &= tail;
+        }
+    }
+    return true;
+}
+
+// Allocating variant of BMP1LogicInto
+BMP1Image* BMP1Logic(BMP1Image* a, BMP1Image* b, bitOperation op) {
+    if (!a) {
+        fprintf(stderr, "Binarization Error: Missing binary image.\n");
+        return NULL;
+    }
+    BMP1Image *dst = BMP1Create(a->width, a->height);
+    if (dst && !BMP1LogicInto(a, b, op, dst)) {
+        BMP1Free(dst);
+        return NULL;
+    }
+    return dst;
+}
+
+// Word k of a row with pixels outside [0, width) set to fill
+static inline uint64_t bitsWord(const uint64_t* row, int words, uint64_t tailFill, uint64_t fill, int k) {
+    if (k < 0 || k >= words) {
+        return fill;
+    }
+    return k == words - 1 ? row[k] | tailFill : row[k];
+}
+
+// dst pixel x (x < dstWidth) = src pixel x + shift, or fill (0 or 1) where that is outside
+// [0, srcWidth)
+static void bitsShiftRow(const uint64_t* src, int srcWidth, int shift, bool fill, uint64_t* dst, int dstWidth) {
+    int srcWords = (srcWidth + 63) / 64, dstWords = (dstWidth + 63) / 64;
+    uint64_t fillWord = fill ? ~(uint64_t)0 : 0;
+    uint64_t tailFill = fillWord & ~BMP1TailMask(srcWidth);
+    // shift = 64 * q + r with 0 <= r < 64
+    int q = shift >= 0 ? shift / 64 : -((-shift + 63) / 64);
+    int r = shift - 64 * q;
+    for (int i = 0; i < dstWords; i++) {
+        uint64_t lo = bitsWord(src, srcWords, tailFill, fillWord, i + q);
+        if (r) {
+            uint64_t hi = bitsWord(src, srcWords, tailFill, fillWord, i + q + 1);
+            lo = (lo >> r) | (hi << (64 - r));
+        }
+        dst[i] = lo;
+    }
+    dst[dstWords - 1] &= BMP1TailMask(dstWidth);
+}
+
+// Function to erode (or dilate) a binary image with a filled seWidth x seHeight rectangle
+// centered at (seWidth / 2, seHeight / 2) into dst; pixels outside the image are ignored.
+// Rows are eroded with log2(seWidth) shift-and-combine passes of 64 pixels per word,
+// columns by combining whole rows
+bool BMP1MorphologyInto(BMP1Image* img, int seWidth, int seHeight, bool dilate, BMP1Image* dst) {
+    if (!img || !dst) {
+        fprintf(stderr, "Binarization Error: Missing binary image.\n");
+        return false;
+    }
+    if (seWidth < 1 || seHeight < 1) {
+        fprintf(stderr, "Binarization Error: Structuring element must be at least 1x1.\n");
+        return false;
+    }
+    if (dst->width != img->width || dst->height != img->height || dst->data == img->data) {
+        fprintf(stderr, "Binarization Error: Destination must be a different image of the same size.\n");
+        return false;
+    }
+
+    int words = img->wordsPerRow;
+    bitOperation op = dilate ? BIT_OR : BIT_AND;
+    bool fill = !dilate;
+    // Window [x + d0, x + d1] horizontally and [y + e0, y + e1] vertically; dilation
+    // uses the reflected rectangle
+    int cx = seWidth / 2, cy = seHeight / 2;
+    int d0 = dilate ? -(seWidth - 1 - cx) : -cx;
+    int e0 = dilate ? -(seHeight - 1 - cy) : -cy;
+    int e1 = e0 + seHeight - 1;
+
+    // Rows are widened by seWidth identity pixels on both sides, so every window of
+    // the horizontal pass starts and ends inside the widened row
+    int pad = seWidth;
+    int wideWidth = img->width + 2 * pad, wideWords = (wideWidth + 63) / 64;
+    uint64_t *rows = (uint64_t*)malloc((size_t)words * img->height * sizeof(uint64_t));
+    uint64_t *t = (uint64_t*)malloc((size_t)(2 * wideWords + 2 * words) * sizeof(uint64_t));
+    if (!rows || !t) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(rows);
+        free(t);
+        return false;
+    }
+    uint64_t *shifted = t + wideWords, *first = shifted + wideWords, *second = first + words;
+
+    // Horizontal pass: t holds windows [x, x + span - 1], doubled until span exceeds
+    // seWidth / 2, then two overlapping windows cover [x + d0, x + d0 + seWidth - 1]
+    for (int y = 0; y < img->height; y++) {
+        bitsShiftRow(img->data + (size_t)y * words, img->width, -pad, fill, t, wideWidth);
+        int span = 1;
+        while (2 * span <= seWidth) {
+            bitsShiftRow(t, wideWidth, span, fill, shifted, wideWidth);
+            bitsCombine(t, t, shifted, wideWords, op);
+            span *= 2;
+        }
+        bitsShiftRow(t, wideWidth, pad + d0, fill, first, img->width);
+        bitsShiftRow(t, wideWidth, pad + d0 + seWidth - span, fill, second, img->width);
+        bitsCombine(rows + (size_t)y * words, first, second, words, op);
+    }
+
+    // Vertical pass over the rows inside the image
+    for (int y = 0; y < img->height; y++) {
+        uint64_t *out = dst->data + (size_t)y * words;
+        int first = y + e0 < 0 ? 0 : y + e0;
+        int last = y + e1 >= img->height ? img->height - 1 : y + e1;
+        memcpy(out, rows + (size_t)first * words, words * sizeof(uint64_t));
+        for (int k = first + 1; k <= last; k++) {
+            bitsCombine(out, out, rows + (size_t)k * words, words, op);
+        }
+    }
+
+    free(rows);
+    free(t);
+    return true;
+}
+
+// Allocating variant of BMP1MorphologyInto
+static BMP1Image* BMP1Morphology(BMP1Image* img, int seWidth, int seHeight, bool dilate) {
+    if (!img) {
+        fprintf(stderr, "Binarization Error: Missing binary image.\n");
+        return NULL;
+    }
+    BMP1Image *dst = BMP1Create(img->width, img->height);
+    if (dst && !BMP1MorphologyInto(img, seWidth, seHeight, dilate, dst)) {
+        BMP1Free(dst);
+        return NULL;
+    }
+    return dst;
+}
+
+// Erosion: white only where the whole rectangle is white
+BMP1Image* BMP1Erode(BMP1Image* img, int seWidth, int seHeight) {
+    return BMP1Morphology(img, seWidth, seHeight, false);
+}
+
+// Dilation: white where any pixel of the rectangle is white
+BMP1Image* BMP1Dilate(BMP1Image* img, int seWidth, int seHeight) {
+    return BMP1Morphology(img, seWidth, seHeight, true);
+}
+
+// Current monotonic time in seconds
+static double secondsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
 int main(){
     // Input BMP file path
     const char *inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
@@ -122,6 +567,44 @@ int main(){
     BMP8Image *image = BMP8read(inputFile);
     if (!image) exit(1);
 
+    // Packed binarization: 1 bit per pixel instead of 8
+    double start = secondsNow();
+    BMP1Image *packed = BMP8BinarizePacked(image, threshold);
+    double packTime = secondsNow() - start;
+    if (!packed) {
+        BMP8Free(image);
+        exit(1);
+    }
+    fprintf(stdout, "Packed %dx%d in %.2f ms: %zu bytes instead of %d\n", packed->width, packed->height,
+            packTime * 1e3, (size_t)packed->wordsPerRow * packed->height * sizeof(uint64_t), image->imgSize);
+    BMP1save("images/lizard_binary_thr150_1bpp.bmp", packed);
+
+    // Opening (erosion then dilation) removes white specks smaller than 5x5;
+    // XOR with the input shows what it removed
+    start = secondsNow();
+    BMP1Image *eroded = BMP1Erode(packed, 5, 5);
+    BMP1Image *opened = eroded ? BMP1Dilate(eroded, 5, 5) : NULL;
+    BMP1Image *removed = opened ? BMP1Logic(packed, opened, BIT_XOR) : NULL;
+    double openTime = secondsNow() - start;
+    if (removed) {
+        fprintf(stdout, "Opened with a 5x5 square and compared in %.2f ms\n", openTime * 1e3);
+        BMP1save("images/lizard_binary_thr150_open5x5_1bpp.bmp", opened);
+        BMP1save("images/lizard_binary_thr150_removed_1bpp.bmp", removed);
+    }
+    BMP1Free(eroded);
+    BMP1Free(opened);
+    BMP1Free(removed);
+
+    // Reading the 1-bit file back gives the same packed image
+    BMP1Image *reloaded = BMP1read("images/lizard_binary_thr150_1bpp.bmp");
+    if (reloaded) {
+        bool same = memcmp(reloaded->data, packed->data,
+                           (size_t)packed->wordsPerRow * packed->height * sizeof(uint64_t)) == 0;
+        fprintf(stdout, "1-bit BMP round trip %s\n", same ? "matches" : "differs");
+        BMP1Free(reloaded);
+    }
+    BMP1Free(packed);
+
     // Apply binarization
     BMP8Binarize(image, threshold);
 
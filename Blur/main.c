@@ -1,12 +1,29 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "mask.h"
+#include "taskgraph.h"
 
 // Fixed BMP header size
 #define BMP_HEADER_SIZE 54
 // Fixed color table size for 8-bit BMP (256 * 4 bytes = 1024)
 #define BMP_COLOR_TABLE_SIZE 1024
 
+#define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
+#define MAX(a, b) ((a) > (b) ? (a) : (b))   // returns the larger of (a) and (b)
+
+// Columns filtered together by one pass of the recursive Gaussian (4 cache lines of floats)
+#define GAUSSIAN_STRIP 64
+// Rows or columns handled by one task of the recursive Gaussian
+#define GAUSSIAN_TASK 64
+
 // Structure to hold 8-bit BMP image data
 typedef struct {
     unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
@@ -18,6 +35,16 @@ typedef struct {
     int imgSize;                                    // Total pixel data size (with padding)
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
 
 // Function to read an 8-bit BMP image from file
 BMP8Image* BMP8read(const char* filename) {
@@ -73,48 +100,104 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-// Function to blur image using averaging filter
-BMP8Image* BMP8Blur(BMP8Image* img, unsigned int size) {
-    // Allocate memory for blurred image structure
-    BMP8Image* blurredImg = malloc(sizeof(BMP8Image));
-    if (!blurredImg) {
+// Function to free allocated memory
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        // free pixel data
+        free(img->data);
+        // free struct
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
+        return NULL;
+    }
+
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
     // Copy BMP header and metadata
-    memcpy(blurredImg->header, img->header, BMP_HEADER_SIZE);
-    blurredImg->width = img->width;
-    blurredImg->height = img->height;
-    blurredImg->bitDepth = img->bitDepth;
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
-    // Copy color table if image is 8-bit
+    // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(blurredImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
-    // Compute padded row size (each row aligned to 4 bytes)
+    // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    blurredImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
-    // Allocate memory for pixel data of blurred image
-    blurredImg->data = malloc(blurredImg->imgSize);
-    if (!blurredImg->data) {
+    // Allocate memory for pixel data
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(blurredImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Function to blur image using averaging filter, writing into a caller-supplied image
+// dst must have the size of img and must not alias it; border pixels are copied unchanged
+bool BMP8BlurInto(BMP8Image* img, unsigned int size, BMP8Image* dst) {
+    if (!img) {
+        fprintf(stderr, "Blur Error: No image provided.\n");
+        return false;
+    }
+    if (!BMP8CheckDestination(img, dst)) {
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Blur Error: In-place blur is not supported.\n");
+        return false;
+    }
+
+    // Compute padded row size (each row aligned to 4 bytes)
+    int rowSize = (img->width + 3) & ~3;
 
     // Copy original image data to blurred image (so border pixels remain unchanged)
-    memcpy(blurredImg->data, img->data, blurredImg->imgSize);
+    memcpy(dst->data, img->data, img->imgSize);
 
     // Create averaging kernel of size (size × size)
     float* kernel = malloc(size * size * sizeof(float));
     if (!kernel) {
         fprintf(stderr, "Memory allocation failed for kernel!\n");
-        free(blurredImg->data);
-        free(blurredImg);
-        return NULL;
+        return false;
     }
 
     // Fill kernel with equal weights
@@ -143,14 +226,403 @@ BMP8Image* BMP8Blur(BMP8Image* img, unsigned int size) {
             if (sum < 0) sum = 0;
             if (sum > 255) sum = 255;
 
-            blurredImg->data[y * rowSize + x] = (unsigned char)sum;
+            dst->data[y * rowSize + x] = (unsigned char)sum;
         }
     }
 
     // Free kernel memory
     free(kernel);
 
-    return blurredImg;
+    return true;
+}
+
+// Function to blur image using averaging filter
+BMP8Image* BMP8Blur(BMP8Image* img, unsigned int size){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8BlurInto(img, size, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
+
+// Coefficients of the Young - van Vliet recursive Gaussian (third order)
+typedef struct {
+    float b;        // input gain
+    float a[3];     // feedback of the three previous outputs
+    float m[9];     // Triggs - Sdika matrix: backward start state from the forward end state
+} gaussianCoefficients;
+
+// Feedback coefficients of the third-order filter whose poles are the sigma = 2
+// poles of van Vliet, Young and Verbeek raised to 1/q
+// Returns the variance of the forward-backward cascade
+static double gaussianFeedback(double q, double* a){
+    const double complex poles[3] = {1.41650 + 1.00829 * I, 1.41650 - 1.00829 * I, 1.86543};
+    double complex p[3];
+    double variance = 0.0;
+    for(int i = 0; i < 3; i++){
+        // Each section 1 / (1 - p z^-1) spreads like a geometric distribution
+        p[i] = 1.0 / cpow(poles[i], 1.0 / q);
+        variance += 2.0 * creal(p[i] / ((1.0 - p[i]) * (1.0 - p[i])));
+    }
+    a[0] = creal(p[0] + p[1] + p[2]);
+    a[1] = -creal(p[0] * p[1] + p[0] * p[2] + p[1] * p[2]);
+    a[2] = creal(p[0] * p[1] * p[2]);
+    return variance;
+}
+
+// Compute the recursive filter for sigma (>= 0.5)
+static bool gaussianCoefficientsFor(float sigma, gaussianCoefficients* c){
+    // The scale q is solved for so that the cascade has variance sigma^2
+    // (the closed form of Young and van Vliet overshoots sigma by about 10%)
+    double lo = 0.05, hi = 4.0 * sigma + 8.0, a[3];
+    for(int i = 0; i < 60; i++){
+        double q = 0.5 * (lo + hi);
+        if(gaussianFeedback(q, a) < (double)sigma * sigma){
+            lo = q;
+        } else {
+            hi = q;
+        }
+    }
+    gaussianFeedback(0.5 * (lo + hi), a);
+    double a1 = a[0], a2 = a[1], a3 = a[2];
+    double b = 1.0 - (a1 + a2 + a3);
+    c->b = (float)b;
+    c->a[0] = (float)a1;
+    c->a[1] = (float)a2;
+    c->a[2] = (float)a3;
+
+    // The edge is replicated past the last sample. Relative to that value the
+    // forward filter then decays freely and the backward filter started far
+    // away meets it; following both for each unit end state gives the matrix
+    int length = (int)(10.0f * sigma) + 64;
+    double* forward = malloc(length * sizeof(double));
+    double* backward = malloc((length + 3) * sizeof(double));
+    if(!forward || !backward){
+        free(forward);
+        free(backward);
+        return false;
+    }
+    for(int k = 0; k < 3; k++){
+        double w1 = k == 0, w2 = k == 1, w3 = k == 2;
+        for(int i = 0; i < length; i++){
+            forward[i] = a1 * w1 + a2 * w2 + a3 * w3;
+            w3 = w2;
+            w2 = w1;
+            w1 = forward[i];
+        }
+        backward[length] = backward[length + 1] = backward[length + 2] = 0.0;
+        for(int i = length - 1; i >= 0; i--){
+            backward[i] = b * forward[i] + a1 * backward[i + 1] + a2 * backward[i + 2] + a3 * backward[i + 3];
+        }
+        for(int r = 0; r < 3; r++){
+            c->m[r * 3 + k] = (float)backward[r];
+        }
+    }
+    free(forward);
+    free(backward);
+    return true;
+}
+
+// One step of the recursion over a strip: out = b * p + a1 * w1 + a2 * w2 + a3 * w3,
+// written to p and to out (which may be w3)
+static void gaussianStep(float* p, const float* w1, const float* w2, const float* w3, float* out, int width, const gaussianCoefficients* c){
+    int x = 0;
+#ifdef __SSE2__
+    __m128 b = _mm_set1_ps(c->b);
+    __m128 a1 = _mm_set1_ps(c->a[0]), a2 = _mm_set1_ps(c->a[1]), a3 = _mm_set1_ps(c->a[2]);
+    for(; x + 4 <= width; x += 4){
+        __m128 v = _mm_mul_ps(b, _mm_loadu_ps(p + x));
+        v = _mm_add_ps(v, _mm_mul_ps(a1, _mm_loadu_ps(w1 + x)));
+        v = _mm_add_ps(v, _mm_mul_ps(a2, _mm_loadu_ps(w2 + x)));
+        v = _mm_add_ps(v, _mm_mul_ps(a3, _mm_loadu_ps(w3 + x)));
+        _mm_storeu_ps(p + x, v);
+        _mm_storeu_ps(out + x, v);
+    }
+#endif
+    for(; x < width; x++){
+        float v = c->b * p[x] + c->a[0] * w1[x] + c->a[1] * w2[x] + c->a[2] * w3[x];
+        p[x] = v;
+        out[x] = v;
+    }
+}
+
+// Filter columns [x0, x1) of an n-row float array in place, strip by strip:
+// every row of a strip is contiguous, so the recursion runs across columns in SIMD
+static void gaussianColumns(float* data, int n, int stride, int x0, int x1, const gaussianCoefficients* c){
+    float state[3][GAUSSIAN_STRIP];
+    float last[GAUSSIAN_STRIP];
+    for(int s = x0; s < x1; s += GAUSSIAN_STRIP){
+        int width = MIN(GAUSSIAN_STRIP, x1 - s);
+        float* first = data + s;
+        float* end = data + (size_t)(n - 1) * stride + s;
+
+        // Forward pass, starting in the steady state of the replicated first sample
+        for(int x = 0; x < width; x++){
+            state[0][x] = state[1][x] = state[2][x] = first[x];
+            last[x] = end[x];
+        }
+        float *w1 = state[0], *w2 = state[1], *w3 = state[2];
+        for(int i = 0; i < n; i++){
+            gaussianStep(data + (size_t)i * stride + s, w1, w2, w3, w3, width, c);
+            float* t = w3;
+            w3 = w2;
+            w2 = w1;
+            w1 = t;
+        }
+
+        // Backward pass, starting from the exact state for the replicated last sample
+        for(int x = 0; x < width; x++){
+            float d1 = w1[x] - last[x], d2 = w2[x] - last[x], d3 = w3[x] - last[x];
+            float y1 = last[x] + c->m[0] * d1 + c->m[1] * d2 + c->m[2] * d3;
+            float y2 = last[x] + c->m[3] * d1 + c->m[4] * d2 + c->m[5] * d3;
+            float y3 = last[x] + c->m[6] * d1 + c->m[7] * d2 + c->m[8] * d3;
+            w1[x] = y1;
+            w2[x] = y2;
+            w3[x] = y3;
+        }
+        for(int i = n - 1; i >= 0; i--){
+            gaussianStep(data + (size_t)i * stride + s, w1, w2, w3, w3, width, c);
+            float* t = w3;
+            w3 = w2;
+            w2 = w1;
+            w1 = t;
+        }
+    }
+}
+
+// State shared by the tasks of one recursive Gaussian
+typedef struct {
+    BMP8Image* img;             // source image
+    BMP8Image* dst;             // destination image
+    float* across;              // width x height: the image transposed, filtered along its columns
+    float* down;                // height x width: transposed back, filtered along its columns
+    gaussianCoefficients c;     // recursive filter
+} gaussianJob;
+
+// One task: a range of rows or columns of one phase
+typedef struct {
+    gaussianJob* job;
+    int begin;
+    int end;
+} gaussianTask;
+
+// Phase 1: transpose image rows [begin, end) into columns of across, in 8x8 blocks
+static void gaussianTranspose(void* arg){
+    gaussianTask* t = arg;
+    BMP8Image* img = t->job->img;
+    int rowSize = (img->width + 3) & ~3;
+    for(int y0 = t->begin; y0 < t->end; y0 += 8){
+        for(int x0 = 0; x0 < img->width; x0 += 8){
+            for(int x = x0; x < MIN(x0 + 8, img->width); x++){
+                for(int y = y0; y < MIN(y0 + 8, t->end); y++){
+                    t->job->across[(size_t)x * img->height + y] = img->data[y * rowSize + x];
+                }
+            }
+        }
+    }
+}
+
+// Phase 2: horizontal filter, as a column filter of across
+static void gaussianHorizontal(void* arg){
+    gaussianTask* t = arg;
+    gaussianColumns(t->job->across, t->job->img->width, t->job->img->height, t->begin, t->end, &t->job->c);
+}
+
+// Phase 3: transpose rows [begin, end) of across back into columns of down, in 4x4 blocks
+static void gaussianTransposeBack(void* arg){
+    gaussianTask* t = arg;
+    int width = t->job->img->width, height = t->job->img->height;
+    const float* src = t->job->across;
+    float* dst = t->job->down;
+    int x0 = t->begin;
+#ifdef __SSE2__
+    for(; x0 + 4 <= t->end; x0 += 4){
+        int y = 0;
+        for(; y + 4 <= height; y += 4){
+            __m128 r0 = _mm_loadu_ps(src + (size_t)x0 * height + y);
+            __m128 r1 = _mm_loadu_ps(src + (size_t)(x0 + 1) * height + y);
+            __m128 r2 = _mm_loadu_ps(src + (size_t)(x0 + 2) * height + y);
+            __m128 r3 = _mm_loadu_ps(src + (size_t)(x0 + 3) * height + y);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(dst + (size_t)y * width + x0, r0);
+            _mm_storeu_ps(dst + (size_t)(y + 1) * width + x0, r1);
+            _mm_storeu_ps(dst + (size_t)(y + 2) * width + x0, r2);
+            _mm_storeu_ps(dst + (size_t)(y + 3) * width + x0, r3);
+        }
+        for(; y < height; y++){
+            for(int x = x0; x < x0 + 4; x++){
+                dst[(size_t)y * width + x] = src[(size_t)x * height + y];
+            }
+        }
+    }
+#endif
+    for(; x0 < t->end; x0++){
+        for(int y = 0; y < height; y++){
+            dst[(size_t)y * width + x0] = src[(size_t)x0 * height + y];
+        }
+    }
+}
+
+// Phase 4: vertical filter on columns [begin, end) of down
+static void gaussianVertical(void* arg){
+    gaussianTask* t = arg;
+    gaussianColumns(t->job->down, t->job->img->height, t->job->img->width, t->begin, t->end, &t->job->c);
+}
+
+// Phase 5: round and clamp rows [begin, end) of down into the destination
+static void gaussianStore(void* arg){
+    gaussianTask* t = arg;
+    int width = t->job->img->width;
+    int rowSize = (width + 3) & ~3;
+    for(int y = t->begin; y < t->end; y++){
+        const float* row = t->job->down + (size_t)y * width;
+        for(int x = 0; x < width; x++){
+            float v = row[x] + 0.5f;
+            v = MIN(v, 255.0f);
+            v = MAX(v, 0.0f);
+            t->job->dst->data[y * rowSize + x] = (unsigned char)v;
+        }
+    }
+}
+
+// Separates two phases: every task of the next phase waits for this one
+static void gaussianBarrier(void* arg){
+    (void)arg;
+}
+
+// Function to blur image with a Gaussian of standard deviation sigma, writing into a caller-supplied image
+// Recursive (Young - van Vliet) filter: the cost per pixel does not depend on sigma
+// Borders are replicated; dst must have the size of img and must not alias it
+bool BMP8GaussianBlurInto(BMP8Image* img, float sigma, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Blur Error: No image provided.\n");
+        return false;
+    }
+    if(!(sigma >= 0.5f)){
+        fprintf(stderr, "Blur Error: Gaussian sigma must be at least 0.5.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Blur Error: In-place blur is not supported.\n");
+        return false;
+    }
+
+    gaussianJob job = {0};
+    job.img = img;
+    job.dst = dst;
+    size_t pixels = (size_t)img->width * img->height;
+    job.across = malloc(pixels * sizeof(float));
+    job.down = malloc(pixels * sizeof(float));
+
+    // Phases and the range each of them splits into tasks
+    static const taskFunction phases[] = {gaussianTranspose, gaussianHorizontal, gaussianTransposeBack, gaussianVertical, gaussianStore};
+    int extents[] = {img->height, img->height, img->width, img->width, img->height};
+    int phaseCount = sizeof(phases) / sizeof(phases[0]);
+    int taskCount = 0;
+    for(int p = 0; p < phaseCount; p++){
+        taskCount += (extents[p] + GAUSSIAN_TASK - 1) / GAUSSIAN_TASK;
+    }
+    gaussianTask* tasks = malloc(taskCount * sizeof(gaussianTask));
+    taskGraph* graph = taskGraphCreate();
+
+    bool ok = job.across && job.down && tasks && graph && gaussianCoefficientsFor(sigma, &job.c);
+    int barrier = -1, next = 0;
+    for(int p = 0; ok && p < phaseCount; p++){
+        int phaseEnd = -1;
+        if(p + 1 < phaseCount){
+            phaseEnd = taskGraphAdd(graph, gaussianBarrier, NULL);
+            ok = phaseEnd >= 0;
+        }
+        for(int begin = 0; ok && begin < extents[p]; begin += GAUSSIAN_TASK){
+            gaussianTask* t = &tasks[next++];
+            t->job = &job;
+            t->begin = begin;
+            t->end = MIN(begin + GAUSSIAN_TASK, extents[p]);
+            int id = taskGraphAdd(graph, phases[p], t);
+            ok = id >= 0 && (barrier < 0 || taskGraphDepend(graph, id, barrier)) &&
+                 (phaseEnd < 0 || taskGraphDepend(graph, phaseEnd, id));
+        }
+        barrier = phaseEnd;
+    }
+    if(ok){
+        ok = taskGraphRun(graph, 0);
+    } else {
+        fprintf(stderr, "Memory allocation failed!\n");
+    }
+
+    taskGraphDestroy(graph);
+    free(tasks);
+    free(job.across);
+    free(job.down);
+    return ok;
+}
+
+// Function to blur image with a Gaussian of standard deviation sigma
+BMP8Image* BMP8GaussianBlur(BMP8Image* img, float sigma){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8GaussianBlurInto(img, sigma, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
+
+// Reference Gaussian blur: separable convolution with the sampled and normalized
+// kernel (radius 4 sigma), replicated borders and the same rounding as BMP8GaussianBlurInto
+static bool BMP8GaussianBlurExactInto(BMP8Image* img, float sigma, BMP8Image* dst){
+    int radius = (int)ceilf(4.0f * sigma);
+    mask* kernel = maskCreate(1, 2 * radius + 1);
+    float* tmp = malloc((size_t)img->width * img->height * sizeof(float));
+    if(!kernel || !kernel->data || !tmp || !BMP8CheckDestination(img, dst)){
+        free(tmp);
+        maskFree(kernel);
+        return false;
+    }
+    float sum = 0.0f;
+    for(int i = -radius; i <= radius; i++){
+        kernel->data[i + radius] = expf(-(float)(i * i) / (2.0f * sigma * sigma));
+        sum += kernel->data[i + radius];
+    }
+    for(int i = 0; i < 2 * radius + 1; i++){
+        kernel->data[i] /= sum;
+    }
+
+    int rowSize = (img->width + 3) & ~3;
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
+            float v = 0.0f;
+            for(int i = -radius; i <= radius; i++){
+                int xi = MIN(MAX(x + i, 0), img->width - 1);
+                v += kernel->data[i + radius] * img->data[y * rowSize + xi];
+            }
+            tmp[(size_t)y * img->width + x] = v;
+        }
+    }
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
+            float v = 0.5f;
+            for(int i = -radius; i <= radius; i++){
+                int yi = MIN(MAX(y + i, 0), img->height - 1);
+                v += kernel->data[i + radius] * tmp[(size_t)yi * img->width + x];
+            }
+            v = MIN(v, 255.0f);
+            v = MAX(v, 0.0f);
+            dst->data[y * rowSize + x] = (unsigned char)v;
+        }
+    }
+    free(tmp);
+    maskFree(kernel);
+    return true;
 }
 
 // Function to save BMP image to file
@@ -176,14 +648,151 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Function to free allocated memory
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        // free pixel data
-        free(img->data);
-        // free struct
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
         free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
     }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Function to blur a 24-bit image using averaging filter
+// All three channels are averaged in a single pass over the interleaved data
+BMP24Image* BMP24Blur(BMP24Image* img, unsigned int size) {
+    if (!img) {
+        fprintf(stderr, "Blur Error: No image provided.\n");
+        return NULL;
+    }
+
+    // Allocate memory for the new image
+    BMP24Image* blurredImg = malloc(sizeof(BMP24Image));
+    if(!blurredImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(blurredImg->header, img->header, BMP_HEADER_SIZE);
+    blurredImg->width = img->width;
+    blurredImg->height = img->height;
+    blurredImg->bitDepth = img->bitDepth;
+    blurredImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    blurredImg->data = malloc(img->rowSize * img->height);
+    if (!blurredImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(blurredImg);
+        return NULL;
+    }
+    // Copy original image data (so border pixels remain unchanged)
+    memcpy(blurredImg->data, img->data, img->rowSize * img->height);
+
+    // Convolution offset (half of kernel size)
+    int offset = size / 2;
+    // Equal weight of every kernel tap
+    float value = 1.0f / (size * size);
+
+    // Apply averaging filter (ignoring border pixels)
+    for (int y = offset; y < img->height - offset; y++) {
+        for (int x = offset; x < img->width - offset; x++) {
+            // Accumulators for blue, green and red
+            float sum[3] = {0.0f, 0.0f, 0.0f};
+
+            for (int j = -offset; j <= offset; j++) {
+                const unsigned char* row = img->data + (y + j) * img->rowSize;
+                for (int i = -offset; i <= offset; i++) {
+                    const unsigned char* px = row + (x + i) * 3;
+                    sum[0] += value * px[0];
+                    sum[1] += value * px[1];
+                    sum[2] += value * px[2];
+                }
+            }
+
+            // Clamp every channel to valid range [0, 255]
+            unsigned char* out = blurredImg->data + y * img->rowSize + x * 3;
+            for (int c = 0; c < 3; c++) {
+                if (sum[c] < 0) sum[c] = 0;
+                if (sum[c] > 255) sum[c] = 255;
+                out[c] = (unsigned char)sum[c];
+            }
+        }
+    }
+
+    return blurredImg;
+}
+
+// Current monotonic time in seconds
+static double secondsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
 
 int main(){
@@ -199,7 +808,55 @@ int main(){
         BMP8Free(blurred);
     }
 
+    // Gaussian blur: recursive filter against the exact sampled kernel
+    BMP8Image *gaussian = BMP8CreateLike(image);
+    BMP8Image *exact = BMP8CreateLike(image);
+    if (gaussian && exact) {
+        const float sigmas[] = {1.0f, 2.0f, 5.0f, 10.0f, 20.0f, 30.0f};
+        printf("sigma   recursive [ms]   exact [ms]   max diff   mean diff\n");
+        for (int i = 0; i < (int)(sizeof(sigmas) / sizeof(sigmas[0])); i++) {
+            double start = secondsNow();
+            bool done = BMP8GaussianBlurInto(image, sigmas[i], gaussian);
+            double recursiveTime = secondsNow() - start;
+            start = secondsNow();
+            done = done && BMP8GaussianBlurExactInto(image, sigmas[i], exact);
+            double exactTime = secondsNow() - start;
+            if (!done) {
+                continue;
+            }
+
+            int maxDiff = 0;
+            double totalDiff = 0.0;
+            int rowSize = (image->width + 3) & ~3;
+            for (int y = 0; y < image->height; y++) {
+                for (int x = 0; x < image->width; x++) {
+                    int d = abs(gaussian->data[y * rowSize + x] - exact->data[y * rowSize + x]);
+                    maxDiff = MAX(maxDiff, d);
+                    totalDiff += d;
+                }
+            }
+            printf("%5.1f   %14.2f   %10.2f   %8d   %9.4f\n", sigmas[i], recursiveTime * 1e3, exactTime * 1e3,
+                   maxDiff, totalDiff / ((double)image->width * image->height));
+
+            if (sigmas[i] == 5.0f) {
+                BMP8save("images/lizard_gaussian_sigma5.bmp", gaussian);
+            }
+        }
+    }
+    BMP8Free(gaussian);
+    BMP8Free(exact);
+
     BMP8Free(image);
 
+    // Blur a 24-bit color image with the same kernel
+    BMP24Image *image24 = BMP24Read("../Test_Images/lena_color.bmp");
+    BMP24Image *blurred24 = BMP24Blur(image24, 3);
+    if (blurred24) {
+        BMP24Save("images/lena_color_blurred_3x3.bmp", blurred24);
+        BMP24Free(blurred24);
+    }
+
+    BMP24Free(image24);
+
     return 0;
 }
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "taskgraph.h"
+
+// Arguments of one worker thread
+typedef struct {
+    taskGraph *graph;
+    int self;
+} workerContext;
+
+taskGraph* taskGraphCreate(void) {
+    // Allocate memory for graph structure
+    taskGraph* graph = calloc(1, sizeof(taskGraph));
+    if (!graph) {
+        fprintf(stderr, "Task Graph Error: Memory allocation failed!\n");
+        return NULL;
+    }
+    return graph;
+}
+
+int taskGraphAdd(taskGraph* graph, taskFunction fn, void* arg) {
+    if (!graph || !fn) {
+        return -1;
+    }
+
+    // Grow the task array if needed
+    if (graph->count == graph->capacity) {
+        int capacity = graph->capacity ? graph->capacity * 2 : 8;
+        task* tasks = realloc(graph->tasks, capacity * sizeof(task));
+        if (!tasks) {
+            fprintf(stderr, "Task Graph Error: Memory allocation failed!\n");
+            return -1;
+        }
+        graph->tasks = tasks;
+        graph->capacity = capacity;
+    }
+
+    task* t = &graph->tasks[graph->count];
+    t->fn = fn;
+    t->arg = arg;
+    t->dependents = NULL;
+    t->dependentCount = 0;
+    t->dependentCapacity = 0;
+    t->dependencyCount = 0;
+    atomic_init(&t->pending, 0);
+    return graph->count++;
+}
+
+bool taskGraphDepend(taskGraph* graph, int taskId, int dependsOn) {
+    if (!graph || taskId < 0 || taskId >= graph->count || dependsOn < 0 || dependsOn >= graph->count || taskId == dependsOn) {
+        fprintf(stderr, "Task Graph Error: Invalid dependency %d -> %d.\n", dependsOn, taskId);
+        return false;
+    }
+
+    // Record taskId as a dependent of dependsOn
+    task* before = &graph->tasks[dependsOn];
+    if (before->dependentCount == before->dependentCapacity) {
+        int capacity = before->dependentCapacity ? before->dependentCapacity * 2 : 4;
+        int* dependents = realloc(before->dependents, capacity * sizeof(int));
+        if (!dependents) {
+            fprintf(stderr, "Task Graph Error: Memory allocation failed!\n");
+            return false;
+        }
+        before->dependents = dependents;
+        before->dependentCapacity = capacity;
+    }
+    before->dependents[before->dependentCount++] = taskId;
+    graph->tasks[taskId].dependencyCount++;
+    return true;
+}
+
+// Check that the graph has no cycle (Kahn's algorithm on a scratch copy of the counts)
+static bool isAcyclic(taskGraph* graph) {
+    int* counts = malloc(graph->count * sizeof(int));
+    int* ready = malloc(graph->count * sizeof(int));
+    if (!counts || !ready) {
+        free(counts);
+        free(ready);
+        return false;
+    }
+
+    int readyCount = 0;
+    for (int i = 0; i < graph->count; i++) {
+        counts[i] = graph->tasks[i].dependencyCount;
+        if (counts[i] == 0) {
+            ready[readyCount++] = i;
+        }
+    }
+
+    int visited = 0;
+    while (readyCount > 0) {
+        task* t = &graph->tasks[ready[--readyCount]];
+        visited++;
+        for (int i = 0; i < t->dependentCount; i++) {
+            if (--counts[t->dependents[i]] == 0) {
+                ready[readyCount++] = t->dependents[i];
+            }
+        }
+    }
+
+    free(counts);
+    free(ready);
+    return visited == graph->count;
+}
+
+// Queue a ready task on the given worker and wake an idle one
+static void pushTask(taskGraph* graph, int worker, int id) {
+    taskDeque* deque = &graph->deques[worker];
+    pthread_mutex_lock(&deque->lock);
+    deque->items[deque->tail++] = id;
+    pthread_mutex_unlock(&deque->lock);
+
+    pthread_mutex_lock(&graph->lock);
+    graph->queued++;
+    pthread_cond_signal(&graph->wake);
+    pthread_mutex_unlock(&graph->lock);
+}
+
+// Take a task from the worker's own deque (newest) or steal one from another (oldest)
+static int takeTask(taskGraph* graph, int self) {
+    int id = -1;
+    for (int i = 0; i < graph->workerCount && id < 0; i++) {
+        int victim = (self + i) % graph->workerCount;
+        taskDeque* deque = &graph->deques[victim];
+        pthread_mutex_lock(&deque->lock);
+        if (deque->head < deque->tail) {
+            id = (victim == self) ? deque->items[--deque->tail] : deque->items[deque->head++];
+        }
+        pthread_mutex_unlock(&deque->lock);
+    }
+
+    if (id >= 0) {
+        pthread_mutex_lock(&graph->lock);
+        graph->queued--;
+        pthread_mutex_unlock(&graph->lock);
+    }
+    return id;
+}
+
+// Worker loop: run tasks until every task of the graph has finished
+static void* workerMain(void* arg) {
+    workerContext* context = arg;
+    taskGraph* graph = context->graph;
+    int self = context->self;
+
+    for (;;) {
+        int id = takeTask(graph, self);
+        if (id < 0) {
+            // Nothing to take: sleep until work is queued or the run ends
+            pthread_mutex_lock(&graph->lock);
+            while (graph->queued == 0 && graph->remaining > 0) {
+                pthread_cond_wait(&graph->wake, &graph->lock);
+            }
+            bool done = graph->remaining == 0;
+            pthread_mutex_unlock(&graph->lock);
+            if (done) {
+                break;
+            }
+            continue;
+        }
+
+        task* t = &graph->tasks[id];
+        t->fn(t->arg);
+
+        // Release dependents; the last finished dependency queues them locally
+        for (int i = 0; i < t->dependentCount; i++) {
+            int dependent = t->dependents[i];
+            if (atomic_fetch_sub(&graph->tasks[dependent].pending, 1) == 1) {
+                pushTask(graph, self, dependent);
+            }
+        }
+
+        pthread_mutex_lock(&graph->lock);
+        if (--graph->remaining == 0) {
+            pthread_cond_broadcast(&graph->wake);
+        }
+        pthread_mutex_unlock(&graph->lock);
+    }
+    return NULL;
+}
+
+bool taskGraphRun(taskGraph* graph, int threads) {
+    if (!graph) {
+        return false;
+    }
+    if (graph->count == 0) {
+        return true;
+    }
+    if (!isAcyclic(graph)) {
+        fprintf(stderr, "Task Graph Error: Graph contains a cycle.\n");
+        return false;
+    }
+
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > graph->count) {
+        threads = graph->count;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    // Every task is queued at most once per run, so each deque holds at most count items
+    graph->workerCount = threads;
+    graph->deques = calloc(threads, sizeof(taskDeque));
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    workerContext* contexts = malloc(threads * sizeof(workerContext));
+    bool ok = graph->deques && workers && contexts;
+    // Deques whose lock is initialized, so cleanup after a failed allocation destroys only those
+    int ready = 0;
+    while (ok && ready < threads) {
+        graph->deques[ready].items = malloc(graph->count * sizeof(int));
+        ok = graph->deques[ready].items != NULL;
+        if (ok) {
+            pthread_mutex_init(&graph->deques[ready].lock, NULL);
+            ready++;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "Task Graph Error: Memory allocation failed!\n");
+    }
+
+    if (ok) {
+        pthread_mutex_init(&graph->lock, NULL);
+        pthread_cond_init(&graph->wake, NULL);
+        graph->remaining = graph->count;
+        graph->queued = 0;
+
+        // Spread the initially ready tasks round-robin over the workers
+        int next = 0;
+        for (int i = 0; i < graph->count; i++) {
+            atomic_store(&graph->tasks[i].pending, graph->tasks[i].dependencyCount);
+        }
+        for (int i = 0; i < graph->count; i++) {
+            if (graph->tasks[i].dependencyCount == 0) {
+                taskDeque* deque = &graph->deques[next];
+                deque->items[deque->tail++] = i;
+                graph->queued++;
+                next = (next + 1) % threads;
+            }
+        }
+
+        // The calling thread is worker 0
+        int started = 1;
+        for (int i = 0; i < threads; i++) {
+            contexts[i].graph = graph;
+            contexts[i].self = i;
+        }
+        for (int i = 1; i < threads; i++) {
+            if (pthread_create(&workers[i], NULL, workerMain, &contexts[i]) != 0) {
+                fprintf(stderr, "Task Graph Error: Could not start worker %d.\n", i);
+                break;
+            }
+            started++;
+        }
+        // Workers that failed to start simply leave their deques to be stolen from
+        workerMain(&contexts[0]);
+        for (int i = 1; i < started; i++) {
+            pthread_join(workers[i], NULL);
+        }
+
+        pthread_cond_destroy(&graph->wake);
+        pthread_mutex_destroy(&graph->lock);
+    }
+
+    for (int i = 0; i < ready; i++) {
+        free(graph->deques[i].items);
+        pthread_mutex_destroy(&graph->deques[i].lock);
+    }
+    free(graph->deques);
+    graph->deques = NULL;
+    free(workers);
+    free(contexts);
+    return ok;
+}
+
+void taskGraphDestroy(taskGraph* graph) {
+    if (graph) {
+        for (int i = 0; i < graph->count; i++) {
+            free(graph->tasks[i].dependents);
+        }
+        free(graph->tasks);
+        // Free graph structure itself
+        free(graph);
+    }
+}
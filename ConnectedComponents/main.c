@@ -0,0 +1,520 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// Define BMP header size
+#define BMP_HEADER_SIZE 54
+// Size of color table for 8-bit BMP
+#define BMP_COLOR_TABLE_SIZE 1024
+// Maximum value of a pixel
+#define MAX_BRIGHTNESS 255
+// Minimum value of a pixel
+#define MIN_BRIGHTNESS 0
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
+#define MAX(a, b) ((a) > (b) ? (a) : (b))   // returns the larger of (a) and (b)
+
+// Rows labeled independently by one thread (even, so strips hold whole 2x2 blocks)
+#define CCL_STRIP 64
+
+// Structure to hold 8-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
+    unsigned char colorTable[BMP_COLOR_TABLE_SIZE]; // Color table for 8-bit BMP (256 * 4 bytes)
+    unsigned char *data;                            // Pointer to pixel data
+    int width;                                      // Image width in pixels
+    int height;                                     // Image height in pixels
+    int bitDepth;                                   // Bits per pixel (8 for grayscale)
+    int imgSize;                                    // Total size of pixel data in bytes
+} BMP8Image;
+
+// Function to read an 8-bit BMP image from a file
+BMP8Image* BMP8read(const char* filename) {
+    // open file
+    FILE *fInput = fopen(filename, "rb");
+    if (!fInput) {
+        fprintf(stderr, "Unable to open file %s!\n", filename);
+        return NULL;
+    }
+
+    // allocate struct
+    BMP8Image *img = (BMP8Image*)malloc(sizeof(BMP8Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(fInput);
+        return NULL;
+    }
+
+    // Read header (54 bytes)
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, fInput);
+
+    // Extract metadata from header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Compute padded row size and image size
+    int rowSize = (img->width + 3) & ~3;
+    img->imgSize = rowSize * img->height;
+
+    // Read color table (only for 8-bit BMP)
+    if (img->bitDepth <= 8) {
+        fread(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fInput);
+    }
+
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->imgSize);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(fInput);
+        return NULL;
+    }
+
+    // Read pixel data
+    fread(img->data, sizeof(unsigned char), img->imgSize, fInput);
+
+    fclose(fInput);
+    return img;
+}
+
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
+        return NULL;
+    }
+
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
+
+    // Copy color table if grayscale (8-bit)
+    if (img->bitDepth <= 8) {
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    }
+
+    // Compute padded row size and total image size
+    int rowSize = (img->width + 3) & ~3;
+    newImg->imgSize = rowSize * img->height;
+
+    // Allocate memory for pixel data
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(newImg);
+        return NULL;
+    }
+    return newImg;
+}
+
+// Function to save an 8-bit BMP image to a file
+void BMP8save(const char* filename, BMP8Image* img) {
+    FILE *fOutput = fopen(filename, "wb");
+    if (!fOutput) {
+        fprintf(stderr, "Unable to create file %s!\n", filename);
+        return;
+    }
+
+    fwrite(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, fOutput);
+
+    if (img->bitDepth <= 8) {
+        fwrite(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fOutput);
+    }
+
+    fwrite(img->data, sizeof(unsigned char), img->imgSize, fOutput);
+
+    fclose(fOutput);
+}
+
+// Statistics of one connected component
+typedef struct {
+    int area;                   // number of pixels
+    int minX, minY;             // bounding box, inclusive
+    int maxX, maxY;
+    double centroidX;           // mean pixel position
+    double centroidY;
+} componentStats;
+
+// Result of connected-component labeling
+typedef struct {
+    int *labels;                // width * height, row by row: 0 for background, 1..count
+    int width;
+    int height;
+    int count;                  // number of components
+    componentStats *stats;      // stats[l - 1] describes label l
+} componentLabels;
+
+// Sums gathered for a provisional label during the first scan
+typedef struct {
+    long long sumX, sumY;
+    int area;
+    int minX, minY, maxX, maxY;
+} componentSums;
+
+// Root of label l, compressing the path behind it; roots are the smallest label of
+// their set, so every parent is smaller than its child
+static int cclFind(int* parent, int l){
+    int root = l;
+    while(parent[root] != root){
+        root = parent[root];
+    }
+    while(parent[l] != root){
+        int next = parent[l];
+        parent[l] = root;
+        l = next;
+    }
+    return root;
+}
+
+// Merge the sets of a and b; returns the new root
+static int cclUnion(int* parent, int a, int b){
+    a = cclFind(parent, a);
+    b = cclFind(parent, b);
+    if(a < b){
+        parent[b] = a;
+        return a;
+    }
+    parent[a] = b;
+    return b;
+}
+
+// Foreground test with everything outside the image as background
+static inline bool cclForeground(const BMP8Image* img, int rowSize, int x, int y){
+    return x >= 0 && y >= 0 && x < img->width && y < img->height && img->data[(size_t)y * rowSize + x];
+}
+
+// Merge block (bx, by) with its 8-connected neighbors in the block row above
+// Pixels a b / c d of the block touch the row above through a and b only
+static int cclMergeAbove(const BMP8Image* img, int rowSize, const int* blockLabels, int blocksX,
+                         int bx, int by, int label, int* parent){
+    int x = 2 * bx, y = 2 * by;
+    bool a = cclForeground(img, rowSize, x, y), b = cclForeground(img, rowSize, x + 1, y);
+    const int* above = blockLabels + (size_t)(by - 1) * blocksX;
+    int candidates[3] = {
+        bx > 0 && a && cclForeground(img, rowSize, x - 1, y - 1) ? above[bx - 1] : 0,
+        (a || b) && (cclForeground(img, rowSize, x, y - 1) || cclForeground(img, rowSize, x + 1, y - 1)) ? above[bx] : 0,
+        bx + 1 < blocksX && b && cclForeground(img, rowSize, x + 2, y - 1) ? above[bx + 1] : 0,
+    };
+    for(int i = 0; i < 3; i++){
+        if(candidates[i]){
+            label = label ? cclUnion(parent, label, candidates[i]) : candidates[i];
+        }
+    }
+    return label;
+}
+
+// Label the 8-connected components of the nonzero pixels of img and measure them.
+// Block-based two-pass algorithm: the first scan labels 2x2 blocks (all foreground
+// pixels of a block are connected) and records equivalences in a union-find forest,
+// accumulating each provisional label's area, coordinate sums and bounding box on the
+// way. Strips of rows are scanned in parallel with disjoint label ranges, then the
+// strip boundaries are merged, labels are renumbered 1..count, and the second scan
+// writes the label map.
+componentLabels* BMP8LabelComponents(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Labeling Error: No image provided.\n");
+        return NULL;
+    }
+    int rowSize = (img->width + 3) & ~3;
+    int blocksX = (img->width + 1) / 2, blocksY = (img->height + 1) / 2;
+    int stripBlocks = CCL_STRIP / 2;
+    int strips = (blocksY + stripBlocks - 1) / stripBlocks;
+    size_t blocks = (size_t)blocksX * blocksY;
+
+    // A block opens at most one label, so strip s can use labels from
+    // 1 + (first block of the strip) without coordinating with the others
+    componentLabels* result = calloc(1, sizeof(componentLabels));
+    int* blockLabels = malloc(blocks * sizeof(int));
+    int* parent = malloc((blocks + 1) * sizeof(int));
+    componentSums* sums = malloc((blocks + 1) * sizeof(componentSums));
+    int* nextLabel = malloc((size_t)strips * sizeof(int));
+    if(result){
+        result->labels = calloc((size_t)img->width * img->height, sizeof(int));
+    }
+    if(!result || !result->labels || !blockLabels || !parent || !sums || !nextLabel){
+        fprintf(stderr, "Memory allocation failed!\n");
+        if(result){
+            free(result->labels);
+        }
+        free(result);
+        free(blockLabels);
+        free(parent);
+        free(sums);
+        free(nextLabel);
+        return NULL;
+    }
+    result->width = img->width;
+    result->height = img->height;
+
+    // First scan, strip by strip
+    #pragma omp parallel for schedule(dynamic)
+    for(int s = 0; s < strips; s++){
+        int by0 = s * stripBlocks, by1 = MIN(by0 + stripBlocks, blocksY);
+        int next = 1 + by0 * blocksX;
+        for(int by = by0; by < by1; by++){
+            int y = 2 * by;
+            int* row = blockLabels + (size_t)by * blocksX;
+            for(int bx = 0; bx < blocksX; bx++){
+                int x = 2 * bx;
+                bool a = cclForeground(img, rowSize, x, y), b = cclForeground(img, rowSize, x + 1, y);
+                bool c = cclForeground(img, rowSize, x, y + 1), d = cclForeground(img, rowSize, x + 1, y + 1);
+                if(!(a || b || c || d)){
+                    row[bx] = 0;
+                    continue;
+                }
+
+                // Left block, through its right column
+                int label = bx > 0 && (a || c) && (cclForeground(img, rowSize, x - 1, y) || cclForeground(img, rowSize, x - 1, y + 1))
+                          ? row[bx - 1] : 0;
+                if(by > by0){
+                    label = cclMergeAbove(img, rowSize, blockLabels, blocksX, bx, by, label, parent);
+                }
+                if(!label){
+                    label = next++;
+                    parent[label] = label;
+                    sums[label] = (componentSums){0, 0, 0, img->width, img->height, -1, -1};
+                }
+                row[bx] = label;
+
+                // Statistics of the block's pixels go to its provisional label
+                componentSums* sum = &sums[label];
+                bool pixels[4] = {a, b, c, d};
+                for(int i = 0; i < 4; i++){
+                    if(pixels[i]){
+                        int px = x + (i & 1), py = y + (i >> 1);
+                        sum->area++;
+                        sum->sumX += px;
+                        sum->sumY += py;
+                        sum->minX = MIN(sum->minX, px);
+                        sum->minY = MIN(sum->minY, py);
+                        sum->maxX = MAX(sum->maxX, px);
+                        sum->maxY = MAX(sum->maxY, py);
+                    }
+                }
+            }
+        }
+        nextLabel[s] = next;
+    }
+
+    // Join components across strip boundaries
+    for(int s = 1; s < strips; s++){
+        int by = s * stripBlocks;
+        for(int bx = 0; bx < blocksX; bx++){
+            int label = blockLabels[(size_t)by * blocksX + bx];
+            if(label){
+                cclMergeAbove(img, rowSize, blockLabels, blocksX, bx, by, label, parent);
+            }
+        }
+    }
+
+    // Renumber: labels are visited in increasing order and every parent is smaller
+    // than its child, so parent[parent[l]] already holds the final label of l's set
+    int count = 0;
+    for(int s = 0; s < strips; s++){
+        for(int l = 1 + s * stripBlocks * blocksX; l < nextLabel[s]; l++){
+            parent[l] = parent[l] < l ? parent[parent[l]] : ++count;
+        }
+    }
+    result->count = count;
+    result->stats = calloc(MAX(count, 1), sizeof(componentStats));
+    if(!result->stats){
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(result->labels);
+        free(result);
+        result = NULL;
+    } else {
+        // Fold the provisional sums into their components
+        for(int i = 0; i < count; i++){
+            result->stats[i] = (componentStats){0, img->width, img->height, -1, -1, 0.0, 0.0};
+        }
+        for(int s = 0; s < strips; s++){
+            for(int l = 1 + s * stripBlocks * blocksX; l < nextLabel[s]; l++){
+                componentStats* st = &result->stats[parent[l] - 1];
+                st->area += sums[l].area;
+                st->centroidX += sums[l].sumX;
+                st->centroidY += sums[l].sumY;
+                st->minX = MIN(st->minX, sums[l].minX);
+                st->minY = MIN(st->minY, sums[l].minY);
+                st->maxX = MAX(st->maxX, sums[l].maxX);
+                st->maxY = MAX(st->maxY, sums[l].maxY);
+            }
+        }
+        for(int i = 0; i < count; i++){
+            result->stats[i].centroidX /= result->stats[i].area;
+            result->stats[i].centroidY /= result->stats[i].area;
+        }
+
+        // Second scan: final labels of the foreground pixels
+        #pragma omp parallel for schedule(dynamic)
+        for(int s = 0; s < strips; s++){
+            int by0 = s * stripBlocks, by1 = MIN(by0 + stripBlocks, blocksY);
+            for(int y = 2 * by0; y < MIN(2 * by1, img->height); y++){
+                const int* row = blockLabels + (size_t)(y / 2) * blocksX;
+                const unsigned char* src = img->data + (size_t)y * rowSize;
+                int* out = result->labels + (size_t)y * img->width;
+                for(int x = 0; x < img->width; x++){
+                    out[x] = src[x] ? parent[row[x / 2]] : 0;
+                }
+            }
+        }
+    }
+
+    free(blockLabels);
+    free(parent);
+    free(sums);
+    free(nextLabel);
+    return result;
+}
+
+// Free a labeling result
+void componentLabelsFree(componentLabels* labels){
+    if(labels){
+        free(labels->labels);
+        free(labels->stats);
+        free(labels);
+    }
+}
+
+// Draw a label map as an 8-bit image (header taken from template, which must have
+// the same size) with a color table of distinct colors; background stays black
+BMP8Image* componentLabelsToBMP8(componentLabels* labels, BMP8Image* template){
+    if(!labels || !template || labels->width != template->width || labels->height != template->height){
+        fprintf(stderr, "Labeling Error: Label map and template sizes differ.\n");
+        return NULL;
+    }
+    BMP8Image* img = BMP8CreateLike(template);
+    if(!img){
+        return NULL;
+    }
+    img->bitDepth = 8;
+    memset(img->colorTable, 0, BMP_COLOR_TABLE_SIZE);
+    for(int i = 1; i < 256; i++){
+        // Colors spread by multiplicative hashing, kept away from black
+        unsigned int h = (unsigned int)i * 2654435761u;
+        img->colorTable[4 * i + 0] = (unsigned char)(64 + (h >> 8) % 192);
+        img->colorTable[4 * i + 1] = (unsigned char)(64 + (h >> 16) % 192);
+        img->colorTable[4 * i + 2] = (unsigned char)(64 + (h >> 24) % 192);
+    }
+    int rowSize = (img->width + 3) & ~3;
+    memset(img->data, 0, img->imgSize);
+    for(int y = 0; y < img->height; y++){
+        const int* row = labels->labels + (size_t)y * labels->width;
+        unsigned char* out = img->data + (size_t)y * rowSize;
+        for(int x = 0; x < img->width; x++){
+            out[x] = row[x] ? (unsigned char)((row[x] - 1) % 255 + 1) : 0;
+        }
+    }
+    return img;
+}
+
+// Current monotonic time in seconds
+static double secondsNow(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Foreground mask of the pixels whose gray level (through the color table) is
+// darker than threshold, or brighter when dark is false
+BMP8Image* BMP8ForegroundMask(BMP8Image* img, int threshold, bool dark){
+    BMP8Image* mask = BMP8CreateLike(img);
+    if(!mask){
+        return NULL;
+    }
+    for(int i = 0; i < BMP_COLOR_TABLE_SIZE / 4; i++){
+        mask->colorTable[4 * i + 0] = mask->colorTable[4 * i + 1] = mask->colorTable[4 * i + 2] = (unsigned char)i;
+    }
+    for(int i = 0; i < img->imgSize; i++){
+        int gray = img->colorTable[4 * img->data[i]];
+        mask->data[i] = (dark ? gray < threshold : gray > threshold) ? MAX_BRIGHTNESS : MIN_BRIGHTNESS;
+    }
+    return mask;
+}
+
+int main(){
+    // Dark blobs on a light background; the pixels are indices into the color table
+    BMP8Image* image = BMP8read("../Test_Images/blobs.bmp");
+    if(!image){
+        return 1;
+    }
+    BMP8Image* mask = BMP8ForegroundMask(image, 128, true);
+    if(!mask){
+        BMP8Free(image);
+        return 1;
+    }
+
+    double start = secondsNow();
+    componentLabels* labels = BMP8LabelComponents(mask);
+    double elapsed = secondsNow() - start;
+    if(labels){
+        printf("blobs.bmp: %d components labeled in %.2f ms\n", labels->count, elapsed * 1e3);
+
+        // The five largest components
+        int order[5] = {-1, -1, -1, -1, -1};
+        for(int i = 0; i < labels->count; i++){
+            int k = i;
+            for(int j = 0; j < 5; j++){
+                if(order[j] < 0 || labels->stats[k].area > labels->stats[order[j]].area){
+                    int swap = order[j];
+                    order[j] = k;
+                    k = swap;
+                    if(k < 0){
+                        break;
+                    }
+                }
+            }
+        }
+        printf("%6s %7s %21s %17s\n", "label", "area", "bounding box", "centroid");
+        for(int j = 0; j < 5 && order[j] >= 0; j++){
+            componentStats* st = &labels->stats[order[j]];
+            printf("%6d %7d   (%3d,%3d)-(%3d,%3d)   (%6.1f,%6.1f)\n", order[j] + 1, st->area,
+                   st->minX, st->minY, st->maxX, st->maxY, st->centroidX, st->centroidY);
+        }
+
+        BMP8Image* colored = componentLabelsToBMP8(labels, mask);
+        if(colored){
+            BMP8save("images/blobs_components.bmp", colored);
+            BMP8Free(colored);
+        }
+        componentLabelsFree(labels);
+    }
+    BMP8Free(mask);
+    BMP8Free(image);
+
+    // Larger input: bright regions of the lizard
+    image = BMP8read("../Test_Images/lizard_greyscale8bit.bmp");
+    mask = image ? BMP8ForegroundMask(image, 150, false) : NULL;
+    if(mask){
+        start = secondsNow();
+        labels = BMP8LabelComponents(mask);
+        elapsed = secondsNow() - start;
+        if(labels){
+            printf("lizard, threshold 150: %d components labeled in %.2f ms\n", labels->count, elapsed * 1e3);
+            componentLabelsFree(labels);
+        }
+    }
+    BMP8Free(mask);
+    BMP8Free(image);
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Single precision complex number.
+ */
+typedef struct {
+    float re;   /// real part
+    float im;   /// imaginary part
+} complexf;
+
+/**
+ * @brief Precomputed tables for transforms of one size.
+ *
+ * Plans are created on first use and cached for the lifetime of the
+ * program; they are shared and must not be freed by callers.
+ */
+typedef struct fftPlan {
+    int n;                  /// transform length (power of two)
+    int log2n;              /// log2 of n
+    complexf *twiddle;      /// exp(-2*pi*i*k/n) for k < n/2
+    int *bitReverse;        /// bit-reversed index of every position
+    struct fftPlan *next;   /// next cached plan
+} fftPlan;
+
+/**
+ * @brief Smallest power of two greater than or equal to n.
+ */
+int fftNextPowerOfTwo(int n);
+
+/**
+ * @brief Get the cached plan for length n, creating it on first use.
+ *
+ * Safe to call from several threads.
+ *
+ * @param n Transform length; must be a power of two.
+ * @return Shared plan, or NULL if n is not a power of two or allocation fails.
+ */
+const fftPlan* fftPlanGet(int n);
+
+/**
+ * @brief In-place radix-2 transform of n = plan->n elements.
+ *
+ * The inverse transform is not scaled by 1/n.
+ *
+ * @param plan Plan of the transform length.
+ * @param data Elements to transform.
+ * @param inverse false for the forward, true for the inverse transform.
+ */
+void fftTransform(const fftPlan* plan, complexf* data, bool inverse);
+
+/**
+ * @brief In-place 2D transform of a rows x cols row-major array.
+ *
+ * The inverse transform is scaled by 1/(rows*cols), so a forward
+ * transform followed by an inverse one restores the input.
+ *
+ * @param data Elements to transform.
+ * @param rows Number of rows (power of two).
+ * @param cols Number of columns (power of two).
+ * @param inverse false for the forward, true for the inverse transform.
+ * @return false if a plan or the scratch buffer cannot be allocated.
+ */
+bool fft2D(complexf* data, int rows, int cols, bool inverse);
+
+/**
+ * @brief Free every cached plan. No plan may be in use.
+ */
+void fftPlanCacheClear(void);
+
+#endif // FFT_H
@@ -2,7 +2,15 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <math.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "mask.h"
+#include "kernels.h"
+#include "trace.h"
+#include "fft.h"
 
 // Define BMP header size
 #define BMP_HEADER_SIZE 54
@@ -28,9 +36,21 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
 
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
+    traceSpan span = traceBegin("BMP8read");
+
     // open file
     FILE *fInput = fopen(filename, "rb");
     if (!fInput) {
@@ -76,53 +96,200 @@ BMP8Image* BMP8read(const char* filename) {
     fread(img->data, sizeof(unsigned char), img->imgSize, fInput);
 
     fclose(fInput);
+    span.bytesRead = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + img->imgSize;
+    span.pixels = (size_t)img->width * img->height;
+    span.allocations = 2;
+    traceEnd(&span);
     return img;
 }
 
-// Function to apply convolution with a given mask to an 8-bit BMP image
-BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
-    if(!img || !m){
-        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
     // Allocate memory for new image
-    BMP8Image* convImg = malloc(sizeof(BMP8Image));
-    if(!convImg){
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
     // Copy BMP header and metadata
-    memcpy(convImg->header, img->header, BMP_HEADER_SIZE);
-    convImg->width = img->width;
-    convImg->height = img->height;
-    convImg->bitDepth = img->bitDepth;
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
     // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(convImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
     // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    convImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
-    // Allocate memory for pixel data of the result
-    convImg->data = malloc(convImg->imgSize);
-    if (!convImg->data) {
+    // Allocate memory for pixel data
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(convImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Copy the coefficients of m into taps when all of them are whole numbers
+// Returns the sum of their magnitudes, or -1 when the mask needs the float path
+// (fractional coefficients, or sums too large to stay exact in float)
+static int maskIntegerTaps(mask* m, int* taps){
+    int absSum = 0;
+    for(unsigned int i = 0; i < m->rows * m->cols; i++){
+        float c = m->data[i];
+        if(c > 65535.0f || c < -65535.0f || c != (float)(int)c){
+            return -1;
+        }
+        taps[i] = (int)c;
+        absSum += abs(taps[i]);
+        // Float accumulation is exact below 2^24
+        if((long)absSum * MAX_BRIGHTNESS >= (1L << 24)){
+            return -1;
+        }
+    }
+    return absSum;
+}
+
+// Integer convolution of one pixel; taps outside the image are skipped (zero padding)
+static unsigned char convolveIntegerPixel(BMP8Image* img, int rowSize, const int* taps, int rows, int cols, int x, int y){
+    int val = 0;
+    for(int i = 0; i < rows; i++){
+        int idy = y + (i - rows / 2);
+        if(idy < 0 || idy >= img->height){
+            continue;
+        }
+        for(int j = 0; j < cols; j++){
+            int idx = x + (j - cols / 2);
+            if(idx >= 0 && idx < img->width){
+                val += taps[i * cols + j] * img->data[idy * rowSize + idx];
+            }
+        }
+    }
+    return (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+}
+
+// Convolution with integer taps, pixel for pixel equal to the float path
+// Where the whole mask is inside the image, sums use 16-bit lanes with a saturating
+// pack when they fit (absSum * 255 <= 32767) and 32-bit scalar accumulation otherwise
+// row, when given, is an unrolled kernel for this mask size or these coefficients
+static void BMP8ConvolutionInteger(BMP8Image* img, const int* taps, int rows, int cols, int absSum, kernelRow row, BMP8Image* dst){
+    int rowSize = (img->width + 3) & ~3;
+    int iCenter = rows / 2;
+    int jCenter = cols / 2;
+
+    // Rows and columns where every tap lies inside the image
+    int yBegin = iCenter, yEnd = img->height - (rows - 1 - iCenter);
+    int xBegin = jCenter, xEnd = img->width - (cols - 1 - jCenter);
+
+    for(int y = 0; y < img->height; y++){
+        unsigned char* out = dst->data + (size_t)y * rowSize;
+        if(y < yBegin || y >= yEnd || xBegin >= xEnd){
+            for(int x = 0; x < img->width; x++){
+                out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+            }
+            continue;
+        }
+
+        for(int x = 0; x < xBegin; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+        int x = xBegin;
+        if(row){
+            row(img->data + (size_t)(y - iCenter) * rowSize, rowSize, x, xEnd, out, taps, absSum * MAX_BRIGHTNESS <= 32767);
+            x = xEnd;
+        }
+#ifdef __SSE2__
+        // Vector path: 8 pixels per iteration, twice the lanes of a float kernel
+        if(absSum * MAX_BRIGHTNESS <= 32767){
+            const __m128i zero = _mm_setzero_si128();
+            for(; x + 8 <= xEnd; x += 8){
+                __m128i acc = zero;
+                for(int i = 0; i < rows; i++){
+                    const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                    for(int j = 0; j < cols; j++){
+                        int c = taps[i * cols + j];
+                        if(c != 0){
+                            __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + j)), zero);
+                            acc = _mm_add_epi16(acc, _mm_mullo_epi16(px, _mm_set1_epi16((short)c)));
+                        }
+                    }
+                }
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(acc, acc));
+            }
+        }
+#endif
+        // Scalar path (and tail): no bounds checks inside the image
+        for(; x < xEnd; x++){
+            int val = 0;
+            for(int i = 0; i < rows; i++){
+                const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                for(int j = 0; j < cols; j++){
+                    val += taps[i * cols + j] * src[j];
+                }
+            }
+            out[x] = (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+        }
+        for(; x < img->width; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+    }
+}
+
+// Direct convolution in float: every output pixel sums rows * cols products
+static void BMP8ConvolutionDirect(BMP8Image* img, mask* m, BMP8Image* dst){
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
 
     // Compute center of the mask (for correct alignment during convolution)
     int iCenter = m->rows / 2;
     int jCenter = m->cols / 2;
 
     // Iterate through every pixel in the image
-    for(int y = 0; y < convImg->height; y++){
-        for(int x = 0; x < convImg->width; x++){
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
             float val = 0.0f;
 
             // Apply convolution mask
@@ -134,7 +301,7 @@ BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
                     // Check if neighbor is inside image bounds
                     if(idx >= 0 && idx < img->width && idy >= 0 && idy < img->height){
                         float ms = m->data[i * m->cols + j];       // mask coefficient
-                        float im = img->data[idy * img->width + idx]; // image pixel value
+                        float im = img->data[idy * rowSize + idx]; // image pixel value
                         val += ms * im;
                     }
                 }
@@ -145,15 +312,292 @@ BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
             val = MAX(val, MIN_BRIGHTNESS);
 
             // Store result pixel
-            convImg->data[y * convImg->width + x] = (unsigned char)val;
+            dst->data[y * rowSize + x] = (unsigned char)val;
         }
     }
+}
 
-    return convImg;
+// Pick FFT tile sizes (powers of two) with the least transform work for the whole
+// image; returns that work in units of n*log2(n) for one transform of n points
+static double fftConvolutionWork(int width, int height, int rows, int cols, int* fftRows, int* fftCols){
+    double best = -1.0;
+    for(int nr = fftNextPowerOfTwo(rows); nr <= fftNextPowerOfTwo(height + rows - 1); nr *= 2){
+        for(int nc = fftNextPowerOfTwo(cols); nc <= fftNextPowerOfTwo(width + cols - 1); nc *= 2){
+            // Every tile yields (n - mask + 1) new output rows/columns
+            long tiles = (long)((height + nr - rows) / (nr - rows + 1)) * ((width + nc - cols) / (nc - cols + 1));
+            // Tiles are transformed in pairs, each pair forward and back
+            double work = (tiles + 1) / 2 * 2.0 * nr * nc * log2((double)nr * nc);
+            if(best < 0 || work < best){
+                best = work;
+                *fftRows = nr;
+                *fftCols = nc;
+            }
+        }
+    }
+    return best;
+}
+
+// Convolution through the FFT with overlap-add tiling; two real tiles share one
+// complex transform, one in the real and one in the imaginary part
+// Matches the direct float path up to rounding: pixels may differ by 1
+static bool BMP8ConvolutionFFT(BMP8Image* img, mask* m, BMP8Image* dst){
+    traceSpan span = traceBegin("BMP8ConvolutionFFT");
+    int rows = m->rows, cols = m->cols;
+    int nr = 0, nc = 0;
+    fftConvolutionWork(img->width, img->height, rows, cols, &nr, &nc);
+    int tileH = nr - rows + 1, tileW = nc - cols + 1;
+    int tilesX = (img->width + tileW - 1) / tileW;
+    int tiles = ((img->height + tileH - 1) / tileH) * tilesX;
+    int accW = img->width + cols - 1, accH = img->height + rows - 1;
+    int rowSize = (img->width + 3) & ~3;
+    size_t n = (size_t)nr * nc;
+
+    complexf* kernel = calloc(n, sizeof(complexf));
+    complexf* work = malloc(n * sizeof(complexf));
+    float* acc = calloc((size_t)accW * accH, sizeof(float));
+    bool ok = kernel && work && acc;
+
+    // Spectrum of the flipped mask: the direct path correlates rather than convolves
+    if(ok){
+        for(int i = 0; i < rows; i++){
+            for(int j = 0; j < cols; j++){
+                kernel[(size_t)(rows - 1 - i) * nc + (cols - 1 - j)].re = m->data[i * cols + j];
+            }
+        }
+        ok = fft2D(kernel, nr, nc, false);
+    }
+
+    for(int t = 0; ok && t < tiles; t += 2){
+        memset(work, 0, n * sizeof(complexf));
+        for(int k = 0; k < 2 && t + k < tiles; k++){
+            int y0 = (t + k) / tilesX * tileH, x0 = (t + k) % tilesX * tileW;
+            int h = MIN(tileH, img->height - y0), w = MIN(tileW, img->width - x0);
+            for(int y = 0; y < h; y++){
+                for(int x = 0; x < w; x++){
+                    float v = img->data[(y0 + y) * rowSize + x0 + x];
+                    if(k == 0){
+                        work[(size_t)y * nc + x].re = v;
+                    } else {
+                        work[(size_t)y * nc + x].im = v;
+                    }
+                }
+            }
+        }
+
+        ok = fft2D(work, nr, nc, false);
+        for(size_t i = 0; ok && i < n; i++){
+            complexf a = work[i], b = kernel[i];
+            work[i].re = a.re * b.re - a.im * b.im;
+            work[i].im = a.re * b.im + a.im * b.re;
+        }
+        ok = ok && fft2D(work, nr, nc, true);
+
+        // Overlap-add both full convolutions (tile + mask - 1 in each direction)
+        for(int k = 0; ok && k < 2 && t + k < tiles; k++){
+            int y0 = (t + k) / tilesX * tileH, x0 = (t + k) % tilesX * tileW;
+            int h = MIN(tileH, img->height - y0) + rows - 1, w = MIN(tileW, img->width - x0) + cols - 1;
+            for(int y = 0; y < h; y++){
+                float* row = acc + (size_t)(y0 + y) * accW + x0;
+                for(int x = 0; x < w; x++){
+                    row[x] += k == 0 ? work[(size_t)y * nc + x].re : work[(size_t)y * nc + x].im;
+                }
+            }
+        }
+    }
+
+    // Output (x, y) is element (x + cols - 1 - jCenter, y + rows - 1 - iCenter) of the full convolution
+    if(ok){
+        int yOffset = rows - 1 - rows / 2, xOffset = cols - 1 - cols / 2;
+        for(int y = 0; y < img->height; y++){
+            for(int x = 0; x < img->width; x++){
+                float val = acc[(size_t)(y + yOffset) * accW + x + xOffset];
+                val = MIN(val, MAX_BRIGHTNESS);
+                val = MAX(val, MIN_BRIGHTNESS);
+                dst->data[y * rowSize + x] = (unsigned char)val;
+            }
+        }
+    }
+
+    free(kernel);
+    free(work);
+    free(acc);
+    span.bytesRead = img->imgSize;
+    span.bytesWritten = dst->imgSize;
+    span.pixels = (size_t)img->width * img->height;
+    span.allocations = 3;
+    traceEnd(&span);
+    return ok;
+}
+
+// Measured seconds per direct multiply-add and per unit of FFT work
+static double directCost = 0.0;
+static double fftCost = 0.0;
+static pthread_once_t calibrateOnce = PTHREAD_ONCE_INIT;
+
+// Time both paths once on a small synthetic image (best of three runs each)
+static void calibrateConvolution(void){
+    const int side = 128, taps = 9;
+    BMP8Image probe = {0}, out = {0};
+    probe.width = probe.height = out.width = out.height = side;
+    probe.imgSize = out.imgSize = side * side;
+    probe.data = malloc(side * side);
+    out.data = malloc(side * side);
+    complexf* buffer = calloc(side * side, sizeof(complexf));
+    mask* m = maskCreate(taps, taps);
+    if(!probe.data || !out.data || !buffer || !m || !m->data){
+        // Without a measurement the FFT path is never chosen
+        directCost = 0.0;
+        fftCost = 1.0;
+    } else {
+        for(int i = 0; i < side * side; i++){
+            probe.data[i] = (unsigned char)(i * 7 + i / side * 13);
+        }
+        for(int i = 0; i < taps * taps; i++){
+            m->data[i] = 1.0f / (taps * taps);
+        }
+        double bestDirect = 1e30, bestFFT = 1e30;
+        for(int run = 0; run < 3; run++){
+            double start = traceNow();
+            BMP8ConvolutionDirect(&probe, m, &out);
+            bestDirect = MIN(bestDirect, traceNow() - start);
+            start = traceNow();
+            fft2D(buffer, side, side, false);
+            fft2D(buffer, side, side, true);
+            bestFFT = MIN(bestFFT, traceNow() - start);
+        }
+        directCost = bestDirect / ((double)side * side * taps * taps);
+        fftCost = bestFFT / (2.0 * side * side * log2((double)side * side));
+    }
+    free(probe.data);
+    free(out.data);
+    free(buffer);
+    maskFree(m);
+}
+
+// True when the FFT path is predicted to beat the direct one for this image and mask
+static bool convolutionPrefersFFT(BMP8Image* img, mask* m){
+    // Small masks never pay for the transforms
+    if(m->rows * m->cols < 49){
+        return false;
+    }
+    pthread_once(&calibrateOnce, calibrateConvolution);
+    int nr, nc;
+    double fft = fftConvolutionWork(img->width, img->height, m->rows, m->cols, &nr, &nc) * fftCost;
+    double direct = (double)img->width * img->height * m->rows * m->cols * directCost;
+    return fft < direct;
+}
+
+// Function to apply convolution with a given mask, writing into a caller-supplied image
+// dst must have the size of img and must not alias it (neighbors are read after writes)
+bool BMP8ConvolutionInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    traceSpan span = traceBegin("BMP8ConvolutionInto");
+    span.bytesRead = img->imgSize;
+    span.bytesWritten = dst->imgSize;
+    span.pixels = (size_t)img->width * img->height;
+
+    // Integral masks (Sobel, Prewitt, Kirsch, Laplacian, ...) take the exact integer path
+    int* taps = malloc(m->rows * m->cols * sizeof(int));
+    int absSum = taps ? maskIntegerTaps(m, taps) : -1;
+    span.allocations = taps ? 1 : 0;
+    if(absSum >= 0){
+        BMP8ConvolutionInteger(img, taps, m->rows, m->cols, absSum, kernelRowFor(m->rows, m->cols), dst);
+        free(taps);
+        traceEnd(&span);
+        return true;
+    }
+    free(taps);
+
+    // Large fractional masks go through the FFT when the measured cost model favours it
+    if(convolutionPrefersFFT(img, m) && BMP8ConvolutionFFT(img, m, dst)){
+        traceEnd(&span);
+        return true;
+    }
+    BMP8ConvolutionDirect(img, m, dst);
+
+    traceEnd(&span);
+    return true;
+}
+
+// Convolution through the FFT regardless of the mask, writing into a caller-supplied image
+// Pixels may differ by 1 from the direct path; dst must not alias img
+bool BMP8ConvolutionFFTInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+    if(!BMP8ConvolutionFFT(img, m, dst)){
+        fprintf(stderr, "Convolution Error: Memory allocation failed!\n");
+        return false;
+    }
+    return true;
+}
+
+// Apply an integer mask fixed at compile time (see CONSTANT_KERNEL), writing into a
+// caller-supplied image; same result as BMP8ConvolutionInto with the equivalent mask
+bool BMP8ConvolutionKernelInto(BMP8Image* img, const constantKernel* k, BMP8Image* dst){
+    if(!img || !k){
+        fprintf(stderr, "Convolution Error: Either there is no image or kernel.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    int absSum = 0;
+    for(int i = 0; i < k->rows * k->cols; i++){
+        absSum += abs(k->taps[i]);
+    }
+    BMP8ConvolutionInteger(img, k->taps, k->rows, k->cols, absSum, k->row, dst);
+    return true;
+}
+
+// Function to apply convolution with a given mask to an 8-bit BMP image
+BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return NULL;
+    }
+
+    traceSpan span = traceBegin("BMP8Convolution");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8ConvolutionInto(img, m, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    span.allocations = 2;
+    traceEnd(&span);
+    return dst;
 }
 
 // Function to save an 8-bit BMP image to a file
 void BMP8save(const char* filename, BMP8Image* img) {
+    traceSpan span = traceBegin("BMP8save");
     FILE *fOutput = fopen(filename, "wb");
     if (!fOutput) {
         fprintf(stderr, "Unable to create file %s!\n", filename);
@@ -169,19 +613,182 @@ void BMP8save(const char* filename, BMP8Image* img) {
     fwrite(img->data, sizeof(unsigned char), img->imgSize, fOutput);
 
     fclose(fOutput);
+    span.bytesWritten = BMP_HEADER_SIZE + (img->bitDepth <= 8 ? BMP_COLOR_TABLE_SIZE : 0) + img->imgSize;
+    span.pixels = (size_t)img->width * img->height;
+    traceEnd(&span);
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
+
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    traceSpan span = traceBegin("BMP24Read");
+
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
         free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    span.bytesRead = BMP_HEADER_SIZE + (size_t)img->rowSize * img->height;
+    span.pixels = (size_t)img->width * img->height;
+    span.allocations = 2;
+    traceEnd(&span);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    traceSpan span = traceBegin("BMP24Save");
+
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+    span.bytesWritten = BMP_HEADER_SIZE + (size_t)img24->rowSize * img24->height;
+    span.pixels = (size_t)img24->width * img24->height;
+    traceEnd(&span);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
     }
 }
 
+// Function to apply convolution with a given mask to a 24-bit BMP image
+// All three channels are accumulated in a single pass over the interleaved data
+BMP24Image* BMP24Convolution(BMP24Image* img, mask* m){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return NULL;
+    }
+
+    traceSpan span = traceBegin("BMP24Convolution");
+
+    // Allocate memory for the new image
+    BMP24Image* convImg = malloc(sizeof(BMP24Image));
+    if(!convImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(convImg->header, img->header, BMP_HEADER_SIZE);
+    convImg->width = img->width;
+    convImg->height = img->height;
+    convImg->bitDepth = img->bitDepth;
+    convImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    convImg->data = calloc(img->rowSize * img->height, 1);
+    if (!convImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(convImg);
+        return NULL;
+    }
+
+    // Compute center of the mask (for correct alignment during convolution)
+    int iCenter = m->rows / 2;
+    int jCenter = m->cols / 2;
+
+    // Iterate through every pixel in the image
+    for(int y = 0; y < convImg->height; y++){
+        for(int x = 0; x < convImg->width; x++){
+            // Accumulators for blue, green and red
+            float val[3] = {0.0f, 0.0f, 0.0f};
+
+            // Apply convolution mask
+            for(int i = 0; i < (int)m->rows; i++){
+                for(int j = 0; j < (int)m->cols; j++){
+                    int idx = x + (j - jCenter);  // pixel x offset
+                    int idy = y + (i - iCenter);  // pixel y offset
+
+                    // Check if neighbor is inside image bounds
+                    if(idx >= 0 && idx < img->width && idy >= 0 && idy < img->height){
+                        float ms = m->data[i * m->cols + j];                        // mask coefficient
+                        const unsigned char* px = img->data + idy * img->rowSize + idx * 3; // BGR pixel
+                        val[0] += ms * px[0];
+                        val[1] += ms * px[1];
+                        val[2] += ms * px[2];
+                    }
+                }
+            }
+
+            // Clamp every channel to [0..255] and store
+            unsigned char* out = convImg->data + y * convImg->rowSize + x * 3;
+            for(int c = 0; c < 3; c++){
+                val[c] = MIN(val[c], MAX_BRIGHTNESS);
+                val[c] = MAX(val[c], MIN_BRIGHTNESS);
+                out[c] = (unsigned char)val[c];
+            }
+        }
+    }
+
+    span.bytesRead = (size_t)img->rowSize * img->height;
+    span.bytesWritten = (size_t)convImg->rowSize * convImg->height;
+    span.pixels = (size_t)img->width * img->height;
+    span.allocations = 2;
+    traceEnd(&span);
+    return convImg;
+}
 
 int main(){
+    // TRACE=<file> records every stage, prints a summary and writes a Chrome trace
+    const char *traceFile = getenv("TRACE");
+    if(traceFile){
+        traceEnable(true);
+    }
+
     // Input and output file paths
     const char *inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
     const char *outputFile = "images/lizard_convolved.bmp";
@@ -224,11 +831,67 @@ int main(){
     // Step 5: Save the convolved image
     BMP8save(outputFile, convolved);
 
-    // Step 6: Free all allocated memory
+    // Step 6: Apply the same mask to a 24-bit color image
+    BMP24Image *image24 = BMP24Read("../Test_Images/lena_color.bmp");
+    BMP24Image *convolved24 = BMP24Convolution(image24, m);
+    if(convolved24){
+        BMP24Save("images/lena_color_convolved.bmp", convolved24);
+    }
+
+    // Step 7: Blur with a large 31x31 Gaussian mask through both the direct and the FFT path
+    mask* blur = maskCreate(31, 31);
+    BMP8Image *blurred = BMP8CreateLike(image);
+    BMP8Image *blurredFFT = BMP8CreateLike(image);
+    if(blur && blurred && blurredFFT){
+        float sum = 0.0f;
+        int rows = (int)blur->rows, cols = (int)blur->cols;
+        for(int i = 0; i < rows; i++){
+            for(int j = 0; j < cols; j++){
+                float dy = (float)(i - rows / 2), dx = (float)(j - cols / 2);
+                blur->data[i * cols + j] = expf(-(dx * dx + dy * dy) / (2.0f * 5.0f * 5.0f));
+                sum += blur->data[i * cols + j];
+            }
+        }
+        for(int i = 0; i < rows * cols; i++){
+            blur->data[i] /= sum;
+        }
+
+        double start = traceNow();
+        BMP8ConvolutionDirect(image, blur, blurred);
+        double directTime = traceNow() - start;
+        start = traceNow();
+        bool fftDone = BMP8ConvolutionFFTInto(image, blur, blurredFFT);
+        double fftTime = traceNow() - start;
+
+        if(fftDone){
+            int maxDiff = 0;
+            for(int i = 0; i < image->imgSize; i++){
+                maxDiff = MAX(maxDiff, abs(blurred->data[i] - blurredFFT->data[i]));
+            }
+            printf("31x31 blur: direct %.1f ms, FFT %.1f ms, max difference %d\n",
+                   directTime * 1e3, fftTime * 1e3, maxDiff);
+            BMP8save("images/lizard_blurred31x31.bmp", blurredFFT);
+        }
+    }
+
+    // Step 8: Free all allocated memory
     BMP8Free(image);
     BMP8Free(convolved);
+    BMP8Free(blurred);
+    BMP8Free(blurredFFT);
+    BMP24Free(image24);
+    BMP24Free(convolved24);
     maskFree(m);
+    maskFree(blur);
+    fftPlanCacheClear();
 
     printf("Convolution completed! Saved result as %s\n", outputFile);
+
+    if(traceFile){
+        traceSummary(stdout);
+        if(*traceFile && traceWriteChrome(traceFile)){
+            printf("Trace written to %s\n", traceFile);
+        }
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief One timed call of an instrumented stage.
+ *
+ * Instrumented functions fill in the counters that apply to them; the
+ * span is recorded by traceEnd. While tracing is disabled start stays 0
+ * and traceEnd returns immediately, so the cost of a disabled span is a
+ * few stores and one predictable branch.
+ */
+typedef struct {
+    const char *name;       /// stage name; must outlive the trace (string literal)
+    double start;           /// start time in seconds, 0 when tracing is disabled
+    size_t bytesRead;       /// bytes read from files or input images
+    size_t bytesWritten;    /// bytes written to files or output images
+    size_t pixels;          /// pixels processed
+    size_t allocations;     /// heap allocations made by the stage
+} traceSpan;
+
+/**
+ * @brief True while spans are recorded. Read by traceBegin; set with traceEnable.
+ */
+extern bool traceEnabled;
+
+/**
+ * @brief Current monotonic time in seconds.
+ */
+double traceNow(void);
+
+/**
+ * @brief Store a finished span (called through traceEnd).
+ *
+ * @param span Span to record; its duration ends now.
+ */
+void traceRecord(traceSpan* span);
+
+/**
+ * @brief Turn recording on or off. Already recorded spans are kept.
+ *
+ * @param enabled true to record spans.
+ */
+void traceEnable(bool enabled);
+
+/**
+ * @brief Start a span.
+ *
+ * @param name Stage name (string literal).
+ * @return Span to pass to traceEnd.
+ */
+static inline traceSpan traceBegin(const char* name) {
+    traceSpan span = {name, 0.0, 0, 0, 0, 0};
+    if (traceEnabled) {
+        span.start = traceNow();
+    }
+    return span;
+}
+
+/**
+ * @brief Finish a span started with traceBegin.
+ *
+ * @param span Span whose counters were filled in by the caller.
+ */
+static inline void traceEnd(traceSpan* span) {
+    if (span->start > 0) {
+        traceRecord(span);
+    }
+}
+
+/**
+ * @brief Print calls, time, bytes, pixels and allocations per stage.
+ *
+ * Time is inclusive: a stage calling another traced stage also counts the
+ * time of the inner one.
+ *
+ * @param out Stream to print to.
+ */
+void traceSummary(FILE* out);
+
+/**
+ * @brief Write every recorded span as Chrome trace event JSON.
+ *
+ * The file opens in chrome://tracing or https://ui.perfetto.dev; every
+ * thread that recorded spans gets its own track.
+ *
+ * @param filename File to create.
+ * @return true on success, false if the file could not be written.
+ */
+bool traceWriteChrome(const char* filename);
+
+/**
+ * @brief Drop every recorded span and summary entry.
+ */
+void traceReset(void);
+
+#endif // TRACE_H
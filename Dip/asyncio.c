@@ -0,0 +1,443 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "asyncio.h"
+
+// Allocate a request; the path is copied
+static ioRequest* newRequest(ioKind kind, const char* path, unsigned char* data, size_t size, void* user) {
+    ioRequest* req = calloc(1, sizeof(ioRequest));
+    if (!req) {
+        return NULL;
+    }
+    req->kind = kind;
+    req->path = path ? strdup(path) : NULL;
+    req->fd = -1;
+    req->data = data;
+    req->size = size;
+    req->user = user;
+    return req;
+}
+
+// Append a request to a singly linked queue
+static void queuePush(ioRequest** head, ioRequest** tail, ioRequest* req) {
+    req->next = NULL;
+    if (*tail) {
+        (*tail)->next = req;
+    } else {
+        *head = req;
+    }
+    *tail = req;
+}
+
+// Remove the first request of a queue (NULL if empty)
+static ioRequest* queuePop(ioRequest** head, ioRequest** tail) {
+    ioRequest* req = *head;
+    if (req) {
+        *head = req->next;
+        if (!*head) {
+            *tail = NULL;
+        }
+    }
+    return req;
+}
+
+// Open the file of a request and, for reads, allocate the whole-file buffer
+// Errors are stored in the request and reported with its completion
+static void openRequest(ioRequest* req) {
+    if (req->kind == IO_NOP || req->error) {
+        return;
+    }
+    if (req->kind == IO_READ) {
+        req->fd = open(req->path, O_RDONLY);
+        struct stat st;
+        if (req->fd < 0 || fstat(req->fd, &st) != 0) {
+            req->error = errno;
+            return;
+        }
+        req->size = (size_t)st.st_size;
+        // malloc(0) may return NULL, so always ask for at least one byte
+        req->data = malloc(req->size ? req->size : 1);
+        if (!req->data) {
+            req->error = ENOMEM;
+        }
+    } else {
+        req->fd = open(req->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (req->fd < 0) {
+            req->error = errno;
+        }
+    }
+}
+
+// Turn a finished request into a completion and free it
+static void completeRequest(ioRequest* req, ioCompletion* completion) {
+    if (req->fd >= 0) {
+        close(req->fd);
+    }
+    completion->kind = req->kind;
+    completion->user = req->user;
+    completion->error = req->error;
+    completion->size = req->done;
+    completion->data = NULL;
+    if (req->kind == IO_READ && !req->error) {
+        completion->data = req->data;
+    } else {
+        // Failed reads and all writes release their buffer here
+        free(req->data);
+    }
+    free(req->path);
+    free(req);
+}
+
+
+// ---- io_uring backend ----
+
+static int uringSetup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+// Create the rings; returns false when io_uring is unavailable
+static bool uringInit(ioUring* ring, unsigned depth) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = uringSetup(depth, &params);
+    if (ring->fd < 0) {
+        return false;
+    }
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) {
+        // Both rings share one mapping
+        if (ring->cqRingSize > ring->sqRingSize) {
+            ring->sqRingSize = ring->cqRingSize;
+        }
+        ring->cqRingSize = ring->sqRingSize;
+    }
+
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        close(ring->fd);
+        return false;
+    }
+    ring->cqRing = single ? ring->sqRing
+                          : mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->cqRing == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        if (ring->cqRing != MAP_FAILED && !single) {
+            munmap(ring->cqRing, ring->cqRingSize);
+        }
+        if (ring->sqes != MAP_FAILED) {
+            munmap(ring->sqes, ring->sqesSize);
+        }
+        munmap(ring->sqRing, ring->sqRingSize);
+        close(ring->fd);
+        return false;
+    }
+
+    unsigned char* sq = ring->sqRing;
+    unsigned char* cq = ring->cqRing;
+    ring->sqHead = (unsigned*)(sq + params.sq_off.head);
+    ring->sqTail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned*)(sq + params.sq_off.array);
+    ring->cqHead = (unsigned*)(cq + params.cq_off.head);
+    ring->cqTail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    ring->entries = params.sq_entries;
+    ring->inFlight = 0;
+    return true;
+}
+
+// Entries published in the submission ring that the kernel has not consumed yet
+static unsigned uringUnsubmitted(ioUring* ring) {
+    return __atomic_load_n(ring->sqTail, __ATOMIC_ACQUIRE) - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+}
+
+// Hand one request to the kernel (engine lock held, a ring slot is free)
+static void uringPush(ioEngine* engine, ioRequest* req) {
+    ioUring* ring = &engine->ring;
+    unsigned tail = *ring->sqTail;
+    unsigned index = tail & *ring->sqMask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+
+    if (req->kind == IO_NOP || req->error) {
+        // Failed opens still travel through the ring so the reaper wakes up
+        sqe->opcode = IORING_OP_NOP;
+    } else {
+        req->iov.iov_base = req->data + req->done;
+        req->iov.iov_len = req->size - req->done;
+        sqe->opcode = req->kind == IO_READ ? IORING_OP_READV : IORING_OP_WRITEV;
+        sqe->fd = req->fd;
+        sqe->addr = (unsigned long)&req->iov;
+        sqe->len = 1;
+        sqe->off = req->done;
+    }
+    sqe->user_data = (unsigned long)req;
+
+    ring->sqArray[index] = index;
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    ring->inFlight++;
+    // Submit every unconsumed entry, including any left by an earlier failed enter;
+    // entries that still fail (EAGAIN, EBUSY, ...) stay queued for uringWait
+    while (uringEnter(ring->fd, uringUnsubmitted(ring), 0, 0) < 0 && errno == EINTR) {
+    }
+}
+
+// Submit a request now or queue it until a ring slot frees up (engine lock held)
+static void uringQueue(ioEngine* engine, ioRequest* req) {
+    if (engine->ring.inFlight < engine->ring.entries) {
+        uringPush(engine, req);
+    } else {
+        queuePush(&engine->pendingHead, &engine->pendingTail, req);
+    }
+}
+
+static bool uringWait(ioEngine* engine, ioCompletion* completion) {
+    ioUring* ring = &engine->ring;
+    for (;;) {
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            // Submitting here as well ensures no queued entry is left waiting forever
+            if (uringEnter(ring->fd, uringUnsubmitted(ring), 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                fprintf(stderr, "IO Error: io_uring_enter failed (%s).\n", strerror(errno));
+                return false;
+            }
+            continue;
+        }
+
+        struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cqMask];
+        ioRequest* req = (ioRequest*)(unsigned long)cqe->user_data;
+        int res = cqe->res;
+        __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+
+        pthread_mutex_lock(&engine->lock);
+        ring->inFlight--;
+        bool finished = true;
+        if (req->kind != IO_NOP && !req->error) {
+            if (res < 0) {
+                req->error = -res;
+            } else if (res == 0 && req->done < req->size) {
+                // File shrank while being read
+                req->error = EIO;
+            } else {
+                req->done += res;
+                if (req->done < req->size) {
+                    // Short transfer: continue with the remainder
+                    uringQueue(engine, req);
+                    finished = false;
+                }
+            }
+        }
+        // Refill freed ring slots with queued requests
+        while (engine->pendingHead && ring->inFlight < ring->entries) {
+            uringPush(engine, queuePop(&engine->pendingHead, &engine->pendingTail));
+        }
+        pthread_mutex_unlock(&engine->lock);
+
+        if (finished) {
+            completeRequest(req, completion);
+            return true;
+        }
+    }
+}
+
+
+// ---- thread backend ----
+
+// Perform one request with blocking system calls
+static void performBlocking(ioRequest* req) {
+    openRequest(req);
+    while (!req->error && req->kind != IO_NOP && req->done < req->size) {
+        ssize_t n = req->kind == IO_READ ? read(req->fd, req->data + req->done, req->size - req->done)
+                                         : write(req->fd, req->data + req->done, req->size - req->done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            req->error = n < 0 ? errno : EIO;
+            break;
+        }
+        req->done += n;
+    }
+}
+
+static void* ioThreadMain(void* arg) {
+    ioEngine* engine = arg;
+    for (;;) {
+        pthread_mutex_lock(&engine->lock);
+        while (!engine->pendingHead && !engine->stopping) {
+            pthread_cond_wait(&engine->pendingChanged, &engine->lock);
+        }
+        ioRequest* req = queuePop(&engine->pendingHead, &engine->pendingTail);
+        pthread_mutex_unlock(&engine->lock);
+        if (!req) {
+            break;
+        }
+
+        performBlocking(req);
+
+        pthread_mutex_lock(&engine->lock);
+        queuePush(&engine->doneHead, &engine->doneTail, req);
+        pthread_cond_signal(&engine->doneChanged);
+        pthread_mutex_unlock(&engine->lock);
+    }
+    return NULL;
+}
+
+
+// ---- common interface ----
+
+ioEngine* ioEngineCreate(unsigned depth, bool allowUring, int threads) {
+    ioEngine* engine = calloc(1, sizeof(ioEngine));
+    if (!engine) {
+        fprintf(stderr, "IO Error: Memory allocation failed!\n");
+        return NULL;
+    }
+    pthread_mutex_init(&engine->lock, NULL);
+    pthread_cond_init(&engine->pendingChanged, NULL);
+    pthread_cond_init(&engine->doneChanged, NULL);
+
+    engine->useUring = allowUring && uringInit(&engine->ring, depth < 1 ? 1 : depth);
+    if (engine->useUring) {
+        return engine;
+    }
+
+    // Fallback: blocking I/O on a few dedicated threads
+    engine->threadCount = threads < 1 ? 1 : threads;
+    engine->threads = malloc(engine->threadCount * sizeof(pthread_t));
+    int started = 0;
+    for (int i = 0; engine->threads && i < engine->threadCount; i++) {
+        if (pthread_create(&engine->threads[i], NULL, ioThreadMain, engine) != 0) {
+            break;
+        }
+        started++;
+    }
+    engine->threadCount = started;
+    if (started == 0) {
+        fprintf(stderr, "IO Error: Could not start I/O threads.\n");
+        ioEngineDestroy(engine);
+        return NULL;
+    }
+    return engine;
+}
+
+const char* ioEngineName(ioEngine* engine) {
+    return engine->useUring ? "io_uring" : "threads";
+}
+
+// Queue a request on the active backend
+static void submitRequest(ioEngine* engine, ioRequest* req) {
+    if (engine->useUring) {
+        // Opening is synchronous; only the data transfer goes through the ring
+        openRequest(req);
+        pthread_mutex_lock(&engine->lock);
+        uringQueue(engine, req);
+        pthread_mutex_unlock(&engine->lock);
+        return;
+    }
+
+    pthread_mutex_lock(&engine->lock);
+    if (req->kind == IO_NOP) {
+        queuePush(&engine->doneHead, &engine->doneTail, req);
+        pthread_cond_signal(&engine->doneChanged);
+    } else {
+        queuePush(&engine->pendingHead, &engine->pendingTail, req);
+        pthread_cond_signal(&engine->pendingChanged);
+    }
+    pthread_mutex_unlock(&engine->lock);
+}
+
+bool ioSubmitRead(ioEngine* engine, const char* path, void* user) {
+    ioRequest* req = newRequest(IO_READ, path, NULL, 0, user);
+    if (!req) {
+        fprintf(stderr, "IO Error: Memory allocation failed!\n");
+        return false;
+    }
+    submitRequest(engine, req);
+    return true;
+}
+
+bool ioSubmitWrite(ioEngine* engine, const char* path, unsigned char* data, size_t size, void* user) {
+    ioRequest* req = newRequest(IO_WRITE, path, data, size, user);
+    if (!req) {
+        fprintf(stderr, "IO Error: Memory allocation failed!\n");
+        free(data);
+        return false;
+    }
+    submitRequest(engine, req);
+    return true;
+}
+
+bool ioSubmitNop(ioEngine* engine, int error, void* user) {
+    ioRequest* req = newRequest(IO_NOP, NULL, NULL, 0, user);
+    if (!req) {
+        fprintf(stderr, "IO Error: Memory allocation failed!\n");
+        return false;
+    }
+    req->error = error;
+    submitRequest(engine, req);
+    return true;
+}
+
+bool ioWaitCompletion(ioEngine* engine, ioCompletion* completion) {
+    if (engine->useUring) {
+        return uringWait(engine, completion);
+    }
+
+    pthread_mutex_lock(&engine->lock);
+    while (!engine->doneHead) {
+        pthread_cond_wait(&engine->doneChanged, &engine->lock);
+    }
+    ioRequest* req = queuePop(&engine->doneHead, &engine->doneTail);
+    pthread_mutex_unlock(&engine->lock);
+
+    completeRequest(req, completion);
+    return true;
+}
+
+void ioEngineDestroy(ioEngine* engine) {
+    if (!engine) {
+        return;
+    }
+
+    if (engine->useUring) {
+        ioUring* ring = &engine->ring;
+        munmap(ring->sqes, ring->sqesSize);
+        if (ring->cqRing != ring->sqRing) {
+            munmap(ring->cqRing, ring->cqRingSize);
+        }
+        munmap(ring->sqRing, ring->sqRingSize);
+        close(ring->fd);
+    } else {
+        // Wake and join the I/O threads
+        pthread_mutex_lock(&engine->lock);
+        engine->stopping = true;
+        pthread_cond_broadcast(&engine->pendingChanged);
+        pthread_mutex_unlock(&engine->lock);
+        for (int i = 0; i < engine->threadCount; i++) {
+            pthread_join(engine->threads[i], NULL);
+        }
+        free(engine->threads);
+    }
+
+    pthread_cond_destroy(&engine->doneChanged);
+    pthread_cond_destroy(&engine->pendingChanged);
+    pthread_mutex_destroy(&engine->lock);
+    free(engine);
+}
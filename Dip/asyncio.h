@@ -0,0 +1,164 @@
+#ifndef ASYNCIO_H
+#define ASYNCIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Kind of an asynchronous request.
+ */
+typedef enum {
+    IO_READ,    /// read a whole file into memory
+    IO_WRITE,   /// write a buffer to a file (created or truncated)
+    IO_NOP      /// no data transfer; only produces a completion
+} ioKind;
+
+/**
+ * @brief Result of a finished request, returned by ioWaitCompletion.
+ */
+typedef struct {
+    ioKind kind;            /// kind of the finished request
+    void *user;             /// pointer passed at submission
+    unsigned char *data;    /// IO_READ: file contents (caller frees); otherwise NULL
+    size_t size;            /// number of bytes read or written
+    int error;              /// 0 on success, otherwise an errno value
+} ioCompletion;
+
+/**
+ * @brief One queued or in-flight request.
+ */
+typedef struct ioRequest {
+    ioKind kind;            /// kind of the request
+    char *path;             /// file to read or write
+    int fd;                 /// open file (-1 until opened)
+    unsigned char *data;    /// buffer being read into or written from
+    size_t size;            /// total bytes to transfer
+    size_t done;            /// bytes transferred so far
+    struct iovec iov;       /// remaining range handed to the kernel
+    void *user;             /// caller pointer returned with the completion
+    int error;              /// errno value, 0 while successful
+    struct ioRequest *next; /// next request in a queue
+} ioRequest;
+
+/**
+ * @brief Submission and completion rings of an io_uring instance.
+ */
+typedef struct {
+    int fd;                         /// io_uring file descriptor
+    unsigned entries;               /// number of submission entries
+    unsigned *sqHead;               /// submission ring head (kernel side)
+    unsigned *sqTail;               /// submission ring tail (our side)
+    unsigned *sqMask;               /// submission ring index mask
+    unsigned *sqArray;              /// submission ring indirection array
+    unsigned *cqHead;               /// completion ring head (our side)
+    unsigned *cqTail;               /// completion ring tail (kernel side)
+    unsigned *cqMask;               /// completion ring index mask
+    struct io_uring_sqe *sqes;      /// submission queue entries
+    struct io_uring_cqe *cqes;      /// completion queue entries
+    void *sqRing;                   /// mapping of the submission ring
+    size_t sqRingSize;              /// size of that mapping
+    void *cqRing;                   /// mapping of the completion ring (may equal sqRing)
+    size_t cqRingSize;              /// size of that mapping
+    size_t sqesSize;                /// size of the entry mapping
+    unsigned inFlight;              /// entries submitted but not reaped
+} ioUring;
+
+/**
+ * @brief Asynchronous file I/O engine.
+ *
+ * Uses io_uring when the kernel provides it and a small pool of threads
+ * doing blocking I/O otherwise. Any thread may submit; completions are
+ * reaped by a single thread through ioWaitCompletion.
+ */
+typedef struct {
+    bool useUring;                  /// true when the io_uring backend is active
+    ioUring ring;                   /// io_uring state (io_uring backend)
+    ioRequest *pendingHead;         /// requests waiting for a ring slot or an I/O thread
+    ioRequest *pendingTail;         /// last pending request
+    ioRequest *doneHead;            /// finished requests (thread backend)
+    ioRequest *doneTail;            /// last finished request
+    pthread_t *threads;             /// I/O threads (thread backend)
+    int threadCount;                /// number of I/O threads
+    bool stopping;                  /// asks I/O threads to exit
+    pthread_mutex_t lock;           /// guards queues and the submission ring
+    pthread_cond_t pendingChanged;  /// wakes I/O threads (thread backend)
+    pthread_cond_t doneChanged;     /// wakes the reaper (thread backend)
+} ioEngine;
+
+/**
+ * @brief Create an I/O engine.
+ *
+ * @param depth Maximum number of requests handed to the kernel at once;
+ *              further requests wait in a queue.
+ * @param allowUring false forces the thread backend.
+ * @param threads Number of I/O threads for the thread backend.
+ * @return Pointer to the new engine, or NULL if allocation fails.
+ */
+ioEngine* ioEngineCreate(unsigned depth, bool allowUring, int threads);
+
+/**
+ * @brief Name of the active backend ("io_uring" or "threads").
+ */
+const char* ioEngineName(ioEngine* engine);
+
+/**
+ * @brief Start reading a whole file into a newly allocated buffer.
+ *
+ * I/O failures are reported through the completion.
+ *
+ * @param engine Engine to submit to.
+ * @param path File to read (copied).
+ * @param user Pointer returned with the completion.
+ * @return true if the request was queued, false if it could not be
+ *         allocated; no completion follows a false return.
+ */
+bool ioSubmitRead(ioEngine* engine, const char* path, void* user);
+
+/**
+ * @brief Start writing a buffer to a file.
+ *
+ * The engine takes ownership of data and frees it once the write finished,
+ * or immediately if the request cannot be queued.
+ *
+ * @param engine Engine to submit to.
+ * @param path File to create or truncate (copied).
+ * @param data Buffer allocated with malloc.
+ * @param size Number of bytes to write.
+ * @param user Pointer returned with the completion.
+ * @return true if the request was queued, false if it could not be
+ *         allocated; no completion follows a false return.
+ */
+bool ioSubmitWrite(ioEngine* engine, const char* path, unsigned char* data, size_t size, void* user);
+
+/**
+ * @brief Queue a completion without any I/O (used to wake the reaper).
+ *
+ * @param engine Engine to submit to.
+ * @param error Value reported in the completion's error field.
+ * @param user Pointer returned with the completion.
+ * @return true if the request was queued, false if it could not be
+ *         allocated; no completion follows a false return.
+ */
+bool ioSubmitNop(ioEngine* engine, int error, void* user);
+
+/**
+ * @brief Block until a request finishes.
+ *
+ * Must only be called from one thread at a time.
+ *
+ * @param engine Engine to wait on.
+ * @param completion Filled with the result.
+ * @return true when a completion was returned, false on a fatal engine error.
+ */
+bool ioWaitCompletion(ioEngine* engine, ioCompletion* completion);
+
+/**
+ * @brief Free the engine. Every submitted request must have been reaped.
+ *
+ * @param engine Pointer to the engine to be destroyed.
+ */
+void ioEngineDestroy(ioEngine* engine);
+
+#endif // ASYNCIO_H
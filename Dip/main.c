@@ -0,0 +1,789 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "pipeline.h"
+#include "asyncio.h"
+#include "trace.h"
+
+// Decode an 8-bit BMP from a file image held in memory
+BMP8Image* BMP8Decode(const unsigned char* buffer, size_t size) {
+    if (size < BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE) {
+        fprintf(stderr, "Truncated BMP\n");
+        return NULL;
+    }
+
+    // Allocate memory for image structure
+    BMP8Image *img = (BMP8Image*)malloc(sizeof(BMP8Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Header and metadata
+    memcpy(img->header, buffer, BMP_HEADER_SIZE);
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Compute row size (aligned to 4 bytes)
+    int rowSize = (img->width + 3) & ~3;
+    img->imgSize = rowSize * img->height;
+    if (img->bitDepth != 8 || img->width <= 0 || img->height <= 0
+        || size < (size_t)BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + img->imgSize) {
+        fprintf(stderr, "Not a complete 8-bit BMP\n");
+        free(img);
+        return NULL;
+    }
+
+    // Color table and pixel data
+    memcpy(img->colorTable, buffer + BMP_HEADER_SIZE, BMP_COLOR_TABLE_SIZE);
+    img->data = (unsigned char*)malloc(img->imgSize);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        return NULL;
+    }
+    memcpy(img->data, buffer + BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE, img->imgSize);
+    return img;
+}
+
+// Decode a 24-bit BMP from a file image held in memory
+BMP24Image* BMP24Decode(const unsigned char* buffer, size_t size) {
+    if (size < BMP_HEADER_SIZE) {
+        fprintf(stderr, "Truncated BMP\n");
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Header and metadata
+    memcpy(img->header, buffer, BMP_HEADER_SIZE);
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    size_t pixelBytes = (size_t)img->rowSize * img->height;
+    if (img->bitDepth != 24 || img->width <= 0 || img->height <= 0 || size < BMP_HEADER_SIZE + pixelBytes) {
+        fprintf(stderr, "Not a complete 24-bit BMP\n");
+        free(img);
+        return NULL;
+    }
+
+    img->data = (unsigned char*)malloc(pixelBytes);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        return NULL;
+    }
+    memcpy(img->data, buffer + BMP_HEADER_SIZE, pixelBytes);
+    return img;
+}
+
+// Encode an 8-bit BMP into a newly allocated file image
+unsigned char* BMP8Encode(BMP8Image* img, size_t* size) {
+    *size = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + (size_t)img->imgSize;
+    unsigned char *buffer = malloc(*size);
+    if (!buffer) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    memcpy(buffer, img->header, BMP_HEADER_SIZE);
+    memcpy(buffer + BMP_HEADER_SIZE, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    memcpy(buffer + BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE, img->data, img->imgSize);
+    return buffer;
+}
+
+// Function to free allocated memory
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Operators accepted in a chain
+typedef enum {
+    OP_NEGATIVE,    // negative
+    OP_BRIGHTNESS,  // brightness:<delta>
+    OP_THRESHOLD,   // threshold:<level>
+    OP_BLUR,        // blur:<odd size>
+    OP_SOBEL        // sobel
+} dipOpKind;
+
+// One parsed operator of a chain
+typedef struct {
+    dipOpKind kind;
+    int arg;
+} dipOp;
+
+
+// Processing stages timed for every file
+// Read and write are asynchronous; their time is request latency, which
+// overlaps with processing of other files
+typedef enum {
+    STAGE_READ,
+    STAGE_PROCESS,
+    STAGE_WRITE,
+    STAGE_COUNT
+} dipStage;
+
+static const char *stageNames[STAGE_COUNT] = {"read", "process", "write"};
+
+// One file travelling through the batch
+typedef struct dipJob {
+    const char *inputFile;      // File to read
+    char *outputFile;           // File to write
+    unsigned char *data;        // Input file contents once read
+    size_t size;                // Size of data
+    size_t estimate;            // Bytes charged against the in-flight budget
+    double submitted;           // Time the current I/O request was submitted
+    struct dipJob *next;        // Next job in the ready queue
+} dipJob;
+
+// State shared by the reaper and all compute workers of a batch
+typedef struct {
+    char **files;               // Input files
+    size_t *estimates;          // Bytes charged for each input file while it is in flight
+    int fileCount;              // Number of input files
+    int nextFile;               // Next file to prefetch
+    int finished;               // Files written or failed
+    const char *outputDir;      // Directory receiving the results
+    dipOp *ops;                 // Parsed operator chain
+    int opCount;                // Number of operators
+    ioEngine *io;               // Asynchronous read/write engine
+    int prefetchDepth;          // Files read ahead of the compute workers
+    int window;                 // Reads in flight plus files waiting for a worker
+    dipJob *readyHead;          // Files read and waiting for a worker
+    dipJob *readyTail;          // Last ready file
+    bool done;                  // Every file finished; workers exit
+    size_t maxInFlight;         // Bound on estimated bytes held by the batch
+    size_t inFlight;            // Estimated bytes currently held
+    int queued;                 // I/O requests submitted and not yet reaped
+    double stageSeconds[STAGE_COUNT]; // Time per stage, summed over files
+    size_t stageBytes[STAGE_COUNT];   // Bytes handled per stage
+    int processed;              // Files written successfully
+    int failed;                 // Files that could not be processed
+    pthread_mutex_t lock;       // Guards everything above that changes
+    pthread_cond_t readyChanged;// Signalled when a file is ready or the batch is done
+    pthread_cond_t reapChanged; // Signalled when a request was queued or a job retired
+} dipBatch;
+
+// Current monotonic time in seconds
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Parse a chain like "blur:3,sobel,threshold:64" into ops (returns the count, -1 on error)
+int dipParseChain(const char* chain, dipOp* ops, int maxOps) {
+    char *copy = strdup(chain);
+    if (!copy) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return -1;
+    }
+
+    int count = 0;
+    char *save = NULL;
+    for (char *token = strtok_r(copy, ",", &save); token; token = strtok_r(NULL, ",", &save)) {
+        if (count == maxOps) {
+            fprintf(stderr, "Chain Error: More than %d operators.\n", maxOps);
+            count = -1;
+            break;
+        }
+
+        // Split "name:arg"
+        char *arg = strchr(token, ':');
+        if (arg) {
+            *arg++ = '\0';
+        }
+
+        dipOp *op = &ops[count];
+        bool needsArg = true;
+        if (strcmp(token, "negative") == 0) {
+            op->kind = OP_NEGATIVE;
+            needsArg = false;
+        } else if (strcmp(token, "sobel") == 0) {
+            op->kind = OP_SOBEL;
+            needsArg = false;
+        } else if (strcmp(token, "brightness") == 0) {
+            op->kind = OP_BRIGHTNESS;
+        } else if (strcmp(token, "threshold") == 0) {
+            op->kind = OP_THRESHOLD;
+        } else if (strcmp(token, "blur") == 0) {
+            op->kind = OP_BLUR;
+        } else {
+            fprintf(stderr, "Chain Error: Unknown operator '%s'.\n", token);
+            count = -1;
+            break;
+        }
+
+        if (needsArg != (arg != NULL)) {
+            fprintf(stderr, "Chain Error: Operator '%s' %s.\n", token, needsArg ? "needs an argument" : "takes no argument");
+            count = -1;
+            break;
+        }
+        op->arg = 0;
+        if (arg) {
+            char *end;
+            long value = strtol(arg, &end, 10);
+            if (*arg == '\0' || *end != '\0') {
+                fprintf(stderr, "Chain Error: Invalid argument '%s' for '%s'.\n", arg, token);
+                count = -1;
+                break;
+            }
+            if (op->kind == OP_BLUR && (value < 1 || value % 2 == 0)) {
+                fprintf(stderr, "Chain Error: Blur size must be a positive odd number.\n");
+                count = -1;
+                break;
+            }
+            op->arg = (int)value;
+        }
+        count++;
+    }
+
+    free(copy);
+    return count;
+}
+
+// Append the parsed chain to a source node
+static pipeNode* dipBuildChain(pipeline* p, pipeNode* node, dipOp* ops, int opCount) {
+    for (int i = 0; i < opCount; i++) {
+        switch (ops[i].kind) {
+            case OP_NEGATIVE:   node = pipelineNegative(p, node); break;
+            case OP_BRIGHTNESS: node = pipelineBrightness(p, node, ops[i].arg); break;
+            case OP_THRESHOLD:  node = pipelineThreshold(p, node, ops[i].arg); break;
+            case OP_BLUR:       node = pipelineBlur(p, node, ops[i].arg); break;
+            case OP_SOBEL:      node = pipelineSobel(p, node); break;
+        }
+    }
+    return node;
+}
+
+// Add a file or every .bmp file of a directory to the list
+static bool dipCollect(const char* path, char*** files, int* count, int* capacity) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "Cannot access %s\n", path);
+        return false;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path);
+        if (!dir) {
+            fprintf(stderr, "Cannot open directory %s\n", path);
+            return false;
+        }
+        struct dirent *entry;
+        bool ok = true;
+        while (ok && (entry = readdir(dir)) != NULL) {
+            size_t len = strlen(entry->d_name);
+            if (len > 4 && strcasecmp(entry->d_name + len - 4, ".bmp") == 0) {
+                char *full = malloc(strlen(path) + len + 2);
+                if (!full) {
+                    ok = false;
+                    break;
+                }
+                sprintf(full, "%s/%s", path, entry->d_name);
+                ok = dipCollect(full, files, count, capacity);
+                free(full);
+            }
+        }
+        closedir(dir);
+        return ok;
+    }
+
+    // Grow the file list if needed
+    if (*count == *capacity) {
+        int newCapacity = *capacity ? *capacity * 2 : 16;
+        char **grown = realloc(*files, newCapacity * sizeof(char*));
+        if (!grown) {
+            fprintf(stderr, "Memory allocation failed!\n");
+            return false;
+        }
+        *files = grown;
+        *capacity = newCapacity;
+    }
+    (*files)[(*count)++] = strdup(path);
+    return true;
+}
+
+// Sort helper for a stable processing order
+static int compareNames(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Add a measured stage duration to the batch totals
+static void dipRecord(dipBatch* batch, dipStage stage, double seconds, size_t bytes) {
+    pthread_mutex_lock(&batch->lock);
+    batch->stageSeconds[stage] += seconds;
+    batch->stageBytes[stage] += bytes;
+    pthread_mutex_unlock(&batch->lock);
+}
+
+// Claim files until the prefetch window or the memory budget is full (batch lock held)
+// Returns the claimed jobs linked through next; dipStart submits their reads
+static dipJob* dipRefill(dipBatch* batch) {
+    dipJob *claimed = NULL;
+    dipJob **tail = &claimed;
+    while (batch->nextFile < batch->fileCount && batch->window < batch->prefetchDepth) {
+        size_t estimate = batch->estimates[batch->nextFile];
+        // A file larger than the whole budget runs alone
+        if (batch->inFlight > 0 && batch->inFlight + estimate > batch->maxInFlight) {
+            break;
+        }
+
+        dipJob *job = calloc(1, sizeof(dipJob));
+        if (!job) {
+            // Fail the file outright: left unclaimed, nothing might ever retry it
+            fprintf(stderr, "%s: Memory allocation failed!\n", batch->files[batch->nextFile]);
+            batch->nextFile++;
+            batch->finished++;
+            batch->failed++;
+            pthread_cond_signal(&batch->reapChanged);
+            continue;
+        }
+        job->inputFile = batch->files[batch->nextFile];
+        job->estimate = estimate;
+        batch->nextFile++;
+        batch->window++;
+        batch->inFlight += estimate;
+        *tail = job;
+        tail = &job->next;
+    }
+    return claimed;
+}
+
+// Retire a job: release its budget and claim further reads (batch lock held)
+static dipJob* dipRetire(dipBatch* batch, dipJob* job, bool ok) {
+    batch->inFlight -= job->estimate;
+    batch->finished++;
+    if (ok) {
+        batch->processed++;
+    } else {
+        batch->failed++;
+    }
+    free(job->outputFile);
+    free(job);
+    return dipRefill(batch);
+}
+
+// Account for a request submitted for job (batch lock not held)
+// A request that was not queued never completes, so the job fails here instead;
+// job must not be touched once its request is queued. Returns reads claimed meanwhile
+static dipJob* dipSubmitted(dipBatch* batch, dipJob* job, bool queued, bool reading) {
+    dipJob *claimed = NULL;
+    pthread_mutex_lock(&batch->lock);
+    if (queued) {
+        batch->queued++;
+    } else {
+        fprintf(stderr, "%s: could not queue the I/O request\n", job->inputFile);
+        if (reading) {
+            batch->window--;
+        }
+        claimed = dipRetire(batch, job, false);
+    }
+    pthread_cond_signal(&batch->reapChanged);
+    pthread_mutex_unlock(&batch->lock);
+    return claimed;
+}
+
+// Submit the reads of claimed jobs (batch lock not held: opening a file may block)
+static void dipStart(dipBatch* batch, dipJob* jobs) {
+    while (jobs) {
+        dipJob *job = jobs;
+        jobs = job->next;
+        job->next = NULL;
+        job->submitted = now();
+        dipJob *claimed = dipSubmitted(batch, job, ioSubmitRead(batch->io, job->inputFile, job), true);
+        // A failed read frees budget for files that still have to start
+        if (claimed) {
+            dipJob *last = claimed;
+            while (last->next) {
+                last = last->next;
+            }
+            last->next = jobs;
+            jobs = claimed;
+        }
+    }
+}
+
+// Decode, process and encode one file, then hand the result to write-behind
+static void dipProcessJob(dipBatch* batch, dipJob* job) {
+    double start = now();
+
+    // Output keeps the input file name
+    const char *name = strrchr(job->inputFile, '/');
+    name = name ? name + 1 : job->inputFile;
+    job->outputFile = malloc(strlen(batch->outputDir) + strlen(name) + 2);
+    if (job->outputFile) {
+        sprintf(job->outputFile, "%s/%s", batch->outputDir, name);
+    }
+
+    // Decode (24-bit images are converted to greyscale by the pipeline)
+    traceSpan span = traceBegin("decode");
+    span.bytesRead = job->size;
+    int bitDepth = job->size >= BMP_HEADER_SIZE ? *(short*)&job->data[28] : 0;
+    BMP8Image *image8 = NULL;
+    BMP24Image *image24 = NULL;
+    if (job->size < 2 || job->data[0] != 'B' || job->data[1] != 'M') {
+        fprintf(stderr, "%s: not a BMP file\n", job->inputFile);
+    } else if (bitDepth == 8) {
+        image8 = BMP8Decode(job->data, job->size);
+    } else if (bitDepth == 24) {
+        image24 = BMP24Decode(job->data, job->size);
+    } else {
+        fprintf(stderr, "%s: not an 8-bit or 24-bit BMP\n", job->inputFile);
+    }
+    free(job->data);
+    job->data = NULL;
+    if (image8 || image24) {
+        span.bytesWritten = image8 ? (size_t)image8->imgSize : (size_t)image24->rowSize * image24->height;
+        span.pixels = image8 ? (size_t)image8->width * image8->height : (size_t)image24->width * image24->height;
+        span.allocations = 2;
+    }
+    traceEnd(&span);
+
+    // The whole chain runs as one fused pass
+    BMP8Image *result = NULL;
+    if (image8 || image24) {
+        span = traceBegin("pipeline");
+        pipeline *p = pipelineCreate();
+        pipeNode *source = image8 ? pipelineSource8(p, image8) : pipelineSource24(p, image24);
+        pipeNode *out = dipBuildChain(p, source, batch->ops, batch->opCount);
+        result = out ? pipelineRun(p, out) : NULL;
+        pipelineFree(p);
+        if (result) {
+            span.bytesRead = image8 ? (size_t)image8->imgSize : (size_t)image24->rowSize * image24->height;
+            span.bytesWritten = result->imgSize;
+            span.pixels = (size_t)result->width * result->height;
+        }
+        traceEnd(&span);
+    }
+    BMP8Free(image8);
+    BMP24Free(image24);
+
+    unsigned char *encoded = NULL;
+    size_t encodedSize = 0;
+    if (result) {
+        span = traceBegin("encode");
+        encoded = BMP8Encode(result, &encodedSize);
+        span.bytesRead = result->imgSize;
+        span.bytesWritten = encodedSize;
+        span.pixels = (size_t)result->width * result->height;
+        span.allocations = 1;
+        traceEnd(&span);
+        BMP8Free(result);
+    }
+    dipRecord(batch, STAGE_PROCESS, now() - start, encodedSize);
+
+    if (!encoded || !job->outputFile) {
+        free(encoded);
+        // Route the failure through the engine so the reaper accounts for it
+        dipStart(batch, dipSubmitted(batch, job, ioSubmitNop(batch->io, EINVAL, job), false));
+        return;
+    }
+
+    // Write-behind: the worker moves on while the engine writes the file
+    job->submitted = now();
+    dipStart(batch, dipSubmitted(batch, job, ioSubmitWrite(batch->io, job->outputFile, encoded, encodedSize, job), false));
+}
+
+// Compute worker: process prefetched files until the batch is done
+static void* dipWorker(void* arg) {
+    dipBatch *batch = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&batch->lock);
+        while (!batch->readyHead && !batch->done) {
+            pthread_cond_wait(&batch->readyChanged, &batch->lock);
+        }
+        dipJob *job = batch->readyHead;
+        if (!job) {
+            pthread_mutex_unlock(&batch->lock);
+            break;
+        }
+        batch->readyHead = job->next;
+        if (!batch->readyHead) {
+            batch->readyTail = NULL;
+        }
+        // Taking a file opens a slot in the prefetch window
+        batch->window--;
+        dipJob *claimed = dipRefill(batch);
+        pthread_mutex_unlock(&batch->lock);
+
+        dipStart(batch, claimed);
+        dipProcessJob(batch, job);
+    }
+    return NULL;
+}
+
+// Reaper: handle I/O completions on the calling thread until every file finished
+static bool dipReap(dipBatch* batch) {
+    pthread_mutex_lock(&batch->lock);
+    dipJob *claimed = dipRefill(batch);
+    for (;;) {
+        if (claimed) {
+            pthread_mutex_unlock(&batch->lock);
+            dipStart(batch, claimed);
+            pthread_mutex_lock(&batch->lock);
+            claimed = NULL;
+        }
+        if (batch->finished == batch->fileCount) {
+            break;
+        }
+        // Block on the engine only while a completion is sure to arrive; otherwise
+        // a worker is still processing or submitting and signals when it is done
+        if (batch->queued <= 0) {
+            pthread_cond_wait(&batch->reapChanged, &batch->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&batch->lock);
+        ioCompletion c;
+        if (!ioWaitCompletion(batch->io, &c)) {
+            // Release the workers so they can be joined
+            pthread_mutex_lock(&batch->lock);
+            batch->done = true;
+            pthread_cond_broadcast(&batch->readyChanged);
+            pthread_mutex_unlock(&batch->lock);
+            return false;
+        }
+        dipJob *job = c.user;
+        double latency = now() - job->submitted;
+        pthread_mutex_lock(&batch->lock);
+        batch->queued--;
+
+        if (c.kind == IO_READ) {
+            batch->stageSeconds[STAGE_READ] += latency;
+            batch->stageBytes[STAGE_READ] += c.size;
+            if (c.error) {
+                fprintf(stderr, "%s: %s\n", job->inputFile, strerror(c.error));
+                batch->window--;
+                claimed = dipRetire(batch, job, false);
+                continue;
+            }
+            // Queue the file for the compute workers
+            job->data = c.data;
+            job->size = c.size;
+            job->next = NULL;
+            if (batch->readyTail) {
+                batch->readyTail->next = job;
+            } else {
+                batch->readyHead = job;
+            }
+            batch->readyTail = job;
+            pthread_cond_signal(&batch->readyChanged);
+        } else if (c.kind == IO_WRITE) {
+            batch->stageSeconds[STAGE_WRITE] += latency;
+            batch->stageBytes[STAGE_WRITE] += c.size;
+            if (c.error) {
+                fprintf(stderr, "%s: %s\n", job->outputFile, strerror(c.error));
+            }
+            claimed = dipRetire(batch, job, c.error == 0);
+        } else {
+            // Processing failed
+            claimed = dipRetire(batch, job, false);
+        }
+    }
+
+    // Release the workers
+    batch->done = true;
+    pthread_cond_broadcast(&batch->readyChanged);
+    pthread_mutex_unlock(&batch->lock);
+    return true;
+}
+
+// Print per-stage and overall throughput of a finished batch
+static void dipReport(dipBatch* batch, double wallSeconds, int workers) {
+    printf("Processed %d file(s), %d failed, %d worker(s), %s I/O, %.3f s wall\n",
+           batch->processed, batch->failed, workers, ioEngineName(batch->io), wallSeconds);
+    printf("%-8s %10s %12s %12s\n", "stage", "time [s]", "files/s", "MB/s");
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        double seconds = batch->stageSeconds[s];
+        // Throughput of one request or worker spending its time in this stage
+        double filesPerSecond = seconds > 0 ? batch->processed / seconds : 0;
+        double megabytesPerSecond = seconds > 0 ? batch->stageBytes[s] / seconds / (1024.0 * 1024.0) : 0;
+        printf("%-8s %10.3f %12.1f %12.1f\n", stageNames[s], seconds, filesPerSecond, megabytesPerSecond);
+    }
+    if (wallSeconds > 0) {
+        printf("%-8s %10.3f %12.1f\n", "overall", wallSeconds, batch->processed / wallSeconds);
+    }
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s -c <chain> -o <output dir> [-j workers] [-m max MB in flight]\n"
+            "          [-p prefetch depth] [-t] [-T trace.json] <file|dir>...\n"
+            "Operators (comma separated, applied left to right):\n"
+            "  negative, brightness:<delta>, threshold:<level>, blur:<odd size>, sobel\n"
+            "24-bit inputs are converted to greyscale first.\n"
+            "Inputs are prefetched and outputs written behind the compute workers using\n"
+            "io_uring when available; -t forces the thread-backed fallback.\n"
+            "-T times decode, pipeline and encode of every file, prints a per-stage\n"
+            "summary and writes a Chrome trace (chrome://tracing, ui.perfetto.dev).\n"
+            "Example: %s -c blur:3,sobel,threshold:64 -o out ../Test_Images\n",
+            program, program);
+}
+
+int main(int argc, char** argv) {
+    const char *chain = NULL;
+    const char *outputDir = NULL;
+    int workers = 0;
+    int prefetch = 0;
+    bool allowUring = true;
+    long maxMegabytes = 256;
+    const char *traceFile = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:o:j:m:p:tT:h")) != -1) {
+        switch (opt) {
+            case 'c': chain = optarg; break;
+            case 'o': outputDir = optarg; break;
+            case 'j': workers = atoi(optarg); break;
+            case 'm': maxMegabytes = atol(optarg); break;
+            case 'p': prefetch = atoi(optarg); break;
+            case 't': allowUring = false; break;
+            case 'T': traceFile = optarg; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (!chain || !outputDir || optind == argc || maxMegabytes <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Parse the chain once; every file gets its own graph built from it
+    dipOp ops[64];
+    int opCount = dipParseChain(chain, ops, 64);
+    if (opCount < 0) {
+        return 1;
+    }
+
+    // Collect every input file
+    char **files = NULL;
+    int fileCount = 0, fileCapacity = 0;
+    for (int i = optind; i < argc; i++) {
+        dipCollect(argv[i], &files, &fileCount, &fileCapacity);
+    }
+    if (fileCount == 0) {
+        fprintf(stderr, "No input files.\n");
+        free(files);
+        return 1;
+    }
+    qsort(files, fileCount, sizeof(char*), compareNames);
+
+    // Estimate the memory held while each file is in flight (input + output) up front,
+    // so that refilling the prefetch window never waits on the file system
+    size_t *estimates = malloc(fileCount * sizeof(size_t));
+    if (!estimates) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+    for (int i = 0; i < fileCount; i++) {
+        struct stat st;
+        estimates[i] = stat(files[i], &st) == 0 ? 2 * (size_t)st.st_size : 0;
+    }
+
+    if (mkdir(outputDir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Cannot create directory %s\n", outputDir);
+        return 1;
+    }
+
+    if (workers <= 0) {
+        workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    workers = workers < 1 ? 1 : workers;
+    workers = workers > fileCount ? fileCount : workers;
+    // By default keep two files ready for every worker
+    if (prefetch <= 0) {
+        prefetch = 2 * workers;
+    }
+
+    dipBatch batch = {0};
+    batch.files = files;
+    batch.estimates = estimates;
+    batch.fileCount = fileCount;
+    batch.outputDir = outputDir;
+    batch.ops = ops;
+    batch.opCount = opCount;
+    batch.prefetchDepth = prefetch;
+    batch.maxInFlight = (size_t)maxMegabytes * 1024 * 1024;
+    // Ring depth covers the prefetch window plus one write per worker
+    batch.io = ioEngineCreate(prefetch + workers, allowUring, 2);
+    if (!batch.io) {
+        return 1;
+    }
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.readyChanged, NULL);
+    pthread_cond_init(&batch.reapChanged, NULL);
+
+    if (traceFile) {
+        traceEnable(true);
+    }
+
+    // Bounded pool of compute workers; the calling thread reaps I/O completions
+    double start = now();
+    pthread_t *threads = malloc(workers * sizeof(pthread_t));
+    int started = 0;
+    for (int i = 0; threads && i < workers; i++) {
+        if (pthread_create(&threads[i], NULL, dipWorker, &batch) != 0) {
+            break;
+        }
+        started++;
+    }
+    bool ok = started > 0;
+    if (!ok) {
+        fprintf(stderr, "Could not start any worker.\n");
+    } else {
+        ok = dipReap(&batch);
+        for (int i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    double wallSeconds = now() - start;
+
+    if (ok) {
+        dipReport(&batch, wallSeconds, started);
+    }
+    if (traceFile) {
+        traceSummary(stdout);
+        ok &= traceWriteChrome(traceFile);
+    }
+
+    ioEngineDestroy(batch.io);
+    pthread_cond_destroy(&batch.readyChanged);
+    pthread_cond_destroy(&batch.reapChanged);
+    pthread_mutex_destroy(&batch.lock);
+    free(threads);
+    for (int i = 0; i < fileCount; i++) {
+        free(files[i]);
+    }
+    free(files);
+    free(estimates);
+    return ok && batch.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdbool.h>
+#include "mask.h"
+
+// Define BMP header size
+#define BMP_HEADER_SIZE 54
+// Size of color table for 8-bit BMP
+#define BMP_COLOR_TABLE_SIZE 1024
+
+// Structure to hold 8-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
+    unsigned char colorTable[BMP_COLOR_TABLE_SIZE]; // Color table for 8-bit BMP (256 * 4 bytes)
+    unsigned char *data;                            // Pointer to pixel data
+    int width;                                      // Image width in pixels
+    int height;                                     // Image height in pixels
+    int bitDepth;                                   // Bits per pixel (8 for grayscale)
+    int imgSize;                                    // Total size of pixel data in bytes
+} BMP8Image;
+
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
+// Kind of operator held by a pipeline node
+typedef enum {
+    NODE_SOURCE8,       // 8-bit source image
+    NODE_SOURCE24,      // 24-bit source image, converted to greyscale while read
+    NODE_POINT,         // Per-pixel operator expressed as a 256-entry lookup table
+    NODE_BLUR,          // size x size box blur, border pixels copied unchanged
+    NODE_CONVOLUTION,   // Arbitrary mask, zero padded and clamped to [0, 255]
+    NODE_SOBEL          // Combined Sobel edge magnitude
+} pipeNodeKind;
+
+// One operator of a lazy pipeline graph
+// Nodes only describe work; nothing is computed until pipelineRun is called
+typedef struct pipeNode {
+    pipeNodeKind kind;          // Operator kind
+    struct pipeNode *input;     // Node producing the input (NULL for sources)
+    BMP8Image *source8;         // Source image for NODE_SOURCE8
+    BMP24Image *source24;       // Source image for NODE_SOURCE24
+    unsigned char lut[256];     // Lookup table for NODE_POINT
+    unsigned int size;          // Kernel side for NODE_BLUR
+    mask *m;                    // Private copy of the mask for NODE_CONVOLUTION
+    struct pipeNode *next;      // Next node owned by the same pipeline
+} pipeNode;
+
+// Owner of all nodes created for one graph
+typedef struct {
+    pipeNode *nodes;            // Singly linked list of every node, freed together
+} pipeline;
+
+/**
+ * @brief Create an empty pipeline.
+ *
+ * @return Pointer to the new pipeline, or NULL if allocation fails.
+ */
+pipeline* pipelineCreate(void);
+
+/**
+ * @brief Free a pipeline and every node created through it.
+ *
+ * Source images are owned by the caller and are not freed.
+ *
+ * @param p Pointer to the pipeline to be freed.
+ */
+void pipelineFree(pipeline* p);
+
+/**
+ * @brief Start a graph from an 8-bit image.
+ *
+ * @param p Pipeline owning the node.
+ * @param img Source image; must stay valid until the last run.
+ * @return New node, or NULL on error.
+ */
+pipeNode* pipelineSource8(pipeline* p, BMP8Image* img);
+
+/**
+ * @brief Start a graph from a 24-bit image converted to greyscale while read.
+ *
+ * @param p Pipeline owning the node.
+ * @param img Source image; must stay valid until the last run.
+ * @return New node, or NULL on error.
+ */
+pipeNode* pipelineSource24(pipeline* p, BMP24Image* img);
+
+/**
+ * @brief Apply an arbitrary 256-entry lookup table to every pixel.
+ *
+ * All operators below return NULL when in is NULL, so calls can be
+ * chained and checked once at the end.
+ *
+ * @param p Pipeline owning the node.
+ * @param in Node producing the input.
+ * @param lut Table mapping every input value to its output value.
+ * @return New node, or NULL on error.
+ */
+pipeNode* pipelineLookup(pipeline* p, pipeNode* in, const unsigned char lut[256]);
+
+/**
+ * @brief Invert every pixel (same result as BMP8Negative).
+ */
+pipeNode* pipelineNegative(pipeline* p, pipeNode* in);
+
+/**
+ * @brief Add delta to every pixel, clamped to [0, 255].
+ */
+pipeNode* pipelineBrightness(pipeline* p, pipeNode* in, int delta);
+
+/**
+ * @brief Pixels above threshold become white, the rest black (same result as BMP8Binarize).
+ */
+pipeNode* pipelineThreshold(pipeline* p, pipeNode* in, int threshold);
+
+/**
+ * @brief Box blur with an odd size x size kernel (same result as BMP8Blur).
+ */
+pipeNode* pipelineBlur(pipeline* p, pipeNode* in, unsigned int size);
+
+/**
+ * @brief Convolution with an arbitrary mask (same result as BMP8Convolution).
+ *
+ * The mask is copied, so the caller may free it right away.
+ */
+pipeNode* pipelineConvolution(pipeline* p, pipeNode* in, mask* m);
+
+/**
+ * @brief Combined Sobel edge magnitude (same result as BMP8EdgeDetectionSobelCombined).
+ */
+pipeNode* pipelineSobel(pipeline* p, pipeNode* in);
+
+/**
+ * @brief Evaluate the graph ending at out in one fused pass, writing into dst.
+ *
+ * Runs of point operators are folded into one lookup table and every
+ * neighborhood operator streams through a small line buffer, so no
+ * intermediate image is allocated.
+ *
+ * @param p Pipeline owning the nodes.
+ * @param out Last node of the chain to evaluate.
+ * @param dst Image with the size of the source; may alias an 8-bit
+ *            source only when the chain contains point operators alone.
+ * @return true on success, false on error.
+ */
+bool pipelineRunInto(pipeline* p, pipeNode* out, BMP8Image* dst);
+
+/**
+ * @brief Evaluate the graph ending at out into a newly allocated image.
+ *
+ * @param p Pipeline owning the nodes.
+ * @param out Last node of the chain to evaluate.
+ * @return Result image (free with BMP8Free), or NULL on error.
+ */
+BMP8Image* pipelineRun(pipeline* p, pipeNode* out);
+
+#endif // PIPELINE_H
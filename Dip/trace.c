@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "trace.h"
+
+// Largest number of spans kept for the Chrome trace; the summary keeps counting beyond it
+#define TRACE_MAX_EVENTS (1 << 20)
+// Largest number of distinct stage names in the summary
+#define TRACE_MAX_STAGES 64
+
+// One recorded span
+typedef struct {
+    traceSpan span;
+    double duration;
+    int thread;
+} traceEvent;
+
+// Totals of one stage
+typedef struct {
+    const char *name;
+    long calls;
+    double seconds;
+    size_t bytesRead;
+    size_t bytesWritten;
+    size_t pixels;
+    size_t allocations;
+} traceStage;
+
+bool traceEnabled = false;
+
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;
+static traceEvent *events = NULL;
+static int eventCount = 0;
+static int eventCapacity = 0;
+static long droppedEvents = 0;
+static traceStage stages[TRACE_MAX_STAGES];
+static int stageCount = 0;
+static double origin = 0.0;
+
+// Small per-thread number used as the Chrome trace thread id
+static atomic_int nextThread = 1;
+static _Thread_local int threadId = 0;
+
+double traceNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void traceEnable(bool enabled) {
+    pthread_mutex_lock(&traceLock);
+    if (enabled && origin == 0.0) {
+        origin = traceNow();
+    }
+    traceEnabled = enabled;
+    pthread_mutex_unlock(&traceLock);
+}
+
+// Find or add the summary entry of a stage (trace lock held)
+static traceStage* findStage(const char* name) {
+    for (int i = 0; i < stageCount; i++) {
+        if (stages[i].name == name || strcmp(stages[i].name, name) == 0) {
+            return &stages[i];
+        }
+    }
+    if (stageCount == TRACE_MAX_STAGES) {
+        return NULL;
+    }
+    traceStage *stage = &stages[stageCount++];
+    memset(stage, 0, sizeof(traceStage));
+    stage->name = name;
+    return stage;
+}
+
+void traceRecord(traceSpan* span) {
+    double duration = traceNow() - span->start;
+    if (threadId == 0) {
+        threadId = atomic_fetch_add(&nextThread, 1);
+    }
+
+    pthread_mutex_lock(&traceLock);
+    traceStage *stage = findStage(span->name);
+    if (stage) {
+        stage->calls++;
+        stage->seconds += duration;
+        stage->bytesRead += span->bytesRead;
+        stage->bytesWritten += span->bytesWritten;
+        stage->pixels += span->pixels;
+        stage->allocations += span->allocations;
+    }
+
+    // Grow the event array if needed
+    if (eventCount == eventCapacity && eventCapacity < TRACE_MAX_EVENTS) {
+        int capacity = eventCapacity ? eventCapacity * 2 : 1024;
+        traceEvent *grown = realloc(events, capacity * sizeof(traceEvent));
+        if (grown) {
+            events = grown;
+            eventCapacity = capacity;
+        }
+    }
+    if (eventCount < eventCapacity) {
+        traceEvent *event = &events[eventCount++];
+        event->span = *span;
+        event->duration = duration;
+        event->thread = threadId;
+    } else {
+        droppedEvents++;
+    }
+    pthread_mutex_unlock(&traceLock);
+}
+
+void traceSummary(FILE* out) {
+    pthread_mutex_lock(&traceLock);
+    fprintf(out, "%-24s %8s %11s %11s %10s %10s %10s %8s %9s\n",
+            "stage", "calls", "total [ms]", "avg [ms]", "read MB", "write MB", "MPixels", "allocs", "MP/s");
+    for (int i = 0; i < stageCount; i++) {
+        traceStage *s = &stages[i];
+        double megapixels = s->pixels / 1e6;
+        fprintf(out, "%-24s %8ld %11.3f %11.3f %10.2f %10.2f %10.2f %8zu %9.1f\n",
+                s->name, s->calls, s->seconds * 1e3, s->seconds * 1e3 / s->calls,
+                s->bytesRead / (1024.0 * 1024.0), s->bytesWritten / (1024.0 * 1024.0),
+                megapixels, s->allocations, s->seconds > 0 ? megapixels / s->seconds : 0.0);
+    }
+    if (droppedEvents > 0) {
+        fprintf(out, "(%ld spans not kept for the trace file)\n", droppedEvents);
+    }
+    pthread_mutex_unlock(&traceLock);
+}
+
+bool traceWriteChrome(const char* filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Unable to create file %s!\n", filename);
+        return false;
+    }
+
+    // Complete ("X") events with microsecond timestamps relative to traceEnable
+    pthread_mutex_lock(&traceLock);
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    for (int i = 0; i < eventCount; i++) {
+        traceEvent *e = &events[i];
+        fprintf(file, "%s\n  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                      "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"bytes_read\": %zu, "
+                      "\"bytes_written\": %zu, \"pixels\": %zu, \"allocations\": %zu}}",
+                i ? "," : "", e->span.name, e->thread,
+                (e->span.start - origin) * 1e6, e->duration * 1e6,
+                e->span.bytesRead, e->span.bytesWritten, e->span.pixels, e->span.allocations);
+    }
+    fprintf(file, "\n]}\n");
+    pthread_mutex_unlock(&traceLock);
+
+    bool ok = !ferror(file);
+    ok &= fclose(file) == 0;
+    return ok;
+}
+
+void traceReset(void) {
+    pthread_mutex_lock(&traceLock);
+    free(events);
+    events = NULL;
+    eventCount = 0;
+    eventCapacity = 0;
+    droppedEvents = 0;
+    stageCount = 0;
+    pthread_mutex_unlock(&traceLock);
+}
@@ -0,0 +1,134 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Row function of a fixed-size integer convolution kernel.
+ *
+ * Convolves the output columns [x, xEnd) of one row, all of which must have
+ * every tap inside the image. Results are clamped to [0, 255].
+ *
+ * @param top Image row under the top row of the mask.
+ * @param rowSize Distance between image rows in bytes.
+ * @param x First output column.
+ * @param xEnd One past the last output column.
+ * @param out Output row.
+ * @param taps Coefficients in row-major order (ignored by constant kernels).
+ * @param vector true when every sum fits in 16 bits, allowing the SSE2 path.
+ */
+typedef void (*kernelRow)(const unsigned char* top, int rowSize, int x, int xEnd,
+                          unsigned char* out, const int* taps, bool vector);
+
+/**
+ * @brief Integer mask whose coefficients are known at compile time.
+ *
+ * Define one with CONSTANT_KERNEL and apply it with BMP8ConvolutionKernelInto.
+ */
+typedef struct {
+    int rows;           /// number of rows in the mask
+    int cols;           /// number of columns in the mask
+    const int *taps;    /// coefficients in row-major order
+    kernelRow row;      /// row function specialized for these coefficients
+} constantKernel;
+
+#ifdef __SSE2__
+// 8 pixels per iteration in 16-bit lanes; with CONSTANT set zero taps vanish and
+// +-1 taps become additions and subtractions
+#define KERNEL_VECTOR_LOOP(R, C, TAPS, CONSTANT)                                        \
+    if (vector) {                                                                       \
+        const __m128i zero = _mm_setzero_si128();                                       \
+        for (; x + 8 <= xEnd; x += 8) {                                                 \
+            __m128i acc = zero;                                                         \
+            _Pragma("GCC unroll 8")                                                     \
+            for (int i = 0; i < (R); i++) {                                             \
+                const unsigned char *src = top + (size_t)i * rowSize + x - (C) / 2;     \
+                _Pragma("GCC unroll 8")                                                 \
+                for (int j = 0; j < (C); j++) {                                         \
+                    int c = (TAPS)[i * (C) + j];                                        \
+                    if ((CONSTANT) && c == 0) {                                         \
+                        continue;                                                       \
+                    }                                                                   \
+                    __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + j)), zero); \
+                    if ((CONSTANT) && c == 1) {                                         \
+                        acc = _mm_add_epi16(acc, px);                                   \
+                    } else if ((CONSTANT) && c == -1) {                                 \
+                        acc = _mm_sub_epi16(acc, px);                                   \
+                    } else {                                                            \
+                        acc = _mm_add_epi16(acc, _mm_mullo_epi16(px, _mm_set1_epi16((short)c))); \
+                    }                                                                   \
+                }                                                                       \
+            }                                                                           \
+            _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(acc, acc));          \
+        }                                                                               \
+    }
+#else
+#define KERNEL_VECTOR_LOOP(R, C, TAPS, CONSTANT)
+#endif
+
+/**
+ * @brief Define a kernelRow named name for an R x C mask.
+ *
+ * Both loops over the mask have constant trip counts and are fully
+ * unrolled. TAPS is the coefficient array: the taps parameter for masks
+ * known only at run time, or a static const array, in which case every
+ * coefficient is a compile-time constant and CONSTANT should be 1 so
+ * per-tap special cases fold away instead of becoming branches.
+ */
+#define KERNEL_ROW(name, R, C, TAPS, CONSTANT)                                          \
+    static void name(const unsigned char* top, int rowSize, int x, int xEnd,            \
+                     unsigned char* out, const int* taps, bool vector) {                \
+        (void)taps;                                                                     \
+        (void)vector;                                                                   \
+        KERNEL_VECTOR_LOOP(R, C, TAPS, CONSTANT)                                        \
+        for (; x < xEnd; x++) {                                                         \
+            int val = 0;                                                                \
+            _Pragma("GCC unroll 8")                                                     \
+            for (int i = 0; i < (R); i++) {                                             \
+                const unsigned char *src = top + (size_t)i * rowSize + x - (C) / 2;     \
+                _Pragma("GCC unroll 8")                                                 \
+                for (int j = 0; j < (C); j++) {                                         \
+                    val += (TAPS)[i * (C) + j] * src[j];                                \
+                }                                                                       \
+            }                                                                           \
+            out[x] = (unsigned char)(val < 0 ? 0 : val > 255 ? 255 : val);              \
+        }                                                                               \
+    }
+
+/**
+ * @brief Define a constantKernel named name from R * C integer coefficients.
+ *
+ * Example: CONSTANT_KERNEL(sobelHorizontal, 3, 3, -1, -2, -1, 0, 0, 0, 1, 2, 1)
+ */
+#define CONSTANT_KERNEL(name, R, C, ...)                                                \
+    static const int name##Taps[(R) * (C)] = {__VA_ARGS__};                             \
+    KERNEL_ROW(name##Row, R, C, name##Taps, 1)                                          \
+    static const constantKernel name = {R, C, name##Taps, name##Row};
+
+// Row functions for the common mask sizes with coefficients known at run time
+KERNEL_ROW(kernelRow2x2, 2, 2, taps, 0)
+KERNEL_ROW(kernelRow3x3, 3, 3, taps, 0)
+KERNEL_ROW(kernelRow5x5, 5, 5, taps, 0)
+KERNEL_ROW(kernelRow7x7, 7, 7, taps, 0)
+
+/**
+ * @brief Specialized row function for a rows x cols mask, or NULL for other sizes.
+ */
+static inline kernelRow kernelRowFor(int rows, int cols) {
+    if (rows != cols) {
+        return NULL;
+    }
+    switch (rows) {
+        case 2: return kernelRow2x2;
+        case 3: return kernelRow3x3;
+        case 5: return kernelRow5x5;
+        case 7: return kernelRow7x7;
+        default: return NULL;
+    }
+}
+
+#endif // KERNELS_H
@@ -3,8 +3,13 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "mask.h"
+#include "kernels.h"
+#include "taskgraph.h"
 
 // Define BMP header size
 #define BMP_HEADER_SIZE 54
@@ -30,6 +35,16 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
     // open file
@@ -80,50 +95,216 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-// Function to apply convolution with a given mask to an 8-bit BMP image
-BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
-    if(!img || !m){
-        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
     // Allocate memory for new image
-    BMP8Image* convImg = malloc(sizeof(BMP8Image));
-    if(!convImg){
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
     // Copy BMP header and metadata
-    memcpy(convImg->header, img->header, BMP_HEADER_SIZE);
-    convImg->width = img->width;
-    convImg->height = img->height;
-    convImg->bitDepth = img->bitDepth;
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
     // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(convImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
     // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    convImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
-    // Allocate memory for pixel data of the result
-    convImg->data = malloc(convImg->imgSize);
-    if (!convImg->data) {
+    // Allocate memory for pixel data
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(convImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Copy the coefficients of m into taps when all of them are whole numbers
+// Returns the sum of their magnitudes, or -1 when the mask needs the float path
+// (fractional coefficients, or sums too large to stay exact in float)
+static int maskIntegerTaps(mask* m, int* taps){
+    int absSum = 0;
+    for(unsigned int i = 0; i < m->rows * m->cols; i++){
+        float c = m->data[i];
+        if(c > 65535.0f || c < -65535.0f || c != (float)(int)c){
+            return -1;
+        }
+        taps[i] = (int)c;
+        absSum += abs(taps[i]);
+        // Float accumulation is exact below 2^24
+        if((long)absSum * MAX_BRIGHTNESS >= (1L << 24)){
+            return -1;
+        }
+    }
+    return absSum;
+}
+
+// Integer convolution of one pixel; taps outside the image are skipped (zero padding)
+static unsigned char convolveIntegerPixel(BMP8Image* img, int rowSize, const int* taps, int rows, int cols, int x, int y){
+    int val = 0;
+    for(int i = 0; i < rows; i++){
+        int idy = y + (i - rows / 2);
+        if(idy < 0 || idy >= img->height){
+            continue;
+        }
+        for(int j = 0; j < cols; j++){
+            int idx = x + (j - cols / 2);
+            if(idx >= 0 && idx < img->width){
+                val += taps[i * cols + j] * img->data[idy * rowSize + idx];
+            }
+        }
+    }
+    return (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+}
+
+// Convolution with integer taps, pixel for pixel equal to the float path
+// Where the whole mask is inside the image, sums use 16-bit lanes with a saturating
+// pack when they fit (absSum * 255 <= 32767) and 32-bit scalar accumulation otherwise
+// row, when given, is an unrolled kernel for this mask size or these coefficients
+static void BMP8ConvolutionInteger(BMP8Image* img, const int* taps, int rows, int cols, int absSum, kernelRow row, BMP8Image* dst){
+    int rowSize = (img->width + 3) & ~3;
+    int iCenter = rows / 2;
+    int jCenter = cols / 2;
+
+    // Rows and columns where every tap lies inside the image
+    int yBegin = iCenter, yEnd = img->height - (rows - 1 - iCenter);
+    int xBegin = jCenter, xEnd = img->width - (cols - 1 - jCenter);
+
+    for(int y = 0; y < img->height; y++){
+        unsigned char* out = dst->data + (size_t)y * rowSize;
+        if(y < yBegin || y >= yEnd || xBegin >= xEnd){
+            for(int x = 0; x < img->width; x++){
+                out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+            }
+            continue;
+        }
+
+        for(int x = 0; x < xBegin; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+        int x = xBegin;
+        if(row){
+            row(img->data + (size_t)(y - iCenter) * rowSize, rowSize, x, xEnd, out, taps, absSum * MAX_BRIGHTNESS <= 32767);
+            x = xEnd;
+        }
+#ifdef __SSE2__
+        // Vector path: 8 pixels per iteration, twice the lanes of a float kernel
+        if(absSum * MAX_BRIGHTNESS <= 32767){
+            const __m128i zero = _mm_setzero_si128();
+            for(; x + 8 <= xEnd; x += 8){
+                __m128i acc = zero;
+                for(int i = 0; i < rows; i++){
+                    const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                    for(int j = 0; j < cols; j++){
+                        int c = taps[i * cols + j];
+                        if(c != 0){
+                            __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + j)), zero);
+                            acc = _mm_add_epi16(acc, _mm_mullo_epi16(px, _mm_set1_epi16((short)c)));
+                        }
+                    }
+                }
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(acc, acc));
+            }
+        }
+#endif
+        // Scalar path (and tail): no bounds checks inside the image
+        for(; x < xEnd; x++){
+            int val = 0;
+            for(int i = 0; i < rows; i++){
+                const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                for(int j = 0; j < cols; j++){
+                    val += taps[i * cols + j] * src[j];
+                }
+            }
+            out[x] = (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+        }
+        for(; x < img->width; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+    }
+}
+
+// Function to apply convolution with a given mask, writing into a caller-supplied image
+// dst must have the size of img and must not alias it (neighbors are read after writes)
+bool BMP8ConvolutionInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    // Integral masks (Sobel, Prewitt, Kirsch, Laplacian, ...) take the exact integer path
+    int* taps = malloc(m->rows * m->cols * sizeof(int));
+    int absSum = taps ? maskIntegerTaps(m, taps) : -1;
+    if(absSum >= 0){
+        BMP8ConvolutionInteger(img, taps, m->rows, m->cols, absSum, kernelRowFor(m->rows, m->cols), dst);
+        free(taps);
+        return true;
+    }
+    free(taps);
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
 
     // Compute center of the mask (for correct alignment during convolution)
     int iCenter = m->rows / 2;
     int jCenter = m->cols / 2;
 
     // Iterate through every pixel in the image
-    for(int y = 0; y < convImg->height; y++){
-        for(int x = 0; x < convImg->width; x++){
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
             float val = 0.0f;
 
             // Apply convolution mask
@@ -146,315 +327,308 @@ BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
             val = MAX(val, MIN_BRIGHTNESS);
 
             // Store result pixel
-            convImg->data[y * convImg->width + x] = (unsigned char)val;
+            dst->data[y * rowSize + x] = (unsigned char)val;
         }
     }
 
-    return convImg;
+    return true;
 }
 
-BMP8Image* BMP8EdgeDetectionKirschNorth(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+// Apply an integer mask fixed at compile time (see CONSTANT_KERNEL), writing into a
+// caller-supplied image; same result as BMP8ConvolutionInto with the equivalent mask
+bool BMP8ConvolutionKernelInto(BMP8Image* img, const constantKernel* k, BMP8Image* dst){
+    if(!img || !k){
+        fprintf(stderr, "Convolution Error: Either there is no image or kernel.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    int absSum = 0;
+    for(int i = 0; i < k->rows * k->cols; i++){
+        absSum += abs(k->taps[i]);
+    }
+    BMP8ConvolutionInteger(img, k->taps, k->rows, k->cols, absSum, k->row, dst);
+    return true;
+}
+
+// Function to apply convolution with a given mask to an 8-bit BMP image
+BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
         return NULL;
     }
 
-    // Create a 3x3 Kirsch mask (North direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8ConvolutionInto(img, m, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
 
-    // Kirsch North kernel
-    int maskR[3][3] = {
-        { 5,  5,  5},
-        {-3,  0, -3},
-        {-3, -3, -3}
-    };
+// Kirsch North kernel
+CONSTANT_KERNEL(kirschNorth, 3, 3,
+     5,  5,  5,
+    -3,  0, -3,
+    -3, -3, -3)
 
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
+bool BMP8EdgeDetectionKirschNorthInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschNorth, dst);
 
-    // Free mask memory
-    maskFree(m);
+    // Report whether dst was filled
+    return ok;
+}
 
-    // Return resulting edge image
-    return convolved;
+// Allocating variant of BMP8EdgeDetectionKirschNorthInto
+BMP8Image* BMP8EdgeDetectionKirschNorth(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8EdgeDetectionKirschNorthInto(img, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
-BMP8Image* BMP8EdgeDetectionKirschNorthWest(BMP8Image* img){
+// Kirsch North-West kernel
+CONSTANT_KERNEL(kirschNorthWest, 3, 3,
+     5,  5, -3,
+     5,  0, -3,
+    -3, -3, -3)
+
+bool BMP8EdgeDetectionKirschNorthWestInto(BMP8Image* img, BMP8Image* dst){
     if(!img){
         fprintf(stderr, "Edge Detection Error: No image provided.\n");
-        return NULL;
+        return false;
     }
 
-    // Create a 3x3 Kirsch mask (North-West direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschNorthWest, dst);
+
+    // Report whether dst was filled
+    return ok;
+}
+
+// Allocating variant of BMP8EdgeDetectionKirschNorthWestInto
+BMP8Image* BMP8EdgeDetectionKirschNorthWest(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8EdgeDetectionKirschNorthWestInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
 
-    // Kirsch North-West kernel
-    int maskR[3][3] = {
-        {  5,  5, -3},
-        {  5,  0, -3},
-        { -3, -3, -3}
-    };
+// Kirsch West kernel
+CONSTANT_KERNEL(kirschWest, 3, 3,
+     5, -3, -3,
+     5,  0, -3,
+     5, -3, -3)
 
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
+bool BMP8EdgeDetectionKirschWestInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschWest, dst);
 
-    // Free mask memory
-    maskFree(m);
-
-    // Return resulting edge image
-    return convolved;
+    // Report whether dst was filled
+    return ok;
 }
 
+// Allocating variant of BMP8EdgeDetectionKirschWestInto
 BMP8Image* BMP8EdgeDetectionKirschWest(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
         return NULL;
     }
-
-    // Create a 3x3 Kirsch mask (West direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    if(!BMP8EdgeDetectionKirschWestInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
 
-    // Kirsch West kernel
-    int maskR[3][3] = {
-        {  5, -3, -3},
-        {  5,  0, -3},
-        {  5, -3, -3}
-    };
+// Kirsch South-West kernel
+CONSTANT_KERNEL(kirschSouthWest, 3, 3,
+    -3, -3, -3,
+     5,  0, -3,
+     5,  5, -3)
 
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
+bool BMP8EdgeDetectionKirschSouthWestInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
-
-    // Free mask memory
-    maskFree(m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschSouthWest, dst);
 
-    // Return resulting edge image
-    return convolved;
+    // Report whether dst was filled
+    return ok;
 }
 
+// Allocating variant of BMP8EdgeDetectionKirschSouthWestInto
 BMP8Image* BMP8EdgeDetectionKirschSouthWest(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
         return NULL;
     }
-
-    // Create a 3x3 Kirsch mask (South-West direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    if(!BMP8EdgeDetectionKirschSouthWestInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
 
-    // Kirsch South-West kernel
-    int maskR[3][3] = {
-        { -3, -3, -3},
-        {  5,  0, -3},
-        {  5,  5, -3}
-    };
+// Kirsch East kernel
+CONSTANT_KERNEL(kirschEast, 3, 3,
+    -3, -3,  5,
+    -3,  0,  5,
+    -3, -3,  5)
 
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
+bool BMP8EdgeDetectionKirschEastInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschEast, dst);
 
-    // Free mask memory
-    maskFree(m);
-
-    // Return resulting edge image
-    return convolved;
+    // Report whether dst was filled
+    return ok;
 }
 
+// Allocating variant of BMP8EdgeDetectionKirschEastInto
 BMP8Image* BMP8EdgeDetectionKirschEast(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
         return NULL;
     }
-
-    // Create a 3x3 Kirsch mask (East direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    if(!BMP8EdgeDetectionKirschEastInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
 
-    // Kirsch East kernel
-    int maskR[3][3] = {
-        { -3, -3,  5},
-        { -3,  0,  5},
-        { -3, -3,  5}
-    };
+// Kirsch North-East kernel
+CONSTANT_KERNEL(kirschNorthEast, 3, 3,
+    -3,  5,  5,
+    -3,  0,  5,
+    -3, -3, -3)
 
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
+bool BMP8EdgeDetectionKirschNorthEastInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschNorthEast, dst);
 
-    // Free mask memory
-    maskFree(m);
-
-    // Return resulting edge image
-    return convolved;
+    // Report whether dst was filled
+    return ok;
 }
 
+// Allocating variant of BMP8EdgeDetectionKirschNorthEastInto
 BMP8Image* BMP8EdgeDetectionKirschNorthEast(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
         return NULL;
     }
-
-    // Create a 3x3 Kirsch mask (North-East direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    if(!BMP8EdgeDetectionKirschNorthEastInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
 
-    // Kirsch North-East kernel
-    int maskR[3][3] = {
-        { -3,  5,  5},
-        { -3,  0,  5},
-        { -3, -3, -3}
-    };
+// Kirsch South kernel
+CONSTANT_KERNEL(kirschSouth, 3, 3,
+    -3, -3, -3,
+    -3,  0, -3,
+     5,  5,  5)
 
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
+bool BMP8EdgeDetectionKirschSouthInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
-
-    // Free mask memory
-    maskFree(m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschSouth, dst);
 
-    // Return resulting edge image
-    return convolved;
+    // Report whether dst was filled
+    return ok;
 }
 
+// Allocating variant of BMP8EdgeDetectionKirschSouthInto
 BMP8Image* BMP8EdgeDetectionKirschSouth(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
         return NULL;
     }
-
-    // Create a 3x3 Kirsch mask (South direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    if(!BMP8EdgeDetectionKirschSouthInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
 
-    // Kirsch South kernel
-    int maskR[3][3] = {
-        { -3, -3, -3},
-        { -3,  0, -3},
-        {  5,  5,  5}
-    };
+// Kirsch South-East kernel
+CONSTANT_KERNEL(kirschSouthEast, 3, 3,
+    -3, -3, -3,
+    -3,  0,  5,
+    -3,  5,  5)
 
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
+bool BMP8EdgeDetectionKirschSouthEastInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &kirschSouthEast, dst);
 
-    // Free mask memory
-    maskFree(m);
-
-    // Return resulting edge image
-    return convolved;
+    // Report whether dst was filled
+    return ok;
 }
 
+// Allocating variant of BMP8EdgeDetectionKirschSouthEastInto
 BMP8Image* BMP8EdgeDetectionKirschSouthEast(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
         return NULL;
     }
-
-    // Create a 3x3 Kirsch mask (South-East direction)
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    if(!BMP8EdgeDetectionKirschSouthEastInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
-
-    // Kirsch South-East kernel
-    int maskR[3][3] = {
-        { -3, -3, -3},
-        { -3,  0,  5},
-        { -3,  5,  5}
-    };
-
-    // Copy kernel values into mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = maskR[i][j];
-        }
-    }
-
-    // Apply convolution with Kirsch mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
-
-    // Free mask memory
-    maskFree(m);
-
-    // Return resulting edge image
-    return convolved;
-}
-
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
-        free(img);
-    }
+    return dst;
 }
 
 // Function to save an 8-bit BMP image to a file
@@ -476,19 +650,203 @@ void BMP8save(const char* filename, BMP8Image* img) {
     fclose(fOutput);
 }
 
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Signature of an 8-bit operator that can be applied to every color channel
+typedef BMP8Image* (*BMP8Operator)(BMP8Image* img);
+
+// Apply an 8-bit operator to each channel of a 24-bit BMP image
+// The channels are split once into 8-bit planes and processed in parallel
+BMP24Image* BMP24ApplyPerChannel(BMP24Image* img, BMP8Operator op){
+    if(!img || !op){
+        fprintf(stderr, "Edge Detection Error: Either there is no image or operator.\n");
+        return NULL;
+    }
+
+    // Allocate memory for the new image
+    BMP24Image* outImg = malloc(sizeof(BMP24Image));
+    if(!outImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(outImg->header, img->header, BMP_HEADER_SIZE);
+    outImg->width = img->width;
+    outImg->height = img->height;
+    outImg->bitDepth = img->bitDepth;
+    outImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    outImg->data = calloc(img->rowSize * img->height, 1);
+    if (!outImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(outImg);
+        return NULL;
+    }
+
+    // Row size of an 8-bit plane (padded to 4 bytes)
+    int rowSize8 = (img->width + 3) & ~3;
+    int failed = 0;
+
+    #pragma omp parallel for reduction(|:failed)
+    for(int c = 0; c < 3; c++){
+        // Describe channel c as an 8-bit greyscale image
+        BMP8Image plane;
+        memcpy(plane.header, img->header, BMP_HEADER_SIZE);
+        plane.width = img->width;
+        plane.height = img->height;
+        plane.bitDepth = 8;
+        plane.imgSize = rowSize8 * img->height;
+        *(short*)&plane.header[28] = 8;
+        *(int*)&plane.header[10] = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE;
+        *(int*)&plane.header[34] = plane.imgSize;
+        for(int i = 0; i < 256; i++){
+            plane.colorTable[i*4 + 0] = i;
+            plane.colorTable[i*4 + 1] = i;
+            plane.colorTable[i*4 + 2] = i;
+            plane.colorTable[i*4 + 3] = 0;
+        }
+
+        plane.data = calloc(plane.imgSize, 1);
+        if(!plane.data){
+            failed = 1;
+            continue;
+        }
+
+        // Extract the channel
+        for(int y = 0; y < img->height; y++){
+            const unsigned char* src = img->data + y * img->rowSize + c;
+            unsigned char* dst = plane.data + y * rowSize8;
+            for(int x = 0; x < img->width; x++){
+                dst[x] = src[x * 3];
+            }
+        }
+
+        // Run the 8-bit operator and merge its result back into channel c
+        BMP8Image* result = op(&plane);
+        if(!result){
+            failed = 1;
+        } else {
+            for(int y = 0; y < img->height; y++){
+                const unsigned char* src = result->data + y * rowSize8;
+                unsigned char* dst = outImg->data + y * outImg->rowSize + c;
+                for(int x = 0; x < img->width; x++){
+                    dst[x * 3] = src[x];
+                }
+            }
+            BMP8Free(result);
+        }
+        free(plane.data);
+    }
+
+    if(failed){
+        fprintf(stderr, "Edge Detection Error: Operator failed on a color channel.\n");
+        BMP24Free(outImg);
+        return NULL;
+    }
+    return outImg;
+}
+
+// One branch of the demo graph: a directional operator and the file its result goes to
+typedef struct {
+    BMP8Image *source;      // Shared read-only input
+    BMP8Operator op;        // Directional edge operator
+    const char *outputFile; // Where the result is saved
+    BMP8Image *result;      // Filled by the compute task
+} edgeBranch;
+
+// Task: run the branch operator on the shared source image
+static void computeBranch(void* arg) {
+    edgeBranch *branch = arg;
+    branch->result = branch->op(branch->source);
+}
+
+// Task: save and free the branch result as soon as it has been computed
+static void saveBranch(void* arg) {
+    edgeBranch *branch = arg;
+    if (branch->result) {
+        BMP8save(branch->outputFile, branch->result);
+        BMP8Free(branch->result);
+        branch->result = NULL;
+    }
+}
+
 int main() {
     const char *inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
 
-    // Output files for each direction
-    const char *outN  = "images/lizard_Kirsch_N.bmp";
-    const char *outNW = "images/lizard_Kirsch_NW.bmp";
-    const char *outW  = "images/lizard_Kirsch_W.bmp";
-    const char *outSW = "images/lizard_Kirsch_SW.bmp";
-    const char *outS  = "images/lizard_Kirsch_S.bmp";
-    const char *outSE = "images/lizard_Kirsch_SE.bmp";
-    const char *outE  = "images/lizard_Kirsch_E.bmp";
-    const char *outNE = "images/lizard_Kirsch_NE.bmp";
-
     // Load input BMP
     BMP8Image *image = BMP8read(inputFile);
     if (!image) {
@@ -496,37 +854,58 @@ int main() {
         return 1;
     }
 
-    // Apply Kirsch edge detection in all directions
-    BMP8Image *north  = BMP8EdgeDetectionKirschNorth(image);
-    BMP8Image *northW = BMP8EdgeDetectionKirschNorthWest(image);
-    BMP8Image *west   = BMP8EdgeDetectionKirschWest(image);
-    BMP8Image *southW = BMP8EdgeDetectionKirschSouthWest(image);
-    BMP8Image *south  = BMP8EdgeDetectionKirschSouth(image);
-    BMP8Image *southE = BMP8EdgeDetectionKirschSouthEast(image);
-    BMP8Image *east   = BMP8EdgeDetectionKirschEast(image);
-    BMP8Image *northE = BMP8EdgeDetectionKirschNorthEast(image);
-
-    // Save results
-    BMP8save(outN,  north);
-    BMP8save(outNW, northW);
-    BMP8save(outW,  west);
-    BMP8save(outSW, southW);
-    BMP8save(outS,  south);
-    BMP8save(outSE, southE);
-    BMP8save(outE,  east);
-    BMP8save(outNE, northE);
+    // All eight directions read the same source and are independent of each other
+    edgeBranch branches[] = {
+        {image, BMP8EdgeDetectionKirschNorth, "images/lizard_Kirsch_N.bmp", NULL},
+        {image, BMP8EdgeDetectionKirschNorthWest, "images/lizard_Kirsch_NW.bmp", NULL},
+        {image, BMP8EdgeDetectionKirschWest, "images/lizard_Kirsch_W.bmp", NULL},
+        {image, BMP8EdgeDetectionKirschSouthWest, "images/lizard_Kirsch_SW.bmp", NULL},
+        {image, BMP8EdgeDetectionKirschSouth, "images/lizard_Kirsch_S.bmp", NULL},
+        {image, BMP8EdgeDetectionKirschSouthEast, "images/lizard_Kirsch_SE.bmp", NULL},
+        {image, BMP8EdgeDetectionKirschEast, "images/lizard_Kirsch_E.bmp", NULL},
+        {image, BMP8EdgeDetectionKirschNorthEast, "images/lizard_Kirsch_NE.bmp", NULL},
+    };
+    int branchCount = sizeof(branches) / sizeof(branches[0]);
+
+    // Build the graph: every save waits only for its own direction, so writes
+    // overlap with the directions that are still being computed
+    taskGraph *graph = taskGraphCreate();
+    if (!graph) {
+        BMP8Free(image);
+        return 1;
+    }
+    bool ok = true;
+    for (int i = 0; ok && i < branchCount; i++) {
+        int compute = taskGraphAdd(graph, computeBranch, &branches[i]);
+        int save = taskGraphAdd(graph, saveBranch, &branches[i]);
+        ok = compute >= 0 && save >= 0 && taskGraphDepend(graph, save, compute);
+    }
+
+    // Run on one worker per CPU
+    if (ok) {
+        ok = taskGraphRun(graph, 0);
+    } else {
+        fprintf(stderr, "Error: could not build the task graph.\n");
+    }
+    taskGraphDestroy(graph);
+
+    // Apply the north Kirsch mask to every channel of a color image
+    BMP24Image *image24 = BMP24Read("../Test_Images/lena_color.bmp");
+    if (image24) {
+        BMP24Image *north24 = BMP24ApplyPerChannel(image24, BMP8EdgeDetectionKirschNorth);
+        if (north24) {
+            BMP24Save("images/lena_color_Kirsch_N.bmp", north24);
+            BMP24Free(north24);
+        }
+        BMP24Free(image24);
+    }
 
     // Free memory
     BMP8Free(image);
-    BMP8Free(north);
-    BMP8Free(northW);
-    BMP8Free(west);
-    BMP8Free(southW);
-    BMP8Free(south);
-    BMP8Free(southE);
-    BMP8Free(east);
-    BMP8Free(northE);
 
+    if (!ok) {
+        return 1;
+    }
     printf("Kirsch edge detection completed!\n");
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,72 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+ * @brief Free buffers of one size class kept by the pool.
+ */
+typedef struct {
+    size_t size;        /// size in bytes of every buffer in this bucket
+    void **buffers;     /// stack of free buffers
+    int count;          /// number of free buffers on the stack
+    int capacity;       /// allocated length of the stack
+} poolBucket;
+
+/**
+ * @brief Size-bucketed pool recycling pixel buffers between operators.
+ */
+typedef struct {
+    poolBucket *buckets;     /// one bucket per distinct buffer size
+    int bucketCount;         /// number of buckets in use
+    int bucketCapacity;      /// allocated length of the bucket array
+    size_t cachedBytes;      /// bytes currently held in free buffers
+    size_t maxCachedBytes;   /// upper bound on cachedBytes
+    unsigned long hits;      /// acquisitions served from the pool
+    unsigned long misses;    /// acquisitions that had to allocate
+    pthread_mutex_t lock;    /// serializes access from worker threads
+} imagePool;
+
+/**
+ * @brief Create an empty pool.
+ *
+ * @param maxCachedBytes Maximum number of bytes kept in free buffers;
+ *                       released buffers beyond this limit are freed.
+ * @return Pointer to the new pool, or NULL if allocation fails.
+ */
+imagePool* poolCreate(size_t maxCachedBytes);
+
+/**
+ * @brief Get a buffer of at least the given size.
+ *
+ * Reuses a released buffer of the same size when one is available.
+ * Passing a NULL pool allocates a new buffer that is not tracked.
+ *
+ * @param pool Pool to take the buffer from (may be NULL).
+ * @param size Requested size in bytes.
+ * @return Pointer to a 64-byte aligned buffer, or NULL if allocation fails.
+ */
+void* poolAcquire(imagePool* pool, size_t size);
+
+/**
+ * @brief Return a buffer to the pool for later reuse.
+ *
+ * The buffer must have been obtained with poolAcquire, so that every
+ * buffer the pool hands out keeps its alignment.
+ * Passing a NULL pool frees the buffer immediately.
+ *
+ * @param pool Pool to return the buffer to (may be NULL).
+ * @param buffer Buffer to release (may be NULL).
+ * @param size Size that was requested when the buffer was acquired.
+ */
+void poolRelease(imagePool* pool, void* buffer, size_t size);
+
+/**
+ * @brief Free every cached buffer and the pool itself.
+ *
+ * @param pool Pointer to the pool to be destroyed.
+ */
+void poolDestroy(imagePool* pool);
+
+#endif // POOL_H
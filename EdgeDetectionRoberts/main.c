@@ -3,8 +3,13 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "mask.h"
+#include "kernels.h"
+#include "pool.h"
 
 // Define BMP header size
 #define BMP_HEADER_SIZE 54
@@ -30,6 +35,19 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
+// Pool recycling pixel buffers between operators (NULL falls back to malloc/free)
+static imagePool* pixelPool = NULL;
+
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
     // open file
@@ -64,8 +82,8 @@ BMP8Image* BMP8read(const char* filename) {
         fread(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fInput);
     }
 
-    // Allocate memory for pixel data
-    img->data = (unsigned char*)malloc(img->imgSize);
+    // Allocate memory for pixel data (from the pool, where BMP8Free returns it)
+    img->data = poolAcquire(pixelPool, img->imgSize);
     if (!img->data) {
         fprintf(stderr, "Memory allocation failed!\n");
         free(img);
@@ -80,50 +98,216 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-// Function to apply convolution with a given mask to an 8-bit BMP image
-BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
-    if(!img || !m){
-        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        poolRelease(pixelPool, img->data, img->imgSize);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
     // Allocate memory for new image
-    BMP8Image* convImg = malloc(sizeof(BMP8Image));
-    if(!convImg){
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
     // Copy BMP header and metadata
-    memcpy(convImg->header, img->header, BMP_HEADER_SIZE);
-    convImg->width = img->width;
-    convImg->height = img->height;
-    convImg->bitDepth = img->bitDepth;
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
     // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(convImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
     // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    convImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
-    // Allocate memory for pixel data of the result
-    convImg->data = malloc(convImg->imgSize);
-    if (!convImg->data) {
+    // Allocate memory for pixel data
+    newImg->data = poolAcquire(pixelPool, newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(convImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Copy the coefficients of m into taps when all of them are whole numbers
+// Returns the sum of their magnitudes, or -1 when the mask needs the float path
+// (fractional coefficients, or sums too large to stay exact in float)
+static int maskIntegerTaps(mask* m, int* taps){
+    int absSum = 0;
+    for(unsigned int i = 0; i < m->rows * m->cols; i++){
+        float c = m->data[i];
+        if(c > 65535.0f || c < -65535.0f || c != (float)(int)c){
+            return -1;
+        }
+        taps[i] = (int)c;
+        absSum += abs(taps[i]);
+        // Float accumulation is exact below 2^24
+        if((long)absSum * MAX_BRIGHTNESS >= (1L << 24)){
+            return -1;
+        }
+    }
+    return absSum;
+}
+
+// Integer convolution of one pixel; taps outside the image are skipped (zero padding)
+static unsigned char convolveIntegerPixel(BMP8Image* img, int rowSize, const int* taps, int rows, int cols, int x, int y){
+    int val = 0;
+    for(int i = 0; i < rows; i++){
+        int idy = y + (i - rows / 2);
+        if(idy < 0 || idy >= img->height){
+            continue;
+        }
+        for(int j = 0; j < cols; j++){
+            int idx = x + (j - cols / 2);
+            if(idx >= 0 && idx < img->width){
+                val += taps[i * cols + j] * img->data[idy * rowSize + idx];
+            }
+        }
+    }
+    return (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+}
+
+// Convolution with integer taps, pixel for pixel equal to the float path
+// Where the whole mask is inside the image, sums use 16-bit lanes with a saturating
+// pack when they fit (absSum * 255 <= 32767) and 32-bit scalar accumulation otherwise
+// row, when given, is an unrolled kernel for this mask size or these coefficients
+static void BMP8ConvolutionInteger(BMP8Image* img, const int* taps, int rows, int cols, int absSum, kernelRow row, BMP8Image* dst){
+    int rowSize = (img->width + 3) & ~3;
+    int iCenter = rows / 2;
+    int jCenter = cols / 2;
+
+    // Rows and columns where every tap lies inside the image
+    int yBegin = iCenter, yEnd = img->height - (rows - 1 - iCenter);
+    int xBegin = jCenter, xEnd = img->width - (cols - 1 - jCenter);
+
+    for(int y = 0; y < img->height; y++){
+        unsigned char* out = dst->data + (size_t)y * rowSize;
+        if(y < yBegin || y >= yEnd || xBegin >= xEnd){
+            for(int x = 0; x < img->width; x++){
+                out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+            }
+            continue;
+        }
+
+        for(int x = 0; x < xBegin; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+        int x = xBegin;
+        if(row){
+            row(img->data + (size_t)(y - iCenter) * rowSize, rowSize, x, xEnd, out, taps, absSum * MAX_BRIGHTNESS <= 32767);
+            x = xEnd;
+        }
+#ifdef __SSE2__
+        // Vector path: 8 pixels per iteration, twice the lanes of a float kernel
+        if(absSum * MAX_BRIGHTNESS <= 32767){
+            const __m128i zero = _mm_setzero_si128();
+            for(; x + 8 <= xEnd; x += 8){
+                __m128i acc = zero;
+                for(int i = 0; i < rows; i++){
+                    const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                    for(int j = 0; j < cols; j++){
+                        int c = taps[i * cols + j];
+                        if(c != 0){
+                            __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + j)), zero);
+                            acc = _mm_add_epi16(acc, _mm_mullo_epi16(px, _mm_set1_epi16((short)c)));
+                        }
+                    }
+                }
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(acc, acc));
+            }
+        }
+#endif
+        // Scalar path (and tail): no bounds checks inside the image
+        for(; x < xEnd; x++){
+            int val = 0;
+            for(int i = 0; i < rows; i++){
+                const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                for(int j = 0; j < cols; j++){
+                    val += taps[i * cols + j] * src[j];
+                }
+            }
+            out[x] = (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+        }
+        for(; x < img->width; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+    }
+}
+
+// Function to apply convolution with a given mask, writing into a caller-supplied image
+// dst must have the size of img and must not alias it (neighbors are read after writes)
+bool BMP8ConvolutionInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    // Integral masks (Sobel, Prewitt, Kirsch, Laplacian, ...) take the exact integer path
+    int* taps = malloc(m->rows * m->cols * sizeof(int));
+    int absSum = taps ? maskIntegerTaps(m, taps) : -1;
+    if(absSum >= 0){
+        BMP8ConvolutionInteger(img, taps, m->rows, m->cols, absSum, kernelRowFor(m->rows, m->cols), dst);
+        free(taps);
+        return true;
+    }
+    free(taps);
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
 
     // Compute center of the mask (for correct alignment during convolution)
     int iCenter = m->rows / 2;
     int jCenter = m->cols / 2;
 
     // Iterate through every pixel in the image
-    for(int y = 0; y < convImg->height; y++){
-        for(int x = 0; x < convImg->width; x++){
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
             float val = 0.0f;
 
             // Apply convolution mask
@@ -146,129 +330,185 @@ BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
             val = MAX(val, MIN_BRIGHTNESS);
 
             // Store result pixel
-            convImg->data[y * convImg->width + x] = (unsigned char)val;
+            dst->data[y * rowSize + x] = (unsigned char)val;
         }
     }
 
-    return convImg;
+    return true;
 }
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
-        free(img);
+// Apply an integer mask fixed at compile time (see CONSTANT_KERNEL), writing into a
+// caller-supplied image; same result as BMP8ConvolutionInto with the equivalent mask
+bool BMP8ConvolutionKernelInto(BMP8Image* img, const constantKernel* k, BMP8Image* dst){
+    if(!img || !k){
+        fprintf(stderr, "Convolution Error: Either there is no image or kernel.\n");
+        return false;
     }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    int absSum = 0;
+    for(int i = 0; i < k->rows * k->cols; i++){
+        absSum += abs(k->taps[i]);
+    }
+    BMP8ConvolutionInteger(img, k->taps, k->rows, k->cols, absSum, k->row, dst);
+    return true;
 }
 
-BMP8Image* BMP8EdgeDetectionRobertsGx(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+// Function to apply convolution with a given mask to an 8-bit BMP image
+BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
         return NULL;
     }
-    // Create a 2x2 mask for Roberts Gx (horizontal) edge detection
-    mask* m = maskCreate(2, 2);
 
-    // Define Roberts horizontal kernel
-    int maskR[2][2] = {
-        {1,  0},
-        {0, -1}
-    };
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8ConvolutionInto(img, m, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
 
-    // Copy kernel values into mask structure
-    for(int j=0;j<m->cols;j++)
-        for(int i=0;i<m->rows;i++)
-            m->data[i*m->cols+j] = maskR[i][j];
+// Define Roberts horizontal kernel
+CONSTANT_KERNEL(robertsGx, 2, 2,
+     1,  0,
+     0, -1)
 
-    // Apply convolution to image with Gx mask
-    BMP8Image* conv = BMP8Convolution(img,m);
+bool BMP8EdgeDetectionRobertsGxInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
+    }
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &robertsGx, dst);
 
-    // Free the temporary mask
-    maskFree(m);
+    // Report whether dst was filled
+    return ok;
+}
 
-    // Return the image with horizontal edges
-    return conv;
+// Allocating variant of BMP8EdgeDetectionRobertsGxInto
+BMP8Image* BMP8EdgeDetectionRobertsGx(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8EdgeDetectionRobertsGxInto(img, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
-BMP8Image* BMP8EdgeDetectionRobertsGy(BMP8Image* img){
+// Define Roberts vertical kernel
+CONSTANT_KERNEL(robertsGy, 2, 2,
+     0,  1,
+    -1,  0)
+
+bool BMP8EdgeDetectionRobertsGyInto(BMP8Image* img, BMP8Image* dst){
     if(!img){
         fprintf(stderr, "Edge Detection Error: No image provided.\n");
-        return NULL;
+        return false;
     }
-    // Create a 2x2 mask for Roberts Gy (vertical) edge detection
-    mask* m = maskCreate(2,2);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &robertsGy, dst);
 
-    // Define Roberts vertical kernel
-    int maskR[2][2] = {
-        { 0, 1},
-        {-1, 0}
-    };
+    // Report whether dst was filled
+    return ok;
+}
 
-    // Copy kernel values into mask structure
-    for(int j=0;j<m->cols;j++)
-        for(int i=0;i<m->rows;i++)
-            m->data[i*m->cols+j] = maskR[i][j];
+// Allocating variant of BMP8EdgeDetectionRobertsGyInto
+BMP8Image* BMP8EdgeDetectionRobertsGy(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8EdgeDetectionRobertsGyInto(img, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
 
-    // Apply convolution to image with Gy mask
-    BMP8Image* conv = BMP8Convolution(img,m);
+// Gradient magnitude of the horizontal and vertical edges into dst
+// dst may alias Gx or Gy: each pixel is read before it is written
+static void BMP8RobertsMagnitude(BMP8Image* Gx, BMP8Image* Gy, BMP8Image* dst){
+    int rowSize = (dst->width + 3) & ~3;
 
-    // Free the temporary mask
-    maskFree(m);
+    // Combine horizontal and vertical edges
+    for(int y = 0; y < dst->height; y++){
+        for(int x = 0; x < dst->width; x++){
+            int idx = y * rowSize + x;
+            // horizontal
+            int gx = Gx->data[idx];
+            // vertical
+            int gy = Gy->data[idx];
+            // Compute gradient magnitude
+            int g = (int)(sqrt(gx*gx + gy*gy));
+            g = MIN(g, MAX_BRIGHTNESS);
 
-    // Return the image with vertical edges
-    return conv;
+            dst->data[idx] = (unsigned char)g;
+        }
+    }
 }
 
-BMP8Image* BMP8EdgeDetectionRobertsCombined(BMP8Image* img){
+// Combined Roberts edge magnitude, writing into a caller-supplied image
+// dst may alias img: both gradients are computed before dst is written
+bool BMP8EdgeDetectionRobertsCombinedInto(BMP8Image* img, BMP8Image* dst){
     if(!img){
         fprintf(stderr, "Edge Detection Error: No image provided.\n");
-        return NULL;
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
     }
 
-    // Compute horizontal edges
+    // Calculate horizontal edges
     BMP8Image* Gx = BMP8EdgeDetectionRobertsGx(img);
-
-    // Compute vertical edges
+    // Calculate vertical edges
     BMP8Image* Gy = BMP8EdgeDetectionRobertsGy(img);
+    if(!Gx || !Gy){
+        BMP8Free(Gx);
+        BMP8Free(Gy);
+        return false;
+    }
 
-    // Allocate new image for combined edge magnitude
-    BMP8Image* edgeImg = malloc(sizeof(BMP8Image));
-    memcpy(edgeImg->header,img->header,BMP_HEADER_SIZE);
-    edgeImg->width = img->width;
-    edgeImg->height = img->height;
-    edgeImg->bitDepth = img->bitDepth;
-
-    // Copy color table if grayscale
-    if(img->bitDepth <= 8)
-        memcpy(edgeImg->colorTable,img->colorTable,BMP_COLOR_TABLE_SIZE);
-
-    int rowSize = (img->width + 3) & ~3;
-    edgeImg->imgSize = rowSize * img->height;
-    edgeImg->data = malloc(edgeImg->imgSize);
+    BMP8RobertsMagnitude(Gx, Gy, dst);
 
-    // Combine horizontal and vertical edge images
-    for(int y=0;y<img->height;y++){
-        for(int x=0;x<img->width;x++){
-            int idx = y*img->width+x;
+    // Free temporary horizontal and vertical images
+    BMP8Free(Gx);
+    BMP8Free(Gy);
 
-            // Retrieve horizontal and vertical edge values
-            int gx = Gx->data[idx];
-            int gy = Gy->data[idx];
+    return true;
+}
 
-            // Compute magnitude of gradient
-            int g = (int)(sqrt(gx*gx + gy*gy));
-            g = MIN(g, MAX_BRIGHTNESS);
+// Allocating variant of BMP8EdgeDetectionRobertsCombinedInto
+// The magnitude overwrites the horizontal edges, so only two buffers are held
+BMP8Image* BMP8EdgeDetectionRobertsCombined(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return NULL;
+    }
 
-            edgeImg->data[idx] = (unsigned char)g;
-        }
+    BMP8Image* Gx = BMP8EdgeDetectionRobertsGx(img);
+    BMP8Image* Gy = BMP8EdgeDetectionRobertsGy(img);
+    if(!Gx || !Gy){
+        BMP8Free(Gx);
+        BMP8Free(Gy);
+        return NULL;
     }
 
-    // Free temporary horizontal and vertical images
-    BMP8Free(Gx);
+    BMP8RobertsMagnitude(Gx, Gy, Gx);
     BMP8Free(Gy);
-
-    // Return the combined edge image
-    return edgeImg;
+    return Gx;
 }
 
 
@@ -291,7 +531,180 @@ void BMP8save(const char* filename, BMP8Image* img) {
     fclose(fOutput);
 }
 
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Signature of an 8-bit operator that can be applied to every color channel
+typedef BMP8Image* (*BMP8Operator)(BMP8Image* img);
+
+// Apply an 8-bit operator to each channel of a 24-bit BMP image
+// The channels are split once into 8-bit planes and processed in parallel
+BMP24Image* BMP24ApplyPerChannel(BMP24Image* img, BMP8Operator op){
+    if(!img || !op){
+        fprintf(stderr, "Edge Detection Error: Either there is no image or operator.\n");
+        return NULL;
+    }
+
+    // Allocate memory for the new image
+    BMP24Image* outImg = malloc(sizeof(BMP24Image));
+    if(!outImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(outImg->header, img->header, BMP_HEADER_SIZE);
+    outImg->width = img->width;
+    outImg->height = img->height;
+    outImg->bitDepth = img->bitDepth;
+    outImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    outImg->data = calloc(img->rowSize * img->height, 1);
+    if (!outImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(outImg);
+        return NULL;
+    }
+
+    // Row size of an 8-bit plane (padded to 4 bytes)
+    int rowSize8 = (img->width + 3) & ~3;
+    int failed = 0;
+
+    #pragma omp parallel for reduction(|:failed)
+    for(int c = 0; c < 3; c++){
+        // Describe channel c as an 8-bit greyscale image
+        BMP8Image plane;
+        memcpy(plane.header, img->header, BMP_HEADER_SIZE);
+        plane.width = img->width;
+        plane.height = img->height;
+        plane.bitDepth = 8;
+        plane.imgSize = rowSize8 * img->height;
+        *(short*)&plane.header[28] = 8;
+        *(int*)&plane.header[10] = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE;
+        *(int*)&plane.header[34] = plane.imgSize;
+        for(int i = 0; i < 256; i++){
+            plane.colorTable[i*4 + 0] = i;
+            plane.colorTable[i*4 + 1] = i;
+            plane.colorTable[i*4 + 2] = i;
+            plane.colorTable[i*4 + 3] = 0;
+        }
+
+        plane.data = calloc(plane.imgSize, 1);
+        if(!plane.data){
+            failed = 1;
+            continue;
+        }
+
+        // Extract the channel
+        for(int y = 0; y < img->height; y++){
+            const unsigned char* src = img->data + y * img->rowSize + c;
+            unsigned char* dst = plane.data + y * rowSize8;
+            for(int x = 0; x < img->width; x++){
+                dst[x] = src[x * 3];
+            }
+        }
+
+        // Run the 8-bit operator and merge its result back into channel c
+        BMP8Image* result = op(&plane);
+        if(!result){
+            failed = 1;
+        } else {
+            for(int y = 0; y < img->height; y++){
+                const unsigned char* src = result->data + y * rowSize8;
+                unsigned char* dst = outImg->data + y * outImg->rowSize + c;
+                for(int x = 0; x < img->width; x++){
+                    dst[x * 3] = src[x];
+                }
+            }
+            BMP8Free(result);
+        }
+        free(plane.data);
+    }
+
+    if(failed){
+        fprintf(stderr, "Edge Detection Error: Operator failed on a color channel.\n");
+        BMP24Free(outImg);
+        return NULL;
+    }
+    return outImg;
+}
+
 int main(){
+    // Recycle pixel buffers across all operators run by this program
+    pixelPool = poolCreate(64 * 1024 * 1024);
+
     // Input BMP file (8-bit grayscale)
     const char *inputFile  = "../Test_Images/lizard_greyscale8bit.bmp";
 
@@ -310,25 +723,42 @@ int main(){
     // Compute horizontal edges using Roberts Gx
     BMP8Image *horizontal = BMP8EdgeDetectionRobertsGx(image);
     BMP8save(outputGx, horizontal); // Save result to file
+    BMP8Free(horizontal);
 
     // Compute vertical edges using Roberts Gy
     BMP8Image *vertical = BMP8EdgeDetectionRobertsGy(image);
     BMP8save(outputGy, vertical); // Save result to file
+    BMP8Free(vertical);
 
     // Compute combined edges magnitude
     BMP8Image *combined = BMP8EdgeDetectionRobertsCombined(image);
     BMP8save(outputCombined, combined); // Save result to file
+    BMP8Free(combined);
+
+    // Compute combined edges magnitude of every channel of a color image
+    BMP24Image *image24 = BMP24Read("../Test_Images/lena_color.bmp");
+    if(image24){
+        BMP24Image *combined24 = BMP24ApplyPerChannel(image24, BMP8EdgeDetectionRobertsCombined);
+        if(combined24){
+            BMP24Save("images/lena_color_roberts_combined.bmp", combined24);
+            BMP24Free(combined24);
+        }
+        BMP24Free(image24);
+    }
 
     // Free all allocated memory
     BMP8Free(image);
-    BMP8Free(horizontal);
-    BMP8Free(vertical);
-    BMP8Free(combined);
 
     // Print completion message
     printf("Roberts edge detection completed!\n");
     printf("Horizontal: %s\nVertical: %s\nCombined: %s\n",
            outputGx, outputGy, outputCombined);
 
+    // Report buffer reuse and release the cached buffers
+    if(pixelPool){
+        printf("Pixel pool: %lu buffers reused, %lu allocated\n", pixelPool->hits, pixelPool->misses);
+        poolDestroy(pixelPool);
+    }
+
     return 0;
 }
\ No newline at end of file
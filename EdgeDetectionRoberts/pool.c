@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pool.h"
+
+// Alignment of every buffer handed out by the pool
+#define POOL_ALIGNMENT 64
+
+// Find the bucket holding buffers of the given size, or NULL
+static poolBucket* findBucket(imagePool* pool, size_t size) {
+    for (int i = 0; i < pool->bucketCount; i++) {
+        if (pool->buckets[i].size == size) {
+            return &pool->buckets[i];
+        }
+    }
+    return NULL;
+}
+
+// Allocate a new aligned buffer (size rounded up as aligned_alloc requires)
+static void* allocateBuffer(size_t size) {
+    size_t rounded = (size + POOL_ALIGNMENT - 1) & ~(size_t)(POOL_ALIGNMENT - 1);
+    return aligned_alloc(POOL_ALIGNMENT, rounded);
+}
+
+imagePool* poolCreate(size_t maxCachedBytes) {
+    // Allocate memory for pool structure
+    imagePool* pool = calloc(1, sizeof(imagePool));
+    if (!pool) {
+        fprintf(stderr, "Pool Error: Memory allocation failed!\n");
+        return NULL;
+    }
+
+    pool->maxCachedBytes = maxCachedBytes;
+    pthread_mutex_init(&pool->lock, NULL);
+    return pool;
+}
+
+void* poolAcquire(imagePool* pool, size_t size) {
+    if (!pool) {
+        return allocateBuffer(size);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    poolBucket* bucket = findBucket(pool, size);
+    if (bucket && bucket->count > 0) {
+        // Reuse the most recently released buffer (likely still in cache)
+        void* buffer = bucket->buffers[--bucket->count];
+        pool->cachedBytes -= size;
+        pool->hits++;
+        pthread_mutex_unlock(&pool->lock);
+        return buffer;
+    }
+    pool->misses++;
+    pthread_mutex_unlock(&pool->lock);
+
+    return allocateBuffer(size);
+}
+
+void poolRelease(imagePool* pool, void* buffer, size_t size) {
+    if (!buffer) {
+        return;
+    }
+    if (!pool) {
+        free(buffer);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    // Drop the buffer if keeping it would exceed the cache limit
+    if (pool->cachedBytes + size > pool->maxCachedBytes) {
+        pthread_mutex_unlock(&pool->lock);
+        free(buffer);
+        return;
+    }
+
+    poolBucket* bucket = findBucket(pool, size);
+    if (!bucket) {
+        // Create a bucket for a new size class
+        if (pool->bucketCount == pool->bucketCapacity) {
+            int capacity = pool->bucketCapacity ? pool->bucketCapacity * 2 : 4;
+            poolBucket* buckets = realloc(pool->buckets, capacity * sizeof(poolBucket));
+            if (!buckets) {
+                pthread_mutex_unlock(&pool->lock);
+                free(buffer);
+                return;
+            }
+            pool->buckets = buckets;
+            pool->bucketCapacity = capacity;
+        }
+        bucket = &pool->buckets[pool->bucketCount++];
+        bucket->size = size;
+        bucket->buffers = NULL;
+        bucket->count = 0;
+        bucket->capacity = 0;
+    }
+
+    // Grow the free stack if needed
+    if (bucket->count == bucket->capacity) {
+        int capacity = bucket->capacity ? bucket->capacity * 2 : 4;
+        void** buffers = realloc(bucket->buffers, capacity * sizeof(void*));
+        if (!buffers) {
+            pthread_mutex_unlock(&pool->lock);
+            free(buffer);
+            return;
+        }
+        bucket->buffers = buffers;
+        bucket->capacity = capacity;
+    }
+
+    bucket->buffers[bucket->count++] = buffer;
+    pool->cachedBytes += size;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void poolDestroy(imagePool* pool) {
+    if (pool) {
+        for (int i = 0; i < pool->bucketCount; i++) {
+            // Free every cached buffer of the bucket
+            for (int j = 0; j < pool->buckets[i].count; j++) {
+                free(pool->buckets[i].buffers[j]);
+            }
+            free(pool->buckets[i].buffers);
+        }
+        free(pool->buckets);
+        pthread_mutex_destroy(&pool->lock);
+        // Free pool structure itself
+        free(pool);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/**
+ * @brief Function executed by a task.
+ */
+typedef void (*taskFunction)(void* arg);
+
+/**
+ * @brief One node of a task graph.
+ */
+typedef struct {
+    taskFunction fn;        /// work to run
+    void *arg;              /// argument passed to fn
+    int *dependents;        /// tasks waiting for this one
+    int dependentCount;     /// number of entries in dependents
+    int dependentCapacity;  /// allocated length of dependents
+    int dependencyCount;    /// number of tasks this one waits for
+    atomic_int pending;     /// dependencies not finished yet (during a run)
+} task;
+
+/**
+ * @brief Double-ended queue of ready tasks owned by one worker.
+ *
+ * The owner pushes and pops at the tail (newest first, likely still in
+ * cache); idle workers steal from the head (oldest first).
+ */
+typedef struct {
+    int *items;             /// task indices, valid between head and tail
+    int head;               /// next index to steal
+    int tail;               /// next free slot
+    pthread_mutex_t lock;   /// serializes owner and thieves
+} taskDeque;
+
+/**
+ * @brief Directed acyclic graph of tasks executed on a work-stealing pool.
+ */
+typedef struct {
+    task *tasks;            /// every task added to the graph
+    int count;              /// number of tasks
+    int capacity;           /// allocated length of tasks
+    taskDeque *deques;      /// one deque per worker (during a run)
+    int workerCount;        /// number of workers (during a run)
+    int remaining;          /// tasks not finished yet (during a run)
+    int queued;             /// ready tasks sitting in deques (during a run)
+    pthread_mutex_t lock;   /// guards remaining and queued
+    pthread_cond_t wake;    /// signalled when work is queued or the run ends
+} taskGraph;
+
+/**
+ * @brief Create an empty task graph.
+ *
+ * @return Pointer to the new graph, or NULL if allocation fails.
+ */
+taskGraph* taskGraphCreate(void);
+
+/**
+ * @brief Add a task to the graph.
+ *
+ * @param graph Graph to add the task to.
+ * @param fn Function to run.
+ * @param arg Argument passed to fn.
+ * @return Index of the new task, or -1 if allocation fails.
+ */
+int taskGraphAdd(taskGraph* graph, taskFunction fn, void* arg);
+
+/**
+ * @brief Declare that a task may only start after another one finished.
+ *
+ * @param graph Graph holding both tasks.
+ * @param taskId Task that has to wait.
+ * @param dependsOn Task that has to finish first.
+ * @return true on success, false on invalid indices or allocation failure.
+ */
+bool taskGraphDepend(taskGraph* graph, int taskId, int dependsOn);
+
+/**
+ * @brief Run every task, executing independent branches concurrently.
+ *
+ * The calling thread takes part as one of the workers. A task becomes
+ * ready as soon as its last dependency finishes and is queued on the
+ * worker that finished it. The graph may be run again afterwards.
+ *
+ * @param graph Graph to execute.
+ * @param threads Number of workers; 0 or less uses one per online CPU.
+ * @return true when every task ran, false if the graph has a cycle or
+ *         the workers could not be started.
+ */
+bool taskGraphRun(taskGraph* graph, int threads);
+
+/**
+ * @brief Free the graph. Task arguments are owned by the caller.
+ *
+ * @param graph Pointer to the graph to be destroyed.
+ */
+void taskGraphDestroy(taskGraph* graph);
+
+#endif // TASKGRAPH_H
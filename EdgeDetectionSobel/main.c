@@ -3,8 +3,13 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "mask.h"
+#include "kernels.h"
+#include "pool.h"
 
 // Define BMP header size
 #define BMP_HEADER_SIZE 54
@@ -19,6 +24,12 @@
 #define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
 #define MAX(a, b) ((a) > (b) ? (a) : (b))   // returns the larger of (a) and (b)
 
+// Side of the square tiles processed independently by the Canny detector
+#define CANNY_TILE 64
+// Classes of pixels after non-maximum suppression and double threshold
+#define CANNY_WEAK 1
+#define CANNY_STRONG 2
+
 // Structure to hold 8-bit BMP image data
 typedef struct {
     unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
@@ -30,6 +41,19 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
+// Pool recycling pixel buffers between operators (NULL falls back to malloc/free)
+static imagePool* pixelPool = NULL;
+
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
     // open file
@@ -64,8 +88,8 @@ BMP8Image* BMP8read(const char* filename) {
         fread(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fInput);
     }
 
-    // Allocate memory for pixel data
-    img->data = (unsigned char*)malloc(img->imgSize);
+    // Allocate memory for pixel data (from the pool, where BMP8Free returns it)
+    img->data = poolAcquire(pixelPool, img->imgSize);
     if (!img->data) {
         fprintf(stderr, "Memory allocation failed!\n");
         free(img);
@@ -80,50 +104,216 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-// Function to apply convolution with a given mask to an 8-bit BMP image
-BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
-    if(!img || !m){
-        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        poolRelease(pixelPool, img->data, img->imgSize);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
     // Allocate memory for new image
-    BMP8Image* convImg = malloc(sizeof(BMP8Image));
-    if(!convImg){
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
     // Copy BMP header and metadata
-    memcpy(convImg->header, img->header, BMP_HEADER_SIZE);
-    convImg->width = img->width;
-    convImg->height = img->height;
-    convImg->bitDepth = img->bitDepth;
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
     // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(convImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
     // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    convImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
-    // Allocate memory for pixel data of the result
-    convImg->data = malloc(convImg->imgSize);
-    if (!convImg->data) {
+    // Allocate memory for pixel data
+    newImg->data = poolAcquire(pixelPool, newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(convImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Copy the coefficients of m into taps when all of them are whole numbers
+// Returns the sum of their magnitudes, or -1 when the mask needs the float path
+// (fractional coefficients, or sums too large to stay exact in float)
+static int maskIntegerTaps(mask* m, int* taps){
+    int absSum = 0;
+    for(unsigned int i = 0; i < m->rows * m->cols; i++){
+        float c = m->data[i];
+        if(c > 65535.0f || c < -65535.0f || c != (float)(int)c){
+            return -1;
+        }
+        taps[i] = (int)c;
+        absSum += abs(taps[i]);
+        // Float accumulation is exact below 2^24
+        if((long)absSum * MAX_BRIGHTNESS >= (1L << 24)){
+            return -1;
+        }
+    }
+    return absSum;
+}
+
+// Integer convolution of one pixel; taps outside the image are skipped (zero padding)
+static unsigned char convolveIntegerPixel(BMP8Image* img, int rowSize, const int* taps, int rows, int cols, int x, int y){
+    int val = 0;
+    for(int i = 0; i < rows; i++){
+        int idy = y + (i - rows / 2);
+        if(idy < 0 || idy >= img->height){
+            continue;
+        }
+        for(int j = 0; j < cols; j++){
+            int idx = x + (j - cols / 2);
+            if(idx >= 0 && idx < img->width){
+                val += taps[i * cols + j] * img->data[idy * rowSize + idx];
+            }
+        }
+    }
+    return (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+}
+
+// Convolution with integer taps, pixel for pixel equal to the float path
+// Where the whole mask is inside the image, sums use 16-bit lanes with a saturating
+// pack when they fit (absSum * 255 <= 32767) and 32-bit scalar accumulation otherwise
+// row, when given, is an unrolled kernel for this mask size or these coefficients
+static void BMP8ConvolutionInteger(BMP8Image* img, const int* taps, int rows, int cols, int absSum, kernelRow row, BMP8Image* dst){
+    int rowSize = (img->width + 3) & ~3;
+    int iCenter = rows / 2;
+    int jCenter = cols / 2;
+
+    // Rows and columns where every tap lies inside the image
+    int yBegin = iCenter, yEnd = img->height - (rows - 1 - iCenter);
+    int xBegin = jCenter, xEnd = img->width - (cols - 1 - jCenter);
+
+    for(int y = 0; y < img->height; y++){
+        unsigned char* out = dst->data + (size_t)y * rowSize;
+        if(y < yBegin || y >= yEnd || xBegin >= xEnd){
+            for(int x = 0; x < img->width; x++){
+                out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+            }
+            continue;
+        }
+
+        for(int x = 0; x < xBegin; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+        int x = xBegin;
+        if(row){
+            row(img->data + (size_t)(y - iCenter) * rowSize, rowSize, x, xEnd, out, taps, absSum * MAX_BRIGHTNESS <= 32767);
+            x = xEnd;
+        }
+#ifdef __SSE2__
+        // Vector path: 8 pixels per iteration, twice the lanes of a float kernel
+        if(absSum * MAX_BRIGHTNESS <= 32767){
+            const __m128i zero = _mm_setzero_si128();
+            for(; x + 8 <= xEnd; x += 8){
+                __m128i acc = zero;
+                for(int i = 0; i < rows; i++){
+                    const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                    for(int j = 0; j < cols; j++){
+                        int c = taps[i * cols + j];
+                        if(c != 0){
+                            __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + j)), zero);
+                            acc = _mm_add_epi16(acc, _mm_mullo_epi16(px, _mm_set1_epi16((short)c)));
+                        }
+                    }
+                }
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(acc, acc));
+            }
+        }
+#endif
+        // Scalar path (and tail): no bounds checks inside the image
+        for(; x < xEnd; x++){
+            int val = 0;
+            for(int i = 0; i < rows; i++){
+                const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                for(int j = 0; j < cols; j++){
+                    val += taps[i * cols + j] * src[j];
+                }
+            }
+            out[x] = (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+        }
+        for(; x < img->width; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+    }
+}
+
+// Function to apply convolution with a given mask, writing into a caller-supplied image
+// dst must have the size of img and must not alias it (neighbors are read after writes)
+bool BMP8ConvolutionInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    // Integral masks (Sobel, Prewitt, Kirsch, Laplacian, ...) take the exact integer path
+    int* taps = malloc(m->rows * m->cols * sizeof(int));
+    int absSum = taps ? maskIntegerTaps(m, taps) : -1;
+    if(absSum >= 0){
+        BMP8ConvolutionInteger(img, taps, m->rows, m->cols, absSum, kernelRowFor(m->rows, m->cols), dst);
+        free(taps);
+        return true;
+    }
+    free(taps);
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
 
     // Compute center of the mask (for correct alignment during convolution)
     int iCenter = m->rows / 2;
     int jCenter = m->cols / 2;
 
     // Iterate through every pixel in the image
-    for(int y = 0; y < convImg->height; y++){
-        for(int x = 0; x < convImg->width; x++){
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
             float val = 0.0f;
 
             // Apply convolution mask
@@ -146,147 +336,467 @@ BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
             val = MAX(val, MIN_BRIGHTNESS);
 
             // Store result pixel
-            convImg->data[y * convImg->width + x] = (unsigned char)val;
+            dst->data[y * rowSize + x] = (unsigned char)val;
         }
     }
 
-    return convImg;
+    return true;
 }
 
-BMP8Image* BMP8EdgeDetectionSobelHorizontal(BMP8Image* img){
-    if(!img){
-        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+// Apply an integer mask fixed at compile time (see CONSTANT_KERNEL), writing into a
+// caller-supplied image; same result as BMP8ConvolutionInto with the equivalent mask
+bool BMP8ConvolutionKernelInto(BMP8Image* img, const constantKernel* k, BMP8Image* dst){
+    if(!img || !k){
+        fprintf(stderr, "Convolution Error: Either there is no image or kernel.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    int absSum = 0;
+    for(int i = 0; i < k->rows * k->cols; i++){
+        absSum += abs(k->taps[i]);
+    }
+    BMP8ConvolutionInteger(img, k->taps, k->rows, k->cols, absSum, k->row, dst);
+    return true;
+}
+
+// Function to apply convolution with a given mask to an 8-bit BMP image
+BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
         return NULL;
     }
 
-    // Create a 3x3 mask for convolution
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
         return NULL;
     }
+    if(!BMP8ConvolutionInto(img, m, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
 
-    // Sobel operator for horizontal edge detection
-    int sobelH[3][3] = {
-        {-1, -2, -1},
-        { 0,  0,  0},
-        { 1,  2,  1}
-    };
+// Sobel operator for horizontal edge detection
+CONSTANT_KERNEL(sobelHorizontal, 3, 3,
+    -1, -2, -1,
+     0,  0,  0,
+     1,  2,  1)
 
-    // Copy Sobel horizontal values into the mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = sobelH[i][j];
-        }
+bool BMP8EdgeDetectionSobelHorizontalInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
     }
 
-    // Apply convolution with the horizontal Sobel mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &sobelHorizontal, dst);
 
-    // Free mask memory
-    maskFree(m);
+    // Report whether dst was filled
+    return ok;
+}
 
-    // Return the convolved image containing horizontal edges
-    return convolved;
+// Allocating variant of BMP8EdgeDetectionSobelHorizontalInto
+BMP8Image* BMP8EdgeDetectionSobelHorizontal(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8EdgeDetectionSobelHorizontalInto(img, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
-BMP8Image* BMP8EdgeDetectionSobelVertical(BMP8Image* img){
+// Sobel operator for vertical edge detection
+CONSTANT_KERNEL(sobelVertical, 3, 3,
+    -1,  0,  1,
+    -2,  0,  2,
+    -1,  0,  1)
+
+bool BMP8EdgeDetectionSobelVerticalInto(BMP8Image* img, BMP8Image* dst){
     if(!img){
         fprintf(stderr, "Edge Detection Error: No image provided.\n");
-        return NULL;
+        return false;
     }
 
-    // Create a 3x3 mask for convolution
-    mask* m = maskCreate(3, 3);
-    if(!m || !m->data){
-        fprintf(stderr, "Error: Could not allocate mask.\n");
+    // Apply convolution with the compile-time kernel
+    bool ok = BMP8ConvolutionKernelInto(img, &sobelVertical, dst);
+
+    // Report whether dst was filled
+    return ok;
+}
+
+// Allocating variant of BMP8EdgeDetectionSobelVerticalInto
+BMP8Image* BMP8EdgeDetectionSobelVertical(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8EdgeDetectionSobelVerticalInto(img, dst)){
+        BMP8Free(dst);
         return NULL;
     }
+    return dst;
+}
+
 
-    // Sobel operator for vertical edge detection
-    int sobelV[3][3] = {
-        { -1,  0,  1},
-        { -2,  0,  2},
-        { -1,  0,  1}
-    };
+// Gradient magnitude of the horizontal and vertical edges into dst
+// dst may alias horizontal or vertical: each pixel is read before it is written
+static void BMP8SobelMagnitude(BMP8Image* horizontal, BMP8Image* vertical, BMP8Image* dst){
+    int rowSize = (dst->width + 3) & ~3;
+
+    // Combine horizontal and vertical edges
+    for(int y = 0; y < dst->height; y++){
+        for(int x = 0; x < dst->width; x++){
+            int idx = y * rowSize + x;
+            // horizontal
+            int gx = horizontal->data[idx];
+            // vertical
+            int gy = vertical->data[idx];
+            // Compute gradient magnitude
+            int g = (int)(sqrt(gx*gx + gy*gy));
+            g = MIN(g, MAX_BRIGHTNESS);
 
-    // Copy Sobel vertical values into the mask
-    for(int j = 0; j < m->cols; j++){
-        for(int i = 0; i < m->rows; i++){
-            m->data[i * m->cols + j] = sobelV[i][j];
+            dst->data[idx] = (unsigned char)g;
         }
     }
+}
 
-    // Apply convolution with the vertical Sobel mask
-    BMP8Image *convolved = BMP8Convolution(img, m);
+// Combined Sobel edge magnitude, writing into a caller-supplied image
+// dst may alias img: both gradients are computed before dst is written
+bool BMP8EdgeDetectionSobelCombinedInto(BMP8Image* img, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
 
-    // Free mask memory
-    maskFree(m);
+    // Calculate horizontal edges
+    BMP8Image* horizontal = BMP8EdgeDetectionSobelHorizontal(img);
+    // Calculate vertical edges
+    BMP8Image* vertical = BMP8EdgeDetectionSobelVertical(img);
+    if(!horizontal || !vertical){
+        BMP8Free(horizontal);
+        BMP8Free(vertical);
+        return false;
+    }
 
-    // Return the convolved image containing vertical edges
-    return convolved;
-}
+    BMP8SobelMagnitude(horizontal, vertical, dst);
 
+    // Free temporary horizontal and vertical images
+    BMP8Free(horizontal);
+    BMP8Free(vertical);
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
-        free(img);
-    }
+    return true;
 }
 
+// Allocating variant of BMP8EdgeDetectionSobelCombinedInto
+// The magnitude overwrites the horizontal edges, so only two buffers are held
 BMP8Image* BMP8EdgeDetectionSobelCombined(BMP8Image* img){
     if(!img){
         fprintf(stderr, "Edge Detection Error: No image provided.\n");
         return NULL;
     }
 
-    // Calculate horizontal edges
     BMP8Image* horizontal = BMP8EdgeDetectionSobelHorizontal(img);
-    // Calculate vertical edges
-    BMP8Image* vertical   = BMP8EdgeDetectionSobelVertical(img);
+    BMP8Image* vertical = BMP8EdgeDetectionSobelVertical(img);
+    if(!horizontal || !vertical){
+        BMP8Free(horizontal);
+        BMP8Free(vertical);
+        return NULL;
+    }
+
+    BMP8SobelMagnitude(horizontal, vertical, horizontal);
+    BMP8Free(vertical);
+    return horizontal;
+}
+
+// Gaussian smoothing, Sobel gradients and non-maximum suppression with double threshold
+// for the tile at (x0, y0), then labelling of the tile's weak and strong pixels by flood
+// fill; each component gets the index of its seed and is marked strong at the seed
+// classes and labels are width x height without padding; kernel has radius entries on each side
+static bool cannyTile(BMP8Image* img, const float* kernel, int radius, float low, float high,
+                      int x0, int y0, unsigned char* classes, int* labels){
+    int w = MIN(CANNY_TILE, img->width - x0), h = MIN(CANNY_TILE, img->height - y0);
+    int rowSize = (img->width + 3) & ~3;
+
+    // Smoothed tile with a 2 pixel margin (gradients of the 1 pixel margin need one more);
+    // source coordinates are clamped, so every value depends only on its image position
+    int sw = w + 4, sh = h + 4, hh = sh + 2 * radius;
+    float* across = malloc((size_t)hh * sw * sizeof(float));
+    float* smooth = malloc((size_t)sh * sw * sizeof(float));
+    // Gradient magnitude and direction with a 1 pixel margin
+    int gw = w + 2, gh = h + 2;
+    float* magnitude = malloc((size_t)gh * gw * sizeof(float));
+    unsigned char* direction = malloc((size_t)gh * gw);
+    int* stack = malloc((size_t)w * h * sizeof(int));
+    bool ok = across && smooth && magnitude && direction && stack;
+
+    if(ok){
+        // Horizontal pass of the separable Gaussian
+        for(int i = 0; i < hh; i++){
+            int y = MIN(MAX(y0 - 2 - radius + i, 0), img->height - 1);
+            const unsigned char* src = img->data + y * rowSize;
+            for(int j = 0; j < sw; j++){
+                float v = 0.0f;
+                for(int k = -radius; k <= radius; k++){
+                    int x = MIN(MAX(x0 - 2 + j + k, 0), img->width - 1);
+                    v += kernel[k + radius] * src[x];
+                }
+                across[i * sw + j] = v;
+            }
+        }
+        // Vertical pass
+        for(int i = 0; i < sh; i++){
+            for(int j = 0; j < sw; j++){
+                float v = 0.0f;
+                for(int k = 0; k <= 2 * radius; k++){
+                    v += kernel[k] * across[(i + k) * sw + j];
+                }
+                smooth[i * sw + j] = v;
+            }
+        }
+
+        // Sobel gradients, magnitude and direction in one pass; outside the image the magnitude is 0
+        // Directions: 0 gradient along x, 1 along the x = y diagonal, 2 along y, 3 along x = -y
+        for(int i = 0; i < gh; i++){
+            for(int j = 0; j < gw; j++){
+                int x = x0 - 1 + j, y = y0 - 1 + i;
+                float gx = 0.0f, gy = 0.0f;
+                if(x >= 0 && x < img->width && y >= 0 && y < img->height){
+                    for(int a = 0; a < 3; a++){
+                        for(int b = 0; b < 3; b++){
+                            float v = smooth[(i + a) * sw + j + b];
+                            gx += sobelVerticalTaps[a * 3 + b] * v;
+                            gy += sobelHorizontalTaps[a * 3 + b] * v;
+                        }
+                    }
+                }
+                magnitude[i * gw + j] = sqrtf(gx * gx + gy * gy);
+
+                // Sector boundaries at 22.5 and 67.5 degrees
+                float ax = fabsf(gx), ay = fabsf(gy);
+                if(ay <= 0.41421356f * ax){
+                    direction[i * gw + j] = 0;
+                } else if(ay >= 2.41421356f * ax){
+                    direction[i * gw + j] = 2;
+                } else {
+                    direction[i * gw + j] = (gx > 0) == (gy > 0) ? 1 : 3;
+                }
+            }
+        }
 
-    // Allocate new image for combined edges
-    BMP8Image* edgeImg = malloc(sizeof(BMP8Image));
-    memcpy(edgeImg->header, img->header, BMP_HEADER_SIZE);
-    edgeImg->width = img->width;
-    edgeImg->height = img->height;
-    edgeImg->bitDepth = img->bitDepth;
+        // Non-maximum suppression along the gradient and double threshold
+        // Ties keep the first pixel only, so plateaus stay one pixel thin
+        static const int stepX[4] = {1, 1, 0, 1};
+        static const int stepY[4] = {0, 1, 1, -1};
+        for(int i = 0; i < h; i++){
+            for(int j = 0; j < w; j++){
+                int g = (i + 1) * gw + j + 1;
+                int d = direction[g];
+                int offset = stepY[d] * gw + stepX[d];
+                float m = magnitude[g];
+                unsigned char c = 0;
+                if(m >= low && m > magnitude[g + offset] && m >= magnitude[g - offset]){
+                    c = m >= high ? CANNY_STRONG : CANNY_WEAK;
+                }
+                int p = (y0 + i) * img->width + x0 + j;
+                classes[p] = c;
+                labels[p] = -1;
+            }
+        }
 
-    // Copy color table for 8-bit grayscale images
-    if (img->bitDepth <= 8){
-        memcpy(edgeImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        // Label the tile's components with a work-list flood fill (8-connected)
+        for(int i = 0; i < h; i++){
+            for(int j = 0; j < w; j++){
+                int seed = (y0 + i) * img->width + x0 + j;
+                if(!classes[seed] || labels[seed] >= 0){
+                    continue;
+                }
+                bool strong = false;
+                int top = 0;
+                labels[seed] = seed;
+                stack[top++] = seed;
+                while(top > 0){
+                    int p = stack[--top];
+                    strong = strong || classes[p] == CANNY_STRONG;
+                    int px = p % img->width, py = p / img->width;
+                    for(int ny = MAX(py - 1, y0); ny <= MIN(py + 1, y0 + h - 1); ny++){
+                        for(int nx = MAX(px - 1, x0); nx <= MIN(px + 1, x0 + w - 1); nx++){
+                            int q = ny * img->width + nx;
+                            if(classes[q] && labels[q] < 0){
+                                labels[q] = seed;
+                                stack[top++] = q;
+                            }
+                        }
+                    }
+                }
+                if(strong){
+                    classes[seed] = CANNY_STRONG;
+                }
+            }
+        }
     }
 
-    int rowSize = (img->width + 3) & ~3;
-    edgeImg->imgSize = rowSize * img->height;
+    free(across);
+    free(smooth);
+    free(magnitude);
+    free(direction);
+    free(stack);
+    return ok;
+}
 
-    // Allocate memory for pixel data
-    edgeImg->data = malloc(edgeImg->imgSize);
+// Root of the component of pixel p: labels point towards the root, which labels itself
+static int cannyFind(const int* labels, int p){
+    while(labels[p] != p){
+        p = labels[p];
+    }
+    return p;
+}
 
-    // Combine horizontal and vertical edges
-    for(int y = 0; y < img->height; y++){
-        for(int x = 0; x < img->width; x++){
-            int idx = y * img->width + x;
-            // horizontal
-            int gx = horizontal->data[idx];
-            // vertical
-            int gy = vertical->data[idx];
-            // Compute mean magnitude
-            int g = (int)(sqrt(gx*gx + gy*gy));
-            g = MIN(g, MAX_BRIGHTNESS);
+// Merge the components of two candidate pixels; the root keeps the strong mark of either
+static void cannyUnion(unsigned char* classes, int* labels, int p, int q){
+    int a = cannyFind(labels, p), b = cannyFind(labels, q);
+    if(a == b){
+        return;
+    }
+    if(a > b){
+        int t = a;
+        a = b;
+        b = t;
+    }
+    labels[b] = a;
+    if(classes[b] == CANNY_STRONG){
+        classes[a] = CANNY_STRONG;
+    }
+    // Shorten the paths just walked
+    labels[p] = a;
+    labels[q] = a;
+}
+
+// Canny edge detector, writing a binary edge map (0 or 255) into a caller-supplied image
+// sigma: Gaussian smoothing; low, high: gradient magnitude thresholds of the hysteresis
+// Tiles run in parallel (OpenMP); dst may alias img: it is written after every tile is done
+bool BMP8EdgeDetectionCannyInto(BMP8Image* img, float sigma, float low, float high, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Edge Detection Error: No image provided.\n");
+        return false;
+    }
+    if(!(sigma > 0.0f) || !(low <= high)){
+        fprintf(stderr, "Edge Detection Error: Canny needs sigma > 0 and low <= high.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+
+    // Sampled and normalized Gaussian of radius 3 sigma
+    int radius = (int)ceilf(3.0f * sigma);
+    mask* kernel = maskCreate(1, 2 * radius + 1);
+    if(!kernel || !kernel->data){
+        fprintf(stderr, "Memory allocation failed!\n");
+        maskFree(kernel);
+        return false;
+    }
+    float sum = 0.0f;
+    for(int k = -radius; k <= radius; k++){
+        kernel->data[k + radius] = expf(-(float)(k * k) / (2.0f * sigma * sigma));
+        sum += kernel->data[k + radius];
+    }
+    for(int k = 0; k <= 2 * radius; k++){
+        kernel->data[k] /= sum;
+    }
 
-            edgeImg->data[idx] = (unsigned char)g;
+    size_t pixels = (size_t)img->width * img->height;
+    unsigned char* classes = malloc(pixels);
+    int* labels = malloc(pixels * sizeof(int));
+    bool ok = classes && labels;
+    if(!ok){
+        fprintf(stderr, "Memory allocation failed!\n");
+    }
+
+    // Step 1: every tile independently, up to components labelled within the tile
+    int tilesX = (img->width + CANNY_TILE - 1) / CANNY_TILE;
+    int tiles = ok ? tilesX * ((img->height + CANNY_TILE - 1) / CANNY_TILE) : 0;
+    #pragma omp parallel for schedule(dynamic)
+    for(int t = 0; t < tiles; t++){
+        if(!cannyTile(img, kernel->data, radius, low, high, t % tilesX * CANNY_TILE, t / tilesX * CANNY_TILE, classes, labels)){
+            fprintf(stderr, "Memory allocation failed for Canny tile!\n");
+            #pragma omp atomic write
+            ok = false;
         }
     }
 
-    // Free temporary horizontal and vertical images
-    BMP8Free(horizontal);
-    BMP8Free(vertical);
+    // Step 2: union-find across tile boundaries; the pixels on the right and bottom
+    // edges of each tile meet every 8-neighbor that lies in another tile
+    if(ok){
+        for(int y = 0; y < img->height; y++){
+            bool bottom = y % CANNY_TILE == CANNY_TILE - 1 && y + 1 < img->height;
+            for(int x = 0; x < img->width; x++){
+                bool right = x % CANNY_TILE == CANNY_TILE - 1 && x + 1 < img->width;
+                int p = y * img->width + x;
+                if(!classes[p] || (!right && !bottom)){
+                    continue;
+                }
+                if(right){
+                    for(int ny = MAX(y - 1, 0); ny <= MIN(y + 1, img->height - 1); ny++){
+                        if(classes[ny * img->width + x + 1]){
+                            cannyUnion(classes, labels, p, ny * img->width + x + 1);
+                        }
+                    }
+                }
+                if(bottom){
+                    for(int nx = MAX(x - 1, 0); nx <= MIN(x + 1, img->width - 1); nx++){
+                        if(classes[p + img->width - x + nx]){
+                            cannyUnion(classes, labels, p, p + img->width - x + nx);
+                        }
+                    }
+                }
+            }
+        }
+    }
 
-    // Return combined edge image
-    return edgeImg;
+    // Step 3: hysteresis result, every pixel of a component holding a strong pixel is an edge
+    if(ok){
+        int rowSize = (img->width + 3) & ~3;
+        #pragma omp parallel for
+        for(int y = 0; y < img->height; y++){
+            for(int x = 0; x < img->width; x++){
+                int p = y * img->width + x;
+                bool edge = classes[p] && classes[cannyFind(labels, p)] == CANNY_STRONG;
+                dst->data[y * rowSize + x] = edge ? MAX_BRIGHTNESS : MIN_BRIGHTNESS;
+            }
+        }
+    }
+
+    free(classes);
+    free(labels);
+    maskFree(kernel);
+    return ok;
+}
+
+// Allocating variant of BMP8EdgeDetectionCannyInto
+BMP8Image* BMP8EdgeDetectionCanny(BMP8Image* img, float sigma, float low, float high){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8EdgeDetectionCannyInto(img, sigma, low, high, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
 // Function to save an 8-bit BMP image to a file
@@ -308,7 +818,180 @@ void BMP8save(const char* filename, BMP8Image* img) {
     fclose(fOutput);
 }
 
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Signature of an 8-bit operator that can be applied to every color channel
+typedef BMP8Image* (*BMP8Operator)(BMP8Image* img);
+
+// Apply an 8-bit operator to each channel of a 24-bit BMP image
+// The channels are split once into 8-bit planes and processed in parallel
+BMP24Image* BMP24ApplyPerChannel(BMP24Image* img, BMP8Operator op){
+    if(!img || !op){
+        fprintf(stderr, "Edge Detection Error: Either there is no image or operator.\n");
+        return NULL;
+    }
+
+    // Allocate memory for the new image
+    BMP24Image* outImg = malloc(sizeof(BMP24Image));
+    if(!outImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(outImg->header, img->header, BMP_HEADER_SIZE);
+    outImg->width = img->width;
+    outImg->height = img->height;
+    outImg->bitDepth = img->bitDepth;
+    outImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    outImg->data = calloc(img->rowSize * img->height, 1);
+    if (!outImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(outImg);
+        return NULL;
+    }
+
+    // Row size of an 8-bit plane (padded to 4 bytes)
+    int rowSize8 = (img->width + 3) & ~3;
+    int failed = 0;
+
+    #pragma omp parallel for reduction(|:failed)
+    for(int c = 0; c < 3; c++){
+        // Describe channel c as an 8-bit greyscale image
+        BMP8Image plane;
+        memcpy(plane.header, img->header, BMP_HEADER_SIZE);
+        plane.width = img->width;
+        plane.height = img->height;
+        plane.bitDepth = 8;
+        plane.imgSize = rowSize8 * img->height;
+        *(short*)&plane.header[28] = 8;
+        *(int*)&plane.header[10] = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE;
+        *(int*)&plane.header[34] = plane.imgSize;
+        for(int i = 0; i < 256; i++){
+            plane.colorTable[i*4 + 0] = i;
+            plane.colorTable[i*4 + 1] = i;
+            plane.colorTable[i*4 + 2] = i;
+            plane.colorTable[i*4 + 3] = 0;
+        }
+
+        plane.data = calloc(plane.imgSize, 1);
+        if(!plane.data){
+            failed = 1;
+            continue;
+        }
+
+        // Extract the channel
+        for(int y = 0; y < img->height; y++){
+            const unsigned char* src = img->data + y * img->rowSize + c;
+            unsigned char* dst = plane.data + y * rowSize8;
+            for(int x = 0; x < img->width; x++){
+                dst[x] = src[x * 3];
+            }
+        }
+
+        // Run the 8-bit operator and merge its result back into channel c
+        BMP8Image* result = op(&plane);
+        if(!result){
+            failed = 1;
+        } else {
+            for(int y = 0; y < img->height; y++){
+                const unsigned char* src = result->data + y * rowSize8;
+                unsigned char* dst = outImg->data + y * outImg->rowSize + c;
+                for(int x = 0; x < img->width; x++){
+                    dst[x * 3] = src[x];
+                }
+            }
+            BMP8Free(result);
+        }
+        free(plane.data);
+    }
+
+    if(failed){
+        fprintf(stderr, "Edge Detection Error: Operator failed on a color channel.\n");
+        BMP24Free(outImg);
+        return NULL;
+    }
+    return outImg;
+}
+
 int main(){
+    // Recycle pixel buffers across all operators run by this program
+    pixelPool = poolCreate(64 * 1024 * 1024);
+
     const char *inputFile  = "../Test_Images/lizard_greyscale8bit.bmp";
 
     // Output files
@@ -335,6 +1018,24 @@ int main(){
     BMP8Image *combined = BMP8EdgeDetectionSobelCombined(image);
     BMP8save(outputCombined, combined);
 
+    // Canny edges: sigma 1.4, hysteresis between gradient magnitudes 40 and 100
+    BMP8Image *canny = BMP8EdgeDetectionCanny(image, 1.4f, 40.0f, 100.0f);
+    if(canny){
+        BMP8save("images/lizard_edges_canny.bmp", canny);
+        BMP8Free(canny);
+    }
+
+    // Apply combined edge detection to every channel of a color image
+    BMP24Image *image24 = BMP24Read("../Test_Images/lena_color.bmp");
+    if(image24){
+        BMP24Image *combined24 = BMP24ApplyPerChannel(image24, BMP8EdgeDetectionSobelCombined);
+        if(combined24){
+            BMP24Save("images/lena_color_edges_combined.bmp", combined24);
+            BMP24Free(combined24);
+        }
+        BMP24Free(image24);
+    }
+
     // Free all allocated memory
     BMP8Free(image);
     BMP8Free(horizontal);
@@ -344,5 +1045,11 @@ int main(){
     printf("Sobel edge detection completed!\nHorizontal: %s\nVertical: %s\nCombined: %s\n",
            outputHorizontal, outputVertical, outputCombined);
 
+    // Report buffer reuse and release the cached buffers
+    if(pixelPool){
+        printf("Pixel pool: %lu buffers reused, %lu allocated\n", pixelPool->hits, pixelPool->misses);
+        poolDestroy(pixelPool);
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -25,6 +25,16 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
 
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
@@ -76,42 +86,96 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-BMP8Image* BMP8FilterMaximum(BMP8Image* img, int kernelSize){
-    // Allocate memory for the new image
-    BMP8Image* filteredImg = malloc(sizeof(BMP8Image));
-    if(!filteredImg){
-        fprintf(stderr, "Filter Error: Memory allocation failed!\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
-    // Copy image metadata
-    memcpy(filteredImg->header, img->header, BMP_HEADER_SIZE);
-    filteredImg->width = img->width;
-    filteredImg->height = img->height;
-    filteredImg->bitDepth = img->bitDepth;
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
 
-    // Copy color table if 8-bit grayscale
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
+
+    // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(filteredImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
-    // Compute padded row size
+    // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    filteredImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
     // Allocate memory for pixel data
-    filteredImg->data = malloc(filteredImg->imgSize);
-    if (!filteredImg->data) {
-        fprintf(stderr, "Filter Error: Memory allocation failed for pixel data!\n");
-        free(filteredImg);
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Maximum filter writing into a caller-supplied image
+// dst must have the size of img and must not alias it; border pixels are copied unchanged
+bool BMP8FilterMaximumInto(BMP8Image* img, int kernelSize, BMP8Image* dst){
+    if (!BMP8CheckDestination(img, dst)) {
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Filter Error: In-place maximum filtering is not supported.\n");
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
     // Copy original image data
-    memcpy(filteredImg->data, img->data, img->imgSize);
+    memcpy(dst->data, img->data, img->imgSize);
 
     // Apply maximum filter
-    for(int j = kernelSize/2; j < (filteredImg->height - kernelSize/2); j++){
-        for(int i = kernelSize/2; i < (filteredImg->width - kernelSize/2); i++){
+    for(int j = kernelSize/2; j < (img->height - kernelSize/2); j++){
+        for(int i = kernelSize/2; i < (img->width - kernelSize/2); i++){
             unsigned char maxValue = MIN_BRIGHTNESS;
             for(int y = -kernelSize/2; y < kernelSize/2; y++){
                 for(int x = -kernelSize/2; x < kernelSize/2; x++){
@@ -122,11 +186,24 @@ BMP8Image* BMP8FilterMaximum(BMP8Image* img, int kernelSize){
                 }
             }
 
-            filteredImg->data[j * rowSize + i] = maxValue;
+            dst->data[j * rowSize + i] = maxValue;
         }
     }
 
-    return filteredImg;
+    return true;
+}
+
+// Maximum filter returning a newly allocated image
+BMP8Image* BMP8FilterMaximum(BMP8Image* img, int kernelSize){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8FilterMaximumInto(img, kernelSize, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
 
@@ -150,14 +227,133 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
+
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
         free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
     }
 }
 
+// Maximum filter for 24-bit images, all channels in a single pass
+BMP24Image* BMP24FilterMaximum(BMP24Image* img, int kernelSize){
+    // Allocate memory for the new image
+    BMP24Image* filteredImg = malloc(sizeof(BMP24Image));
+    if(!filteredImg){
+        fprintf(stderr, "Filter Error: Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(filteredImg->header, img->header, BMP_HEADER_SIZE);
+    filteredImg->width = img->width;
+    filteredImg->height = img->height;
+    filteredImg->bitDepth = img->bitDepth;
+    filteredImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    filteredImg->data = malloc(img->rowSize * img->height);
+    if (!filteredImg->data) {
+        fprintf(stderr, "Filter Error: Memory allocation failed for pixel data!\n");
+        free(filteredImg);
+        return NULL;
+    }
+    // Copy original image data (so border pixels remain unchanged)
+    memcpy(filteredImg->data, img->data, img->rowSize * img->height);
+
+    // Apply maximum filter
+    for(int j = kernelSize/2; j < (filteredImg->height - kernelSize/2); j++){
+        for(int i = kernelSize/2; i < (filteredImg->width - kernelSize/2); i++){
+            // Running maximum of blue, green and red
+            unsigned char maxValue[3] = {MIN_BRIGHTNESS, MIN_BRIGHTNESS, MIN_BRIGHTNESS};
+            for(int y = -kernelSize/2; y < kernelSize/2; y++){
+                const unsigned char* row = img->data + (j + y) * img->rowSize;
+                for(int x = -kernelSize/2; x < kernelSize/2; x++){
+                    const unsigned char* px = row + (i + x) * 3;
+                    for(int c = 0; c < 3; c++){
+                        if (maxValue[c] < px[c]){
+                            maxValue[c] = px[c];
+                        }
+                    }
+                }
+            }
+
+            unsigned char* out = filteredImg->data + j * img->rowSize + i * 3;
+            out[0] = maxValue[0];
+            out[1] = maxValue[1];
+            out[2] = maxValue[2];
+        }
+    }
+
+    return filteredImg;
+}
 
 int main() {
     const char* inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
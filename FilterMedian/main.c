@@ -23,6 +23,16 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
 
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
@@ -82,51 +92,98 @@ void BMP8Free(BMP8Image* img) {
     }
 }
 
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
+        return NULL;
+    }
 
-BMP8Image* BMP8FilterMedian(BMP8Image* img, int kernelSize){
-    // Allocate memory for the new image
-    BMP8Image* filteredImg = malloc(sizeof(BMP8Image));
-    if(!filteredImg){
-        fprintf(stderr, "Filter Error: Memory allocation failed!\n");
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
+        fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
-    // Copy image metadata
-    memcpy(filteredImg->header, img->header, BMP_HEADER_SIZE);
-    filteredImg->width = img->width;
-    filteredImg->height = img->height;
-    filteredImg->bitDepth = img->bitDepth;
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
-    // Copy color table if 8-bit grayscale
+    // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(filteredImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
-    // Compute padded row size
+    // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    filteredImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
     // Allocate memory for pixel data
-    filteredImg->data = malloc(filteredImg->imgSize);
-    if (!filteredImg->data) {
-        fprintf(stderr, "Filter Error: Memory allocation failed for pixel data!\n");
-        free(filteredImg);
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+
+// Median filter writing into a caller-supplied image
+// dst must have the size of img and must not alias it; border pixels are copied unchanged
+bool BMP8FilterMedianInto(BMP8Image* img, int kernelSize, BMP8Image* dst){
+    if (!BMP8CheckDestination(img, dst)) {
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Filter Error: In-place median filtering is not supported.\n");
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
     // Copy original image data
-    memcpy(filteredImg->data, img->data, img->imgSize);
+    memcpy(dst->data, img->data, img->imgSize);
 
-    int windowSize = kernelSize * kernelSize;
+    // The window spans -kernelSize/2..kernelSize/2, so even sizes round up
+    int windowSide = 2 * (kernelSize / 2) + 1;
+    int windowSize = windowSide * windowSide;
     unsigned char* window = malloc(windowSize);
     if (!window) {
         fprintf(stderr, "Filter Error: Memory allocation failed for window!\n");
-        BMP8Free(filteredImg);
-        return NULL;
+        return false;
     }
 
-    // Apply minimum filter
-    for(int j = kernelSize/2; j < (filteredImg->height - kernelSize/2); j++){
-        for(int i = kernelSize/2; i < (filteredImg->width - kernelSize/2); i++){
+    // Apply median filter
+    for(int j = kernelSize/2; j < (img->height - kernelSize/2); j++){
+        for(int i = kernelSize/2; i < (img->width - kernelSize/2); i++){
             int count = 0;
 
             // Collect values in the neighborhood
@@ -147,11 +204,25 @@ BMP8Image* BMP8FilterMedian(BMP8Image* img, int kernelSize){
             }
             // Pick the median value
             unsigned char median = window[count / 2];
-            filteredImg->data[j * rowSize + i] = median;
+            dst->data[j * rowSize + i] = median;
         }
     }
 
-    return filteredImg;
+    free(window);
+    return true;
+}
+
+// Median filter returning a newly allocated image
+BMP8Image* BMP8FilterMedian(BMP8Image* img, int kernelSize){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8FilterMedianInto(img, kernelSize, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
 
@@ -174,6 +245,160 @@ void BMP8save(const char* filename, BMP8Image* img) {
     fclose(fOutput);
 }
 
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Median filter for 24-bit images, all channels in a single pass
+BMP24Image* BMP24FilterMedian(BMP24Image* img, int kernelSize){
+    if(!img){
+        fprintf(stderr, "Filter Error: No image provided.\n");
+        return NULL;
+    }
+
+    // Allocate memory for the new image
+    BMP24Image* filteredImg = malloc(sizeof(BMP24Image));
+    if(!filteredImg){
+        fprintf(stderr, "Filter Error: Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(filteredImg->header, img->header, BMP_HEADER_SIZE);
+    filteredImg->width = img->width;
+    filteredImg->height = img->height;
+    filteredImg->bitDepth = img->bitDepth;
+    filteredImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    filteredImg->data = malloc(img->rowSize * img->height);
+    if (!filteredImg->data) {
+        fprintf(stderr, "Filter Error: Memory allocation failed for pixel data!\n");
+        free(filteredImg);
+        return NULL;
+    }
+    // Copy original image data (so border pixels remain unchanged)
+    memcpy(filteredImg->data, img->data, img->rowSize * img->height);
+
+    // The window spans -kernelSize/2..kernelSize/2, so even sizes round up
+    int windowSide = 2 * (kernelSize / 2) + 1;
+    int windowSize = windowSide * windowSide;
+    // One window per channel (blue, green, red)
+    unsigned char* window = malloc(3 * windowSize);
+    if (!window) {
+        fprintf(stderr, "Filter Error: Memory allocation failed for window!\n");
+        BMP24Free(filteredImg);
+        return NULL;
+    }
+
+    // Apply median filter
+    for(int j = kernelSize/2; j < (filteredImg->height - kernelSize/2); j++){
+        for(int i = kernelSize/2; i < (filteredImg->width - kernelSize/2); i++){
+            int count = 0;
+
+            // Collect values in the neighborhood
+            for (int y = -kernelSize/2; y <= kernelSize/2; y++) {
+                for (int x = -kernelSize/2; x <= kernelSize/2; x++) {
+                    const unsigned char* px = img->data + (j + y) * img->rowSize + (i + x) * 3;
+                    window[count] = px[0];
+                    window[windowSize + count] = px[1];
+                    window[2 * windowSize + count] = px[2];
+                    count++;
+                }
+            }
+
+            for (int c = 0; c < 3; c++) {
+                unsigned char* w = window + c * windowSize;
+                // Sort values
+                for (int m = 0; m < count - 1; m++) {
+                    for (int n = 0; n < count - m - 1; n++) {
+                        if (w[n] > w[n + 1]) {
+                            unsigned char tmp = w[n];
+                            w[n] = w[n + 1];
+                            w[n + 1] = tmp;
+                        }
+                    }
+                }
+                // Pick the median value
+                filteredImg->data[j * img->rowSize + i * 3 + c] = w[count / 2];
+            }
+        }
+    }
+
+    free(window);
+    return filteredImg;
+}
+
 int main() {
     const char* inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
     const char* outputFile = "images/lizard_filtered_med_20.bmp";
@@ -194,6 +419,17 @@ int main() {
     // Save the filtered image to file
     BMP8save(outputFile, filtered);
 
+    // Apply median filter with a 3x3 kernel to a 24-bit color image
+    BMP24Image *image24 = BMP24Read("../Test_Images/lena_color.bmp");
+    if (image24) {
+        BMP24Image *filtered24 = BMP24FilterMedian(image24, 3);
+        if (filtered24) {
+            BMP24Save("images/lena_color_filtered_med_3.bmp", filtered24);
+            BMP24Free(filtered24);
+        }
+        BMP24Free(image24);
+    }
+
     // Free allocated memory
     BMP8Free(image);
     BMP8Free(filtered);
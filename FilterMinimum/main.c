@@ -12,6 +12,10 @@
 #define MAX_BRIGHTNESS 255
 // Minimum value of a pixel
 #define MIN_BRIGHTNESS 0
+// Rows of one variant filtered together by a sweep
+#define SWEEP_BAND 64
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
 // Structure to hold 8-bit BMP image data
 typedef struct {
     unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
@@ -23,6 +27,16 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
 
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
@@ -74,42 +88,96 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-BMP8Image* BMP8FilterMinimum(BMP8Image* img, int kernelSize){
-    // Allocate memory for the new image
-    BMP8Image* filteredImg = malloc(sizeof(BMP8Image));
-    if(!filteredImg){
-        fprintf(stderr, "Filter Error: Memory allocation failed!\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
-    // Copy image metadata
-    memcpy(filteredImg->header, img->header, BMP_HEADER_SIZE);
-    filteredImg->width = img->width;
-    filteredImg->height = img->height;
-    filteredImg->bitDepth = img->bitDepth;
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
-    // Copy color table if 8-bit grayscale
+    // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(filteredImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
-    // Compute padded row size
+    // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    filteredImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
     // Allocate memory for pixel data
-    filteredImg->data = malloc(filteredImg->imgSize);
-    if (!filteredImg->data) {
-        fprintf(stderr, "Filter Error: Memory allocation failed for pixel data!\n");
-        free(filteredImg);
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Minimum filter writing into a caller-supplied image
+// dst must have the size of img and must not alias it; border pixels are copied unchanged
+bool BMP8FilterMinimumInto(BMP8Image* img, int kernelSize, BMP8Image* dst){
+    if (!BMP8CheckDestination(img, dst)) {
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Filter Error: In-place minimum filtering is not supported.\n");
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
     // Copy original image data
-    memcpy(filteredImg->data, img->data, img->imgSize);
+    memcpy(dst->data, img->data, img->imgSize);
 
     // Apply minimum filter
-    for(int j = kernelSize/2; j < (filteredImg->height - kernelSize/2); j++){
-        for(int i = kernelSize/2; i < (filteredImg->width - kernelSize/2); i++){
+    for(int j = kernelSize/2; j < (img->height - kernelSize/2); j++){
+        for(int i = kernelSize/2; i < (img->width - kernelSize/2); i++){
             unsigned char minValue = MAX_BRIGHTNESS;
             for(int y = -kernelSize/2; y < kernelSize/2; y++){
                 for(int x = -kernelSize/2; x < kernelSize/2; x++){
@@ -120,13 +188,136 @@ BMP8Image* BMP8FilterMinimum(BMP8Image* img, int kernelSize){
                 }
             }
 
-            filteredImg->data[j * rowSize + i] = minValue;
+            dst->data[j * rowSize + i] = minValue;
         }
     }
 
-    return filteredImg;
+    return true;
 }
 
+// Minimum filter returning a newly allocated image
+BMP8Image* BMP8FilterMinimum(BMP8Image* img, int kernelSize){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8FilterMinimumInto(img, kernelSize, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
+
+
+// Minimum filters of several kernel sizes over one image, in parallel.
+// results[k] receives a newly allocated image filtered with kernelSizes[k], identical
+// to BMP8FilterMinimum(img, kernelSizes[k]). Every kernel reads one shared pyramid:
+// level p holds the minimum of each 2^p x 2^p square, so any square window of side
+// w is the minimum of four overlapping level-p squares with 2^p <= w < 2^(p+1).
+// The pyramid costs about one pass per level, once, instead of per-kernel window scans
+bool BMP8FilterMinimumSweep(BMP8Image* img, const int* kernelSizes, int count, BMP8Image** results){
+    if(!img || !kernelSizes || !results || count < 1){
+        fprintf(stderr, "Filter Error: Either there is no image or no kernel sizes.\n");
+        return false;
+    }
+    int rowSize = (img->width + 3) & ~3;
+
+    // Window of kernel size k spans [-k/2, k/2) in both directions, so its side is 2 * (k/2)
+    int maxSide = 0;
+    for(int k = 0; k < count; k++){
+        if(kernelSizes[k] < 1){
+            fprintf(stderr, "Filter Error: Invalid kernel size %d.\n", kernelSizes[k]);
+            return false;
+        }
+        int side = 2 * (kernelSizes[k] / 2);
+        if(side <= img->width && side <= img->height && side > maxSide){
+            maxSide = side;
+        }
+    }
+    int levels = 1;
+    while((2 << (levels - 1)) <= maxSide){
+        levels++;
+    }
+
+    // Shared pyramid; level 0 is the image itself
+    unsigned char** pyramid = calloc(levels, sizeof(unsigned char*));
+    bool ok = pyramid != NULL;
+    for(int p = 1; ok && p < levels; p++){
+        pyramid[p] = malloc(img->imgSize);
+        ok = pyramid[p] != NULL;
+    }
+    for(int k = 0; k < count; k++){
+        results[k] = ok ? BMP8CreateLike(img) : NULL;
+        ok = ok && results[k] != NULL;
+    }
+    if(!ok){
+        fprintf(stderr, "Filter Error: Memory allocation failed!\n");
+        for(int p = 1; pyramid && p < levels; p++){
+            free(pyramid[p]);
+        }
+        free(pyramid);
+        for(int k = 0; k < count; k++){
+            BMP8Free(results[k]);
+            results[k] = NULL;
+        }
+        return false;
+    }
+    pyramid[0] = img->data;
+    for(int p = 1; p < levels; p++){
+        int half = 1 << (p - 1), size = 1 << p;
+        const unsigned char* below = pyramid[p - 1];
+        #pragma omp parallel for schedule(static)
+        for(int y = 0; y <= img->height - size; y++){
+            const unsigned char* a = below + (size_t)y * rowSize;
+            const unsigned char* b = a + (size_t)half * rowSize;
+            unsigned char* out = pyramid[p] + (size_t)y * rowSize;
+            for(int x = 0; x <= img->width - size; x++){
+                out[x] = MIN(MIN(a[x], a[x + half]), MIN(b[x], b[x + half]));
+            }
+        }
+    }
+
+    // Every band of every variant is independent
+    int bands = (img->height + SWEEP_BAND - 1) / SWEEP_BAND;
+    #pragma omp parallel for collapse(2) schedule(dynamic)
+    for(int k = 0; k < count; k++){
+        for(int band = 0; band < bands; band++){
+            BMP8Image* dst = results[k];
+            int half = kernelSizes[k] / 2, side = 2 * half;
+            int p = 0;
+            while(p + 1 < levels && (2 << p) <= side){
+                p++;
+            }
+            int offset = side - (1 << p);
+            const unsigned char* level = pyramid[p];
+            int y0 = band * SWEEP_BAND, y1 = MIN(y0 + SWEEP_BAND, img->height);
+            for(int j = y0; j < y1; j++){
+                unsigned char* out = dst->data + (size_t)j * rowSize;
+                memcpy(out, img->data + (size_t)j * rowSize, rowSize);
+                if(j < half || j >= img->height - half){
+                    continue;
+                }
+                if(side == 0){
+                    // Empty window, as in BMP8FilterMinimum
+                    memset(out + half, MAX_BRIGHTNESS, img->width - 2 * half);
+                    continue;
+                }
+                const unsigned char* top = level + (size_t)(j - half) * rowSize;
+                const unsigned char* bottom = top + (size_t)offset * rowSize;
+                for(int i = half; i < img->width - half; i++){
+                    int x = i - half;
+                    out[i] = MIN(MIN(top[x], top[x + offset]), MIN(bottom[x], bottom[x + offset]));
+                }
+            }
+        }
+    }
+
+    for(int p = 1; p < levels; p++){
+        free(pyramid[p]);
+    }
+    free(pyramid);
+    return true;
+}
 
 // Function to save an 8-bit BMP image to a file
 void BMP8save(const char* filename, BMP8Image* img) {
@@ -148,38 +339,179 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
+
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
         free(img);
+        fclose(file);
+        return NULL;
     }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
 }
 
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Minimum filter for 24-bit images, all channels in a single pass
+BMP24Image* BMP24FilterMinimum(BMP24Image* img, int kernelSize){
+    // Allocate memory for the new image
+    BMP24Image* filteredImg = malloc(sizeof(BMP24Image));
+    if(!filteredImg){
+        fprintf(stderr, "Filter Error: Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(filteredImg->header, img->header, BMP_HEADER_SIZE);
+    filteredImg->width = img->width;
+    filteredImg->height = img->height;
+    filteredImg->bitDepth = img->bitDepth;
+    filteredImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    filteredImg->data = malloc(img->rowSize * img->height);
+    if (!filteredImg->data) {
+        fprintf(stderr, "Filter Error: Memory allocation failed for pixel data!\n");
+        free(filteredImg);
+        return NULL;
+    }
+    // Copy original image data (so border pixels remain unchanged)
+    memcpy(filteredImg->data, img->data, img->rowSize * img->height);
+
+    // Apply minimum filter
+    for(int j = kernelSize/2; j < (filteredImg->height - kernelSize/2); j++){
+        for(int i = kernelSize/2; i < (filteredImg->width - kernelSize/2); i++){
+            // Running minimum of blue, green and red
+            unsigned char minValue[3] = {MAX_BRIGHTNESS, MAX_BRIGHTNESS, MAX_BRIGHTNESS};
+            for(int y = -kernelSize/2; y < kernelSize/2; y++){
+                const unsigned char* row = img->data + (j + y) * img->rowSize;
+                for(int x = -kernelSize/2; x < kernelSize/2; x++){
+                    const unsigned char* px = row + (i + x) * 3;
+                    for(int c = 0; c < 3; c++){
+                        if (minValue[c] > px[c]){
+                            minValue[c] = px[c];
+                        }
+                    }
+                }
+            }
+
+            unsigned char* out = filteredImg->data + j * img->rowSize + i * 3;
+            out[0] = minValue[0];
+            out[1] = minValue[1];
+            out[2] = minValue[2];
+        }
+    }
+
+    return filteredImg;
+}
+
+// Current monotonic time in seconds
+static double secondsNow(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
 
 int main() {
     const char* inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
-    const char* outputFile = "images/lizard_filtered_min_3.bmp";
 
-    // Read the input BMP image
+    // Read the input BMP image once for every kernel size
     BMP8Image *image = BMP8read(inputFile);
     if (!image) {
         return 1;
     }
 
-    // Apply minimum filter with a 3x3 kernel
-    BMP8Image *filtered = BMP8FilterMinimum(image, 3);
-    if (!filtered) {
+    // Separate runs, for comparison
+    const int kernelSizes[] = {3, 5, 10, 20};
+    const int count = sizeof(kernelSizes) / sizeof(kernelSizes[0]);
+    double start = secondsNow();
+    for (int k = 0; k < count; k++) {
+        BMP8Free(BMP8FilterMinimum(image, kernelSizes[k]));
+    }
+    double separate = secondsNow() - start;
+
+    // Sweep sharing the minimum pyramid
+    BMP8Image *filtered[sizeof(kernelSizes) / sizeof(kernelSizes[0])];
+    start = secondsNow();
+    if (!BMP8FilterMinimumSweep(image, kernelSizes, count, filtered)) {
         BMP8Free(image);
         return 1;
     }
-
-    // Save the filtered image to file
-    BMP8save(outputFile, filtered);
+    double sweep = secondsNow() - start;
+    printf("Kernels 3, 5, 10, 20: %.1f ms as separate runs, %.1f ms as a sweep\n", separate * 1e3, sweep * 1e3);
+
+    // Save the filtered images to file
+    for (int k = 0; k < count; k++) {
+        char outputFile[64];
+        sprintf(outputFile, "images/lizard_filtered_min_%d.bmp", kernelSizes[k]);
+        BMP8save(outputFile, filtered[k]);
+        BMP8Free(filtered[k]);
+    }
 
     // Free allocated memory
     BMP8Free(image);
-    BMP8Free(filtered);
 
     return 0;
-}
\ No newline at end of file
+}
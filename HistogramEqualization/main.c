@@ -70,6 +70,76 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
+        return NULL;
+    }
+
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
+
+    // Copy color table if grayscale (8-bit)
+    if (img->bitDepth <= 8) {
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    }
+
+    // Compute padded row size and total image size
+    int rowSize = (img->width + 3) & ~3;
+    newImg->imgSize = rowSize * img->height;
+
+    // Allocate memory for pixel data
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(newImg);
+        return NULL;
+    }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
 
 // Function to compute histogram (normalized) of an 8-bit BMP image
 // Optionally saves histogram values to a text file
@@ -124,39 +194,21 @@ float* BMP8Histogram(BMP8Image* img, bool saveFile, const char* filename){
 }
 
 
-// Function to perform histogram equalization on 8-bit BMP image
-BMP8Image* BMP8HistogramEqualization(BMP8Image* img){
-    BMP8Image* equalizedImg = malloc(sizeof(BMP8Image));
-    if(!equalizedImg){
-        fprintf(stderr, "Memory allocation failed!\n");
-        return NULL;
-    }
-
-    // Copy metadata
-    memcpy(equalizedImg->header, img->header, BMP_HEADER_SIZE);
-    equalizedImg->width = img->width;
-    equalizedImg->height = img->height;
-    equalizedImg->bitDepth = img->bitDepth;
-
-    // Copy color table if 8-bit
-    if (img->bitDepth <= 8) {
-        memcpy(equalizedImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+// Histogram equalization writing into a caller-supplied image
+// dst may alias img (the mapping is built before any pixel is written)
+bool BMP8HistogramEqualizationInto(BMP8Image* img, BMP8Image* dst){
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
     }
 
     // Compute image size
     int rowSize = (img->width + 3) & ~3;
-    equalizedImg->imgSize = rowSize * img->height;
-
-    // Allocate memory for new pixel data
-    equalizedImg->data = malloc(equalizedImg->imgSize);
-    if (!equalizedImg->data) {
-        fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(equalizedImg);
-        return NULL;
-    }
 
     // Compute histogram
     float* hist = BMP8Histogram(img, false, NULL);
+    if(!hist){
+        return false;
+    }
 
     // Compute cumulative distribution function (CDF) and mapping
     int histeq[256];
@@ -175,11 +227,24 @@ BMP8Image* BMP8HistogramEqualization(BMP8Image* img){
     for(int y = 0; y < img->height; y++){
         for(int x = 0; x < img->width; x++){
             int idx = y * rowSize + x;
-            equalizedImg->data[idx] = histeq[img->data[idx]];
+            dst->data[idx] = histeq[img->data[idx]];
         }
     }
 
-    return equalizedImg;
+    return true;
+}
+
+// Function to perform histogram equalization on 8-bit BMP image
+BMP8Image* BMP8HistogramEqualization(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8HistogramEqualizationInto(img, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
 
@@ -203,14 +268,6 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
-        free(img);
-    }
-}
-
 
 int main(){
     const char *inputFile = "../Test_Images/lena512.bmp";
@@ -0,0 +1,125 @@
+#!/bin/sh
+# Regenerate the outputs of every module and compare them with the committed
+# images/ for every code path: scalar (__SSE2__ undefined), default (SSE2),
+# -mssse3, -mavx2 and threaded (-fopenmp).
+#
+# Usage: ImageCompare/run_golden.sh [module ...]
+#
+# Each module is built from all of its *.c files once per flag set, its demo
+# runs in a scratch copy (so the committed images are never touched), and every
+# image it writes that has a committed counterpart must be byte-identical to it
+# or pass ImageCompare within the declared tolerance.
+# Committed images the demo no longer writes are not checked. Exit status is 0
+# when every comparison passes and every build and run succeeds.
+
+repo=$(cd "$(dirname "$0")/.." && pwd)
+scratch=$(mktemp -d /tmp/golden.XXXXXX)
+trap 'rm -rf "$scratch"' EXIT
+
+# Flag sets: name and compiler flags
+# The scalar set undefines __SSE2__ to select the scalar fallbacks; -mno-sse2
+# would also move float arithmetic to the x87 unit, whose extended precision
+# changes the results of plain float code that has no vector path at all
+flagSets="scalar:-U__SSE2__
+default:
+ssse3:-mssse3
+avx2:-mavx2
+openmp:-fopenmp"
+
+# Modules whose outputs are random by design (seeded from the clock)
+skipModules="NoiseGaussian NoiseSaltPepper"
+
+# Declared tolerances (largest channel difference) of outputs that are not
+# bit-exact across flag sets; everything else must match exactly
+tolerance() {
+    case "$1" in
+        # Written from the float FFT path: FMA contraction or another summation
+        # order may round differently, staying within 1 of the direct sums
+        Convolution/lizard_blurred31x31.bmp) echo 1 ;;
+        *) echo 0 ;;
+    esac
+}
+
+gcc -O2 "$repo/ImageCompare/main.c" -o "$scratch/ImageCompare" -lm || exit 2
+ln -s "$repo/Test_Images" "$scratch/Test_Images"
+
+# Instruction sets the host cannot run are skipped
+supported() {
+    case "$1" in
+        ssse3) grep -qw ssse3 /proc/cpuinfo 2>/dev/null ;;
+        avx2) grep -qw avx2 /proc/cpuinfo 2>/dev/null ;;
+        *) true ;;
+    esac
+}
+
+if [ $# -gt 0 ]; then
+    modules="$*"
+else
+    modules=$(cd "$repo" && for d in */; do [ -d "$d/images" ] && echo "${d%/}"; done)
+fi
+
+failures=0
+checked=0
+for module in $modules; do
+    case " $skipModules " in *" $module "*) continue ;; esac
+    # Every flag set runs in one subshell whose exit status reports failures
+    echo "$flagSets" | {
+        moduleStatus=0
+        while IFS=: read -r name flags; do
+            if ! supported "$name"; then
+                echo "SKIP $module [$name]: not supported by this CPU"
+                continue
+            fi
+            work="$scratch/$name/$module"
+            mkdir -p "$scratch/$name"
+            [ -e "$scratch/$name/Test_Images" ] || ln -s "$repo/Test_Images" "$scratch/$name/Test_Images"
+            rm -rf "$work"
+            cp -r "$repo/$module" "$work"
+            rm -f "$work/images/"*
+
+            # shellcheck disable=SC2086
+            if ! gcc -O2 $flags "$work"/*.c -o "$work/demo" -lm -pthread 2>"$work/build.log"; then
+                echo "FAIL $module [$name]: build failed"
+                sed 's/^/    /' "$work/build.log"
+                moduleStatus=1
+                continue
+            fi
+            if ! (cd "$work" && ./demo >"$work/run.log" 2>&1); then
+                echo "FAIL $module [$name]: demo failed"
+                sed 's/^/    /' "$work/run.log"
+                moduleStatus=1
+                continue
+            fi
+
+            status=0
+            for candidate in "$work/images/"*.bmp; do
+                [ -e "$candidate" ] || continue
+                file=$(basename "$candidate")
+                [ -e "$repo/$module/images/$file" ] || continue
+                # Identical files pass without decoding (also covers 1-bit images)
+                cmp -s "$repo/$module/images/$file" "$candidate" && continue
+                if ! "$scratch/ImageCompare" -q -t "$(tolerance "$module/$file")" \
+                        "$repo/$module/images/$file" "$candidate" >"$work/compare.log" 2>&1; then
+                    [ $status -eq 0 ] && echo "FAIL $module [$name]:"
+                    grep '^FAIL /' "$work/compare.log" | sed "s|$scratch/$name/|    |"
+                    status=1
+                fi
+            done
+            if [ $status -eq 0 ]; then
+                echo "PASS $module [$name]"
+            else
+                moduleStatus=1
+            fi
+        done
+        exit $moduleStatus
+    }
+    [ $? -eq 0 ] || failures=$((failures + 1))
+    checked=$((checked + 1))
+done
+
+if [ $failures -ne 0 ]; then
+    echo "FAIL: $failures of $checked module(s)"
+    exit 1
+fi
+echo "PASS: $checked module(s)"
+exit 0
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 
 // Define BMP header size
@@ -73,75 +74,78 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-BMP8Image* BMP8Rotate(BMP8Image* img, rotation r) {
-    if (!img) {
-        // Check if input image is valid
-        fprintf(stderr, "Image does not exists.\n");
-        return NULL; 
-    }
-
-    // Allocate memory for the rotated image structure
-    BMP8Image* rotatedImg = malloc(sizeof(BMP8Image));
-    if (!rotatedImg) {
-        fprintf(stderr, "Memory allocation failed!\n");
-        return NULL;
-    }
-
-    // Copy bit depth and color table (if 8-bit)
-    rotatedImg->bitDepth = img->bitDepth;
-    if (img->bitDepth <= 8) {
-        memcpy(rotatedImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+// Function to free memory used by BMP8Image structure
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        // Free pixel data
+        free(img->data);
+        // Free structure itself
+        free(img);
     }
+}
 
-    int newWidth, newHeight;
-
+// Compute the size of an image after rotation
+static bool rotatedSize(BMP8Image* img, rotation r, int* newWidth, int* newHeight) {
     // Determine new image dimensions based on rotation type
     switch (r) {
         case CLOCKWISE:
         case COUNTER_CLOCKWISE:
             // Width becomes original height
-            newWidth = img->height;
+            *newWidth = img->height;
             // Height becomes original width
-            newHeight = img->width;
-            break;
+            *newHeight = img->width;
+            return true;
         case ROTATE_180:
-            // Width stays the same
-            newWidth = img->width;
-            // Height stays the same
-            newHeight = img->height;
-            break;
+            // Width and height stay the same
+            *newWidth = img->width;
+            *newHeight = img->height;
+            return true;
         default:
-            free(rotatedImg);
-            return NULL;
+            fprintf(stderr, "Unknown rotation type %d.\n", r);
+            return false;
     }
+}
 
-    // Copy header and update width and height fields
-    memcpy(rotatedImg->header, img->header, BMP_HEADER_SIZE);
-    *(int*)&rotatedImg->header[18] = newWidth;
-    *(int*)&rotatedImg->header[22] = newHeight;
+// Rotate an image, writing into a caller-supplied image of the rotated size
+// dst must not alias img (pixels move to other rows and columns)
+bool BMP8RotateInto(BMP8Image* img, rotation r, BMP8Image* dst) {
+    if (!img || !dst || !dst->data) {
+        fprintf(stderr, "Image does not exists.\n");
+        return false;
+    }
 
-    rotatedImg->width = newWidth;
-    rotatedImg->height = newHeight;
+    int newWidth, newHeight;
+    if (!rotatedSize(img, r, &newWidth, &newHeight)) {
+        return false;
+    }
+    if (dst->width != newWidth || dst->height != newHeight) {
+        fprintf(stderr, "Destination size does not match the rotated image.\n");
+        return false;
+    }
+    if (dst->data == img->data) {
+        fprintf(stderr, "In-place rotation is not supported.\n");
+        return false;
+    }
+
+    // Copy header, bit depth and color table, then update width and height fields
+    memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+    *(int*)&dst->header[18] = newWidth;
+    *(int*)&dst->header[22] = newHeight;
+    dst->bitDepth = img->bitDepth;
+    if (img->bitDepth <= 8) {
+        memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    }
 
     // Calculate padded row sizes
     // Input row aligned to 4 bytes
     int rowSizeIn = (img->width + 3) & ~3;
     // Output row aligned to 4 bytes
     int rowSizeOut = (newWidth + 3) & ~3;
-    rotatedImg->imgSize = rowSizeOut * newHeight;
-
-    // Allocate memory for pixel data of rotated image
-    rotatedImg->data = calloc(rotatedImg->imgSize, 1);
-    if (!rotatedImg->data) {
-        fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(rotatedImg);
-        return NULL;
-    }
 
     // Pointer to original pixels
     unsigned char* inData = img->data;
     // Pointer to rotated pixels
-    unsigned char* outData = rotatedImg->data;
+    unsigned char* outData = dst->data;
 
     // Loop through all pixels of the original image
     for (int y = 0; y < img->height; y++) {
@@ -166,6 +170,47 @@ BMP8Image* BMP8Rotate(BMP8Image* img, rotation r) {
         }
     }
 
+    return true;
+}
+
+// Rotate an image and return a newly allocated result
+BMP8Image* BMP8Rotate(BMP8Image* img, rotation r) {
+    if (!img) {
+        // Check if input image is valid
+        fprintf(stderr, "Image does not exists.\n");
+        return NULL;
+    }
+
+    int newWidth, newHeight;
+    if (!rotatedSize(img, r, &newWidth, &newHeight)) {
+        return NULL;
+    }
+
+    // Allocate memory for the rotated image structure
+    BMP8Image* rotatedImg = malloc(sizeof(BMP8Image));
+    if (!rotatedImg) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    rotatedImg->width = newWidth;
+    rotatedImg->height = newHeight;
+
+    // Output row aligned to 4 bytes
+    int rowSizeOut = (newWidth + 3) & ~3;
+    rotatedImg->imgSize = rowSizeOut * newHeight;
+
+    // Allocate memory for pixel data of rotated image
+    rotatedImg->data = calloc(rotatedImg->imgSize, 1);
+    if (!rotatedImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(rotatedImg);
+        return NULL;
+    }
+
+    if (!BMP8RotateInto(img, r, rotatedImg)) {
+        BMP8Free(rotatedImg);
+        return NULL;
+    }
     return rotatedImg; // Return pointer to rotated image
 }
 
@@ -193,16 +238,6 @@ void BMP8save(const char* filename, BMP8Image* img) {
     fclose(fOutput);
 }
 
-// Function to free memory used by BMP8Image structure
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        // Free pixel data
-        free(img->data);
-        // Free structure itself
-        free(img);
-    }
-}
-
 int main() {
     // Input BMP file path (8-bit grayscale)
     const char *inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
@@ -2,7 +2,14 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <math.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "mask.h"
+#include "kernels.h"
+#include "taskgraph.h"
 
 // Define BMP header size
 #define BMP_HEADER_SIZE 54
@@ -17,6 +24,11 @@
 #define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
 #define MAX(a, b) ((a) > (b) ? (a) : (b))   // returns the larger of (a) and (b)
 
+// Upper bound on the per-thread accumulators of the Hough transform
+#define HOUGH_MAX_WORKERS 16
+// A peak must be the largest vote count within this many bins in rho and theta
+#define HOUGH_PEAK_RADIUS 4
+
 // Structure to hold 8-bit BMP image data
 typedef struct {
     unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
@@ -28,6 +40,16 @@ typedef struct {
     int imgSize;                                    // Total size of pixel data in bytes
 } BMP8Image;
 
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
 
 // Function to read an 8-bit BMP image from a file
 BMP8Image* BMP8read(const char* filename) {
@@ -79,50 +101,216 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-// Function to apply convolution with a given mask to an 8-bit BMP image
-BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
-    if(!img || !m){
-        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
     // Allocate memory for new image
-    BMP8Image* convImg = malloc(sizeof(BMP8Image));
-    if(!convImg){
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
     // Copy BMP header and metadata
-    memcpy(convImg->header, img->header, BMP_HEADER_SIZE);
-    convImg->width = img->width;
-    convImg->height = img->height;
-    convImg->bitDepth = img->bitDepth;
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
     // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(convImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
     // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    convImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
-    // Allocate memory for pixel data of the result
-    convImg->data = malloc(convImg->imgSize);
-    if (!convImg->data) {
+    // Allocate memory for pixel data
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(convImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Copy the coefficients of m into taps when all of them are whole numbers
+// Returns the sum of their magnitudes, or -1 when the mask needs the float path
+// (fractional coefficients, or sums too large to stay exact in float)
+static int maskIntegerTaps(mask* m, int* taps){
+    int absSum = 0;
+    for(unsigned int i = 0; i < m->rows * m->cols; i++){
+        float c = m->data[i];
+        if(c > 65535.0f || c < -65535.0f || c != (float)(int)c){
+            return -1;
+        }
+        taps[i] = (int)c;
+        absSum += abs(taps[i]);
+        // Float accumulation is exact below 2^24
+        if((long)absSum * MAX_BRIGHTNESS >= (1L << 24)){
+            return -1;
+        }
+    }
+    return absSum;
+}
+
+// Integer convolution of one pixel; taps outside the image are skipped (zero padding)
+static unsigned char convolveIntegerPixel(BMP8Image* img, int rowSize, const int* taps, int rows, int cols, int x, int y){
+    int val = 0;
+    for(int i = 0; i < rows; i++){
+        int idy = y + (i - rows / 2);
+        if(idy < 0 || idy >= img->height){
+            continue;
+        }
+        for(int j = 0; j < cols; j++){
+            int idx = x + (j - cols / 2);
+            if(idx >= 0 && idx < img->width){
+                val += taps[i * cols + j] * img->data[idy * rowSize + idx];
+            }
+        }
+    }
+    return (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+}
+
+// Convolution with integer taps, pixel for pixel equal to the float path
+// Where the whole mask is inside the image, sums use 16-bit lanes with a saturating
+// pack when they fit (absSum * 255 <= 32767) and 32-bit scalar accumulation otherwise
+// row, when given, is an unrolled kernel for this mask size or these coefficients
+static void BMP8ConvolutionInteger(BMP8Image* img, const int* taps, int rows, int cols, int absSum, kernelRow row, BMP8Image* dst){
+    int rowSize = (img->width + 3) & ~3;
+    int iCenter = rows / 2;
+    int jCenter = cols / 2;
+
+    // Rows and columns where every tap lies inside the image
+    int yBegin = iCenter, yEnd = img->height - (rows - 1 - iCenter);
+    int xBegin = jCenter, xEnd = img->width - (cols - 1 - jCenter);
+
+    for(int y = 0; y < img->height; y++){
+        unsigned char* out = dst->data + (size_t)y * rowSize;
+        if(y < yBegin || y >= yEnd || xBegin >= xEnd){
+            for(int x = 0; x < img->width; x++){
+                out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+            }
+            continue;
+        }
+
+        for(int x = 0; x < xBegin; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+        int x = xBegin;
+        if(row){
+            row(img->data + (size_t)(y - iCenter) * rowSize, rowSize, x, xEnd, out, taps, absSum * MAX_BRIGHTNESS <= 32767);
+            x = xEnd;
+        }
+#ifdef __SSE2__
+        // Vector path: 8 pixels per iteration, twice the lanes of a float kernel
+        if(absSum * MAX_BRIGHTNESS <= 32767){
+            const __m128i zero = _mm_setzero_si128();
+            for(; x + 8 <= xEnd; x += 8){
+                __m128i acc = zero;
+                for(int i = 0; i < rows; i++){
+                    const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                    for(int j = 0; j < cols; j++){
+                        int c = taps[i * cols + j];
+                        if(c != 0){
+                            __m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + j)), zero);
+                            acc = _mm_add_epi16(acc, _mm_mullo_epi16(px, _mm_set1_epi16((short)c)));
+                        }
+                    }
+                }
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(acc, acc));
+            }
+        }
+#endif
+        // Scalar path (and tail): no bounds checks inside the image
+        for(; x < xEnd; x++){
+            int val = 0;
+            for(int i = 0; i < rows; i++){
+                const unsigned char* src = img->data + (size_t)(y + i - iCenter) * rowSize + x - jCenter;
+                for(int j = 0; j < cols; j++){
+                    val += taps[i * cols + j] * src[j];
+                }
+            }
+            out[x] = (unsigned char)MAX(MIN(val, MAX_BRIGHTNESS), MIN_BRIGHTNESS);
+        }
+        for(; x < img->width; x++){
+            out[x] = convolveIntegerPixel(img, rowSize, taps, rows, cols, x, y);
+        }
+    }
+}
+
+// Function to apply convolution with a given mask, writing into a caller-supplied image
+// dst must have the size of img and must not alias it (neighbors are read after writes)
+bool BMP8ConvolutionInto(BMP8Image* img, mask* m, BMP8Image* dst){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    // Integral masks (Sobel, Prewitt, Kirsch, Laplacian, ...) take the exact integer path
+    int* taps = malloc(m->rows * m->cols * sizeof(int));
+    int absSum = taps ? maskIntegerTaps(m, taps) : -1;
+    if(absSum >= 0){
+        BMP8ConvolutionInteger(img, taps, m->rows, m->cols, absSum, kernelRowFor(m->rows, m->cols), dst);
+        free(taps);
+        return true;
+    }
+    free(taps);
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
 
     // Compute center of the mask (for correct alignment during convolution)
     int iCenter = m->rows / 2;
     int jCenter = m->cols / 2;
 
     // Iterate through every pixel in the image
-    for(int y = 0; y < convImg->height; y++){
-        for(int x = 0; x < convImg->width; x++){
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
             float val = 0.0f;
 
             // Apply convolution mask
@@ -134,7 +322,7 @@ BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
                     // Check if neighbor is inside image bounds
                     if(idx >= 0 && idx < img->width && idy >= 0 && idy < img->height){
                         float ms = m->data[i * m->cols + j];       // mask coefficient
-                        float im = img->data[idy * img->width + idx]; // image pixel value
+                        float im = img->data[idy * rowSize + idx]; // image pixel value
                         val += ms * im;
                     }
                 }
@@ -145,11 +333,52 @@ BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
             val = MAX(val, MIN_BRIGHTNESS);
 
             // Store result pixel
-            convImg->data[y * convImg->width + x] = (unsigned char)val;
+            dst->data[y * rowSize + x] = (unsigned char)val;
         }
     }
 
-    return convImg;
+    return true;
+}
+
+// Apply an integer mask fixed at compile time (see CONSTANT_KERNEL), writing into a
+// caller-supplied image; same result as BMP8ConvolutionInto with the equivalent mask
+bool BMP8ConvolutionKernelInto(BMP8Image* img, const constantKernel* k, BMP8Image* dst){
+    if(!img || !k){
+        fprintf(stderr, "Convolution Error: Either there is no image or kernel.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Convolution Error: In-place convolution is not supported.\n");
+        return false;
+    }
+
+    int absSum = 0;
+    for(int i = 0; i < k->rows * k->cols; i++){
+        absSum += abs(k->taps[i]);
+    }
+    BMP8ConvolutionInteger(img, k->taps, k->rows, k->cols, absSum, k->row, dst);
+    return true;
+}
+
+// Function to apply convolution with a given mask to an 8-bit BMP image
+BMP8Image* BMP8Convolution(BMP8Image* img, mask* m){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return NULL;
+    }
+
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8ConvolutionInto(img, m, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
 // Function to save an 8-bit BMP image to a file
@@ -172,14 +401,398 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
+
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(file);
+        return NULL;
+    }
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
         free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
     }
 }
 
+// Function to apply convolution with a given mask to a 24-bit BMP image
+// All three channels are accumulated in a single pass over the interleaved data
+BMP24Image* BMP24Convolution(BMP24Image* img, mask* m){
+    if(!img || !m){
+        fprintf(stderr, "Convolution Error: Either there is no image or mask.\n");
+        return NULL;
+    }
+
+    // Allocate memory for the new image
+    BMP24Image* convImg = malloc(sizeof(BMP24Image));
+    if(!convImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy header and metadata
+    memcpy(convImg->header, img->header, BMP_HEADER_SIZE);
+    convImg->width = img->width;
+    convImg->height = img->height;
+    convImg->bitDepth = img->bitDepth;
+    convImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data
+    convImg->data = calloc(img->rowSize * img->height, 1);
+    if (!convImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(convImg);
+        return NULL;
+    }
+
+    // Compute center of the mask (for correct alignment during convolution)
+    int iCenter = m->rows / 2;
+    int jCenter = m->cols / 2;
+
+    // Iterate through every pixel in the image
+    for(int y = 0; y < convImg->height; y++){
+        for(int x = 0; x < convImg->width; x++){
+            // Accumulators for blue, green and red
+            float val[3] = {0.0f, 0.0f, 0.0f};
+
+            // Apply convolution mask
+            for(int i = 0; i < (int)m->rows; i++){
+                for(int j = 0; j < (int)m->cols; j++){
+                    int idx = x + (j - jCenter);  // pixel x offset
+                    int idy = y + (i - iCenter);  // pixel y offset
+
+                    // Check if neighbor is inside image bounds
+                    if(idx >= 0 && idx < img->width && idy >= 0 && idy < img->height){
+                        float ms = m->data[i * m->cols + j];                        // mask coefficient
+                        const unsigned char* px = img->data + idy * img->rowSize + idx * 3; // BGR pixel
+                        val[0] += ms * px[0];
+                        val[1] += ms * px[1];
+                        val[2] += ms * px[2];
+                    }
+                }
+            }
+
+            // Clamp every channel to [0..255] and store
+            unsigned char* out = convImg->data + y * convImg->rowSize + x * 3;
+            for(int c = 0; c < 3; c++){
+                val[c] = MIN(val[c], MAX_BRIGHTNESS);
+                val[c] = MAX(val[c], MIN_BRIGHTNESS);
+                out[c] = (unsigned char)val[c];
+            }
+        }
+    }
+
+    return convImg;
+}
+
+// A line found by the Hough transform: (x - width/2) cos(theta) + (y - height/2) sin(theta) = rho
+// x and y are column and row of the pixel data (row 0 is the bottom row of the picture)
+typedef struct {
+    float rho;      // signed distance of the line from the image center in pixels
+    float theta;    // angle of the line normal in radians, in [0, pi)
+    int votes;      // number of edge pixels on the line
+} houghLine;
+
+// Accumulator space and the edge points voting into it
+typedef struct {
+    int thetaSteps;         // number of theta bins over [0, pi)
+    int rhoCount;           // number of rho bins (1 pixel each)
+    int rhoMax;             // bin rhoMax holds rho = 0
+    float *cosTable;        // cos of every theta bin
+    float *sinTable;        // sin of every theta bin
+    short *points;          // x, y pairs relative to the image center
+    int pointCount;         // number of edge points
+    int **accumulators;     // one accumulator per worker; the first receives the merged votes
+    int workers;            // number of accumulators
+} houghSpace;
+
+// Task argument: a worker's share of the points, or a band of theta rows to merge
+typedef struct {
+    houghSpace *space;
+    int worker;
+    int begin;
+    int end;
+} houghTask;
+
+// Task: vote for every line through points [begin, end) into the worker's own accumulator
+static void houghVote(void* arg) {
+    houghTask *t = arg;
+    houghSpace *h = t->space;
+    int *acc = h->accumulators[t->worker];
+    float offset = h->rhoMax + 0.5f;
+    for (int i = t->begin; i < t->end; i++) {
+        float x = h->points[2 * i], y = h->points[2 * i + 1];
+        int *row = acc;
+        for (int k = 0; k < h->thetaSteps; k++, row += h->rhoCount) {
+            // |rho| <= rhoMax, so the rounded index is never negative
+            row[(int)(x * h->cosTable[k] + y * h->sinTable[k] + offset)]++;
+        }
+    }
+}
+
+// Task: add theta rows [begin, end) of every other accumulator into the first one
+static void houghMerge(void* arg) {
+    houghTask *t = arg;
+    houghSpace *h = t->space;
+    size_t from = (size_t)t->begin * h->rhoCount, to = (size_t)t->end * h->rhoCount;
+    for (int w = 1; w < h->workers; w++) {
+        const int *src = h->accumulators[w];
+        int *dst = h->accumulators[0];
+        for (size_t i = from; i < to; i++) {
+            dst[i] += src[i];
+        }
+    }
+}
+
+// Whether bin (k, r) holding v beats every bin within HOUGH_PEAK_RADIUS
+// Theta wraps around: bin -1 is the last bin with rho negated
+// Equal counts are won by the lower bin index, so a plateau yields one peak
+static bool houghIsPeak(const houghSpace* h, const int* acc, int k, int r, int v) {
+    for (int dk = -HOUGH_PEAK_RADIUS; dk <= HOUGH_PEAK_RADIUS; dk++) {
+        for (int dr = -HOUGH_PEAK_RADIUS; dr <= HOUGH_PEAK_RADIUS; dr++) {
+            int k2 = k + dk, r2 = r + dr;
+            if (k2 < 0 || k2 >= h->thetaSteps) {
+                k2 = k2 < 0 ? k2 + h->thetaSteps : k2 - h->thetaSteps;
+                r2 = h->rhoCount - 1 - r2;
+            }
+            if (r2 < 0 || r2 >= h->rhoCount || (k2 == k && r2 == r)) {
+                continue;
+            }
+            int u = acc[k2 * h->rhoCount + r2];
+            if (u > v || (u == v && k2 * h->rhoCount + r2 < k * h->rhoCount + r)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Order lines by decreasing votes
+static int houghCompare(const void* a, const void* b) {
+    const houghLine *la = a, *lb = b;
+    return (lb->votes > la->votes) - (lb->votes < la->votes);
+}
+
+// Hough transform of the pixels of edges at or above threshold
+// Finds up to maxLines lines with at least minVotes votes, strongest first
+// Returns the number of lines stored in lines, or -1 on error
+int BMP8HoughLines(BMP8Image* edges, unsigned char threshold, int thetaSteps, int minVotes, houghLine* lines, int maxLines) {
+    if (!edges || !lines || thetaSteps <= 0 || maxLines <= 0) {
+        fprintf(stderr, "Hough Error: Either there is no image, no output or an invalid parameter.\n");
+        return -1;
+    }
+
+    houghSpace h = {0};
+    h.thetaSteps = thetaSteps;
+    h.rhoMax = (int)ceil(hypot(edges->width, edges->height) / 2.0);
+    h.rhoCount = 2 * h.rhoMax + 1;
+    h.workers = MIN((int)sysconf(_SC_NPROCESSORS_ONLN), HOUGH_MAX_WORKERS);
+    h.workers = MAX(h.workers, 1);
+    h.cosTable = malloc(thetaSteps * sizeof(float));
+    h.sinTable = malloc(thetaSteps * sizeof(float));
+    h.points = malloc((size_t)edges->width * edges->height * 2 * sizeof(short));
+    h.accumulators = calloc(h.workers, sizeof(int*));
+    bool ok = h.cosTable && h.sinTable && h.points && h.accumulators;
+    for (int w = 0; ok && w < h.workers; w++) {
+        h.accumulators[w] = calloc((size_t)thetaSteps * h.rhoCount, sizeof(int));
+        ok = h.accumulators[w] != NULL;
+    }
+
+    int found = -1;
+    taskGraph *graph = ok ? taskGraphCreate() : NULL;
+    houghTask tasks[2 * HOUGH_MAX_WORKERS];
+    if (graph) {
+        // Precomputed angle tables
+        for (int k = 0; k < thetaSteps; k++) {
+            double theta = M_PI * k / thetaSteps;
+            h.cosTable[k] = (float)cos(theta);
+            h.sinTable[k] = (float)sin(theta);
+        }
+
+        // Edge points relative to the image center
+        int rowSize = (edges->width + 3) & ~3;
+        for (int y = 0; y < edges->height; y++) {
+            for (int x = 0; x < edges->width; x++) {
+                if (edges->data[y * rowSize + x] >= threshold) {
+                    h.points[2 * h.pointCount] = (short)(x - edges->width / 2);
+                    h.points[2 * h.pointCount + 1] = (short)(y - edges->height / 2);
+                    h.pointCount++;
+                }
+            }
+        }
+
+        // Votes into private accumulators, then every merge band waits for all of them
+        int votes[HOUGH_MAX_WORKERS];
+        for (int w = 0; ok && w < h.workers; w++) {
+            tasks[w] = (houghTask){&h, w, (int)((long)h.pointCount * w / h.workers), (int)((long)h.pointCount * (w + 1) / h.workers)};
+            votes[w] = taskGraphAdd(graph, houghVote, &tasks[w]);
+            ok = votes[w] >= 0;
+        }
+        for (int w = 0; ok && w < h.workers; w++) {
+            houghTask *t = &tasks[h.workers + w];
+            *t = (houghTask){&h, 0, thetaSteps * w / h.workers, thetaSteps * (w + 1) / h.workers};
+            int merge = taskGraphAdd(graph, houghMerge, t);
+            ok = merge >= 0;
+            for (int v = 0; ok && v < h.workers; v++) {
+                ok = taskGraphDepend(graph, merge, votes[v]);
+            }
+        }
+
+        if (ok && taskGraphRun(graph, h.workers)) {
+            // Peak extraction: only bins over minVotes pay for the neighborhood test
+            const int *acc = h.accumulators[0];
+            int capacity = 0;
+            houghLine *peaks = NULL;
+            found = 0;
+            for (int k = 0; k < thetaSteps && found >= 0; k++) {
+                for (int r = 0; r < h.rhoCount; r++) {
+                    int v = acc[k * h.rhoCount + r];
+                    if (v < minVotes || v == 0 || !houghIsPeak(&h, acc, k, r, v)) {
+                        continue;
+                    }
+                    if (found == capacity) {
+                        capacity = capacity ? 2 * capacity : 64;
+                        houghLine *grown = realloc(peaks, capacity * sizeof(houghLine));
+                        if (!grown) {
+                            found = -1;
+                            break;
+                        }
+                        peaks = grown;
+                    }
+                    peaks[found++] = (houghLine){(float)(r - h.rhoMax), (float)(M_PI * k / thetaSteps), v};
+                }
+            }
+            if (found > 0) {
+                qsort(peaks, found, sizeof(houghLine), houghCompare);
+                found = MIN(found, maxLines);
+                memcpy(lines, peaks, found * sizeof(houghLine));
+            }
+            free(peaks);
+        }
+        taskGraphDestroy(graph);
+    }
+    if (found < 0) {
+        fprintf(stderr, "Hough Error: Memory allocation or worker start failed.\n");
+    }
+
+    for (int w = 0; h.accumulators && w < h.workers; w++) {
+        free(h.accumulators[w]);
+    }
+    free(h.accumulators);
+    free(h.cosTable);
+    free(h.sinTable);
+    free(h.points);
+    return found;
+}
+
+// Draw a line found by BMP8HoughLines into img with the given brightness
+void BMP8DrawHoughLine(BMP8Image* img, const houghLine* line, unsigned char value) {
+    int rowSize = (img->width + 3) & ~3;
+    float c = cosf(line->theta), s = sinf(line->theta);
+    float cx = img->width / 2, cy = img->height / 2;
+    if (fabsf(s) > fabsf(c)) {
+        // Closer to horizontal: one pixel per column
+        for (int x = 0; x < img->width; x++) {
+            int y = (int)lrintf((line->rho - (x - cx) * c) / s + cy);
+            if (y >= 0 && y < img->height) {
+                img->data[y * rowSize + x] = value;
+            }
+        }
+    } else {
+        // Closer to vertical: one pixel per row
+        for (int y = 0; y < img->height; y++) {
+            int x = (int)lrintf((line->rho - (y - cy) * s) / c + cx);
+            if (x >= 0 && x < img->width) {
+                img->data[y * rowSize + x] = value;
+            }
+        }
+    }
+}
+
+// One branch of the demo graph: a directional mask and the file its result goes to
+typedef struct {
+    BMP8Image *source;      // Shared read-only input
+    mask *m;                // Directional line mask
+    const char *outputFile; // Where the result is saved
+    BMP8Image *result;      // Filled by the convolution task
+} lineBranch;
+
+// Task: convolve the shared source with the branch mask
+static void convolveBranch(void* arg) {
+    lineBranch *branch = arg;
+    branch->result = BMP8Convolution(branch->source, branch->m);
+}
+
+// Task: save and free the branch result as soon as it has been computed
+static void saveBranch(void* arg) {
+    lineBranch *branch = arg;
+    if (branch->result) {
+        BMP8save(branch->outputFile, branch->result);
+        BMP8Free(branch->result);
+        branch->result = NULL;
+    }
+}
 
 int main(){
     // Input and output file paths
@@ -274,30 +887,99 @@ int main(){
         }
     }
 
-    // Step 3: Apply convolution with each directional mask
-    BMP8Image* convolvedVer = BMP8Convolution(image, verticalMask);
-    BMP8Image* convolvedHor = BMP8Convolution(image, horizontalMask);
-    BMP8Image* convolvedLeftDiag = BMP8Convolution(image, leftDiagonalMask);
-    BMP8Image* convolvedRightDiag = BMP8Convolution(image, rightDiagonalMask);
+    // Step 3: Build a task graph with one convolution and one save per direction
+    // The four convolutions share the read-only source and run concurrently;
+    // each save starts as soon as its own convolution is done
+    lineBranch branches[] = {
+        {image, verticalMask, outputFileVer, NULL},
+        {image, horizontalMask, outputFileHor, NULL},
+        {image, leftDiagonalMask, outputFilelDiag, NULL},
+        {image, rightDiagonalMask, outputFilerDiag, NULL},
+    };
+    int branchCount = sizeof(branches) / sizeof(branches[0]);
+
+    bool ok = false;
+    taskGraph *graph = taskGraphCreate();
+    if (graph) {
+        ok = true;
+        for (int i = 0; ok && i < branchCount; i++) {
+            int compute = taskGraphAdd(graph, convolveBranch, &branches[i]);
+            int save = taskGraphAdd(graph, saveBranch, &branches[i]);
+            ok = compute >= 0 && save >= 0 && taskGraphDepend(graph, save, compute);
+        }
 
-    // Step 4: Save the convolved images
-    BMP8save(outputFileVer, convolvedVer);
-    BMP8save(outputFileHor, convolvedHor);
-    BMP8save(outputFilelDiag, convolvedLeftDiag);
-    BMP8save(outputFilerDiag, convolvedRightDiag);
+        // Step 4: Run the graph (convolutions and saves overlap) on one worker per CPU
+        if (ok) {
+            ok = taskGraphRun(graph, 0);
+        } else {
+            fprintf(stderr, "Error: could not build the task graph.\n");
+        }
+        taskGraphDestroy(graph);
+    }
 
-    // Step 5: Free all allocated memory
+    // Step 5: Find straight lines in houses.bmp in-process: the strongest of the four
+    // directional responses is the edge map of a Hough transform
+    BMP8Image *houses = BMP8read("../Test_Images/houses.bmp");
+    mask *directions[] = {verticalMask, horizontalMask, leftDiagonalMask, rightDiagonalMask};
+    BMP8Image *edges = houses ? BMP8CreateLike(houses) : NULL;
+    BMP8Image *response = houses ? BMP8CreateLike(houses) : NULL;
+    if (edges && response) {
+        memset(edges->data, 0, edges->imgSize);
+        for (int i = 0; i < 4; i++) {
+            if (BMP8ConvolutionInto(houses, directions[i], response)) {
+                for (int p = 0; p < edges->imgSize; p++) {
+                    edges->data[p] = MAX(edges->data[p], response->data[p]);
+                }
+            }
+        }
+
+        // The masks see zero padding outside the image, so the frame responds like a line
+        int rowSize = (edges->width + 3) & ~3;
+        for (int y = 0; y < edges->height; y++) {
+            for (int x = 0; x < edges->width; x++) {
+                if (x == 0 || y == 0 || x == edges->width - 1 || y == edges->height - 1) {
+                    edges->data[y * rowSize + x] = 0;
+                }
+            }
+        }
+
+        houghLine lines[20];
+        int found = BMP8HoughLines(edges, 160, 180, 60, lines, 20);
+        for (int i = 0; i < found; i++) {
+            printf("Line %2d: rho %7.1f  theta %5.1f deg  votes %d\n", i + 1, lines[i].rho,
+                   lines[i].theta * 180.0 / M_PI, lines[i].votes);
+            BMP8DrawHoughLine(houses, &lines[i], MAX_BRIGHTNESS);
+        }
+        if (found >= 0) {
+            BMP8save("images/houses_HoughLines.bmp", houses);
+        }
+    }
+    BMP8Free(houses);
+    BMP8Free(edges);
+    BMP8Free(response);
+
+    // Step 6: Apply the horizontal mask to every channel of a color image in one pass
+    BMP24Image *image24 = BMP24Read("../Test_Images/lena_color.bmp");
+    if (image24) {
+        BMP24Image *horizontal24 = BMP24Convolution(image24, horizontalMask);
+        if (horizontal24) {
+            BMP24Save("images/lena_color_HorLines.bmp", horizontal24);
+            BMP24Free(horizontal24);
+        }
+        BMP24Free(image24);
+    }
+
+    // Step 7: Free all allocated memory
     BMP8Free(image);
-    BMP8Free(convolvedVer);
-    BMP8Free(convolvedHor);
-    BMP8Free(convolvedLeftDiag);
-    BMP8Free(convolvedRightDiag);
 
     maskFree(verticalMask);
     maskFree(horizontalMask);
     maskFree(leftDiagonalMask);
     maskFree(rightDiagonalMask);
 
+    if (!ok) {
+        return 1;
+    }
     printf("Convolution completed! Saved results.\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,753 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// Define BMP header size
+#define BMP_HEADER_SIZE 54
+// Size of color table for 8-bit BMP
+#define BMP_COLOR_TABLE_SIZE 1024
+// Maximum value of a pixel
+#define MAX_BRIGHTNESS 255
+// Minimum value of a pixel
+#define MIN_BRIGHTNESS 0
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
+#define MAX(a, b) ((a) > (b) ? (a) : (b))   // returns the larger of (a) and (b)
+
+// Output rows computed together; intermediate images of opening and closing
+// only ever exist for one band (plus the margins the element needs)
+#define MORPH_BAND 64
+// Vertical runs up to this length are scanned directly, longer ones with van Herk/Gil-Werman
+#define MORPH_DIRECT_RUN 4
+// Horizontal runs up to this length use log2(length) doubling passes, longer ones van Herk/Gil-Werman
+#define MORPH_DOUBLING_RUN 64
+// Structure to hold 8-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
+    unsigned char colorTable[BMP_COLOR_TABLE_SIZE]; // Color table for 8-bit BMP (256 * 4 bytes)
+    unsigned char *data;                            // Pointer to pixel data
+    int width;                                      // Image width in pixels
+    int height;                                     // Image height in pixels
+    int bitDepth;                                   // Bits per pixel (8 for grayscale)
+    int imgSize;                                    // Total size of pixel data in bytes
+} BMP8Image;
+
+// Function to read an 8-bit BMP image from a file
+BMP8Image* BMP8read(const char* filename) {
+    // open file
+    FILE *fInput = fopen(filename, "rb");
+    if (!fInput) {
+        fprintf(stderr, "Unable to open file %s!\n", filename);
+        return NULL;
+    }
+
+    // allocate struct
+    BMP8Image *img = (BMP8Image*)malloc(sizeof(BMP8Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(fInput);
+        return NULL;
+    }
+
+    // Read header (54 bytes)
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, fInput);
+
+    // Extract metadata from header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Compute padded row size and image size
+    int rowSize = (img->width + 3) & ~3;
+    img->imgSize = rowSize * img->height;
+
+    // Read color table (only for 8-bit BMP)
+    if (img->bitDepth <= 8) {
+        fread(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fInput);
+    }
+
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->imgSize);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(fInput);
+        return NULL;
+    }
+
+    // Read pixel data
+    fread(img->data, sizeof(unsigned char), img->imgSize, fInput);
+
+    fclose(fInput);
+    return img;
+}
+
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
+        return NULL;
+    }
+
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
+
+    // Copy color table if grayscale (8-bit)
+    if (img->bitDepth <= 8) {
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    }
+
+    // Compute padded row size and total image size
+    int rowSize = (img->width + 3) & ~3;
+    newImg->imgSize = rowSize * img->height;
+
+    // Allocate memory for pixel data
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(newImg);
+        return NULL;
+    }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Function to save an 8-bit BMP image to a file
+void BMP8save(const char* filename, BMP8Image* img) {
+    FILE *fOutput = fopen(filename, "wb");
+    if (!fOutput) {
+        fprintf(stderr, "Unable to create file %s!\n", filename);
+        return;
+    }
+
+    fwrite(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, fOutput);
+
+    if (img->bitDepth <= 8) {
+        fwrite(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fOutput);
+    }
+
+    fwrite(img->data, sizeof(unsigned char), img->imgSize, fOutput);
+
+    fclose(fOutput);
+}
+
+
+// Decompositions the engine knows; every shape is also a plain set of offsets
+typedef enum {
+    SE_RECTANGLE,   // separable: one horizontal and one vertical run
+    SE_CROSS,       // union of the center row and the center column
+    SE_DISK,        // union of one horizontal chord per row
+    SE_OFFSETS      // any other set (e.g. slanted lines), one offset at a time
+} structuringShape;
+
+// Flat structuring element on a width x height grid with its origin at (cx, cy)
+typedef struct {
+    structuringShape shape;     // decomposition used when applying the element
+    int width;                  // bounding box width
+    int height;                 // bounding box height
+    int cx;                     // origin column inside the box
+    int cy;                     // origin row inside the box
+    unsigned char *data;        // width * height, nonzero where the element is set
+} structuringElement;
+
+// Morphological operations built from erosion and dilation
+typedef enum {
+    MORPH_ERODE,
+    MORPH_DILATE,
+    MORPH_OPEN,         // dilation of the erosion
+    MORPH_CLOSE,        // erosion of the dilation
+    MORPH_TOPHAT,       // image minus its opening (bright details)
+    MORPH_BLACKHAT      // closing minus the image (dark details)
+} morphOperation;
+
+// Allocate an empty element with its origin in the middle of the box
+static structuringElement* seCreate(structuringShape shape, int width, int height){
+    if(width < 1 || height < 1){
+        fprintf(stderr, "Morphology Error: Structuring element must be at least 1x1.\n");
+        return NULL;
+    }
+    structuringElement* se = malloc(sizeof(structuringElement));
+    if(!se){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    se->shape = shape;
+    se->width = width;
+    se->height = height;
+    se->cx = width / 2;
+    se->cy = height / 2;
+    se->data = calloc((size_t)width * height, 1);
+    if(!se->data){
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(se);
+        return NULL;
+    }
+    return se;
+}
+
+// Free a structuring element
+void seFree(structuringElement* se){
+    if(se){
+        free(se->data);
+        free(se);
+    }
+}
+
+// Filled width x height rectangle
+structuringElement* seCreateRectangle(int width, int height){
+    structuringElement* se = seCreate(SE_RECTANGLE, width, height);
+    if(se){
+        memset(se->data, 1, (size_t)width * height);
+    }
+    return se;
+}
+
+// Plus sign of size x size pixels with 1 pixel thick arms
+structuringElement* seCreateCross(int size){
+    structuringElement* se = seCreate(SE_CROSS, size, size);
+    if(se){
+        for(int i = 0; i < size; i++){
+            se->data[se->cy * size + i] = 1;
+            se->data[i * size + se->cx] = 1;
+        }
+    }
+    return se;
+}
+
+// Disk of the given radius: x^2 + y^2 <= r^2 + r, slightly fuller than r^2
+// so the four tips are not single pixels
+structuringElement* seCreateDisk(int radius){
+    if(radius < 0){
+        fprintf(stderr, "Morphology Error: Disk radius must not be negative.\n");
+        return NULL;
+    }
+    structuringElement* se = seCreate(SE_DISK, 2 * radius + 1, 2 * radius + 1);
+    if(se){
+        for(int dy = -radius; dy <= radius; dy++){
+            for(int dx = -radius; dx <= radius; dx++){
+                se->data[(dy + radius) * se->width + dx + radius] = dx * dx + dy * dy <= radius * radius + radius;
+            }
+        }
+    }
+    return se;
+}
+
+// Digital line of length pixels through the origin at angle degrees (counterclockwise
+// from the x axis, rows growing upwards as in BMP data); one pixel per step along the
+// major axis. Horizontal and vertical lines become 1-pixel rectangles
+structuringElement* seCreateLine(int length, float angle){
+    if(length < 1){
+        fprintf(stderr, "Morphology Error: Line length must be at least 1.\n");
+        return NULL;
+    }
+    double rad = angle * M_PI / 180.0;
+    double c = cos(rad), s = sin(rad);
+    if(fabs(s) < 1e-9){
+        return seCreateRectangle(length, 1);
+    }
+    if(fabs(c) < 1e-9){
+        return seCreateRectangle(1, length);
+    }
+
+    // Offsets for steps -(length-1)/2 .. length/2 along the major axis
+    int first = -(length - 1) / 2;
+    int minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for(int pass = 0; pass < 2; pass++){
+        structuringElement* se = NULL;
+        if(pass == 1){
+            se = seCreate(SE_OFFSETS, maxX - minX + 1, maxY - minY + 1);
+            if(!se){
+                return NULL;
+            }
+            se->cx = -minX;
+            se->cy = -minY;
+        }
+        for(int k = first; k < first + length; k++){
+            int dx, dy;
+            if(fabs(c) >= fabs(s)){
+                dx = k;
+                dy = (int)lround(k * s / c);
+            } else {
+                dy = k;
+                dx = (int)lround(k * c / s);
+            }
+            if(pass == 0){
+                minX = MIN(minX, dx);
+                maxX = MAX(maxX, dx);
+                minY = MIN(minY, dy);
+                maxY = MAX(maxY, dy);
+            } else {
+                se->data[(dy + se->cy) * se->width + dx + se->cx] = 1;
+            }
+        }
+        if(pass == 1){
+            return se;
+        }
+    }
+    return NULL;
+}
+
+// Reach of the element from its origin in either direction
+static int seReachX(const structuringElement* se){
+    return MAX(se->cx, se->width - 1 - se->cx);
+}
+static int seReachY(const structuringElement* se){
+    return MAX(se->cy, se->height - 1 - se->cy);
+}
+
+// Minimum for erosion, maximum for dilation
+static inline unsigned char morphPick(unsigned char a, unsigned char b, bool dilate){
+    return dilate ? MAX(a, b) : MIN(a, b);
+}
+
+// out[i] = min (or max) of a[i] and b[i]; the operation is chosen outside the loops
+// so each of them vectorizes (out may be a)
+static void morphCombine(unsigned char* out, const unsigned char* a, const unsigned char* b, int n, bool dilate){
+    if(dilate){
+        for(int i = 0; i < n; i++){
+            out[i] = MAX(a[i], b[i]);
+        }
+    } else {
+        for(int i = 0; i < n; i++){
+            out[i] = MIN(a[i], b[i]);
+        }
+    }
+}
+
+// Offsets of the set cells of element row i as a horizontal run [*dx0, *dx1] at row *dy
+// Erosion uses the offsets as they are, dilation their reflection
+// Returns false when the row is empty; the cells of a rectangle or disk row are contiguous
+static bool seRowRun(const structuringElement* se, int i, bool dilate, int* dy, int* dx0, int* dx1){
+    const unsigned char* row = se->data + i * se->width;
+    int j0 = 0, j1 = se->width - 1;
+    while(j0 <= j1 && !row[j0]){
+        j0++;
+    }
+    while(j1 >= j0 && !row[j1]){
+        j1--;
+    }
+    if(j0 > j1){
+        return false;
+    }
+    *dy = dilate ? se->cy - i : i - se->cy;
+    *dx0 = dilate ? se->cx - j1 : j0 - se->cx;
+    *dx1 = dilate ? se->cx - j0 : j1 - se->cx;
+    return true;
+}
+
+// out[x] = min (or max) of in[x + d0 .. x + d1] for x in [0, width)
+// Runs up to MORPH_DOUBLING_RUN double their window per pass (windows of 2s from two of
+// s), whole rows at a time; longer ones use van Herk/Gil-Werman: prefix and suffix
+// extrema within blocks of the run length give every window in 3 comparisons
+// g and h need room for width + d1 - d0 elements each
+static void morphRunRow(const unsigned char* in, int width, int d0, int d1, bool dilate,
+                        unsigned char* out, unsigned char* g, unsigned char* h){
+    int length = d1 - d0 + 1;
+    const unsigned char* base = in + d0;
+    int n = width + length - 1;
+    if(length == 1){
+        memcpy(out, base, width);
+        return;
+    }
+    if(length <= MORPH_DOUBLING_RUN){
+        const unsigned char* t = base;
+        int span = 1;
+        while(2 * span <= length){
+            morphCombine(g, t, t + span, n - 2 * span + 1, dilate);
+            t = g;
+            unsigned char* swap = g;
+            g = h;
+            h = swap;
+            span *= 2;
+        }
+        morphCombine(out, t, t + length - span, width, dilate);
+        return;
+    }
+    for(int b = 0; b < n; b += length){
+        int e = MIN(b + length, n);
+        g[b] = base[b];
+        for(int i = b + 1; i < e; i++){
+            g[i] = morphPick(g[i - 1], base[i], dilate);
+        }
+        h[e - 1] = base[e - 1];
+        for(int i = e - 2; i >= b; i--){
+            h[i] = morphPick(h[i + 1], base[i], dilate);
+        }
+    }
+    morphCombine(out, h, g + length - 1, width, dilate);
+}
+
+// Vertical counterpart of morphRunRow: out row y = min (or max) of in rows y .. y + length - 1
+// Whole rows are combined at once, so the inner loops run along memory
+// g and h need room for (rows + length - 1) * width elements each
+static void morphRunColumns(const unsigned char* in, int inStride, int width, int rows, int length, bool dilate,
+                            unsigned char* out, int outStride, unsigned char* g, unsigned char* h){
+    if(length <= MORPH_DIRECT_RUN){
+        for(int y = 0; y < rows; y++){
+            unsigned char* o = out + (size_t)y * outStride;
+            memcpy(o, in + (size_t)y * inStride, width);
+            for(int k = 1; k < length; k++){
+                morphCombine(o, o, in + (size_t)(y + k) * inStride, width, dilate);
+            }
+        }
+        return;
+    }
+    int n = rows + length - 1;
+    for(int b = 0; b < n; b += length){
+        int e = MIN(b + length, n);
+        memcpy(g + (size_t)b * width, in + (size_t)b * inStride, width);
+        for(int i = b + 1; i < e; i++){
+            morphCombine(g + (size_t)i * width, g + (size_t)(i - 1) * width, in + (size_t)i * inStride, width, dilate);
+        }
+        memcpy(h + (size_t)(e - 1) * width, in + (size_t)(e - 1) * inStride, width);
+        for(int i = e - 2; i >= b; i--){
+            morphCombine(h + (size_t)i * width, h + (size_t)(i + 1) * width, in + (size_t)i * inStride, width, dilate);
+        }
+    }
+    for(int y = 0; y < rows; y++){
+        morphCombine(out + (size_t)y * outStride, h + (size_t)y * width, g + (size_t)(y + length - 1) * width, width, dilate);
+    }
+}
+
+// Erode (or dilate) rows [0, rows) of a padded block into dst
+// src addresses output pixel (x, y) at src[(y + reachY) * srcStride + x + reachX]; the
+// block has rows + 2 reachY rows and width + 2 reachX columns, padding holding the
+// identity of the operation (255 for erosion, 0 for dilation)
+static bool morphRows(const unsigned char* src, int srcStride, int width, int rows,
+                      const structuringElement* se, bool dilate, unsigned char* dst, int dstStride){
+    int rx = seReachX(se), ry = seReachY(se);
+    const unsigned char* origin = src + (size_t)ry * srcStride + rx;
+    int span = rows + se->height - 1;
+    unsigned char* g = malloc((size_t)MAX(span, 1) * MAX(width + se->width, 1) * 2);
+    unsigned char* tmp = malloc((size_t)span * width);
+    if(!g || !tmp){
+        free(g);
+        free(tmp);
+        return false;
+    }
+    unsigned char* h = g + (size_t)MAX(span, 1) * MAX(width + se->width, 1);
+
+    int dy, dx0, dx1;
+    switch(se->shape){
+        case SE_RECTANGLE: {
+            // Horizontal runs over every row the vertical run needs, then the vertical run
+            int dyTop, dyBottom;
+            seRowRun(se, 0, dilate, &dyTop, &dx0, &dx1);
+            seRowRun(se, se->height - 1, dilate, &dyBottom, &dx0, &dx1);
+            int top = MIN(dyTop, dyBottom);
+            for(int r = 0; r < rows + se->height - 1; r++){
+                morphRunRow(origin + (long)(top + r) * srcStride, width, dx0, dx1, dilate, tmp + (size_t)r * width, g, h);
+            }
+            morphRunColumns(tmp, width, width, rows, se->height, dilate, dst, dstStride, g, h);
+            break;
+        }
+        case SE_CROSS: {
+            // Center row as a horizontal run, center column as a vertical run
+            seRowRun(se, se->cy, dilate, &dy, &dx0, &dx1);
+            for(int y = 0; y < rows; y++){
+                morphRunRow(origin + (size_t)y * srcStride, width, dx0, dx1, dilate, dst + (size_t)y * dstStride, g, h);
+            }
+            int top = dilate ? se->cy - (se->height - 1) : -se->cy;
+            morphRunColumns(origin + (long)top * srcStride, srcStride, width, rows, se->height, dilate, tmp, width, g, h);
+            for(int y = 0; y < rows; y++){
+                morphCombine(dst + (size_t)y * dstStride, dst + (size_t)y * dstStride, tmp + (size_t)y * width, width, dilate);
+            }
+            break;
+        }
+        case SE_DISK: {
+            // Rows dy and -dy share a chord: each distinct chord runs once over every
+            // source row of the block, then the output rows combine their chords
+            for(int y = 0; y < rows; y++){
+                memset(dst + (size_t)y * dstStride, dilate ? MIN_BRIGHTNESS : MAX_BRIGHTNESS, width);
+            }
+            int top = -seReachY(se);
+            for(int i = 0; i < se->height; i++){
+                int cx0, cx1;
+                if(!seRowRun(se, i, dilate, &dy, &cx0, &cx1)){
+                    continue;
+                }
+                // Skip chords already handled by an earlier row
+                bool seen = false;
+                for(int k = 0; k < i && !seen; k++){
+                    int kdy;
+                    seen = seRowRun(se, k, dilate, &kdy, &dx0, &dx1) && dx0 == cx0 && dx1 == cx1;
+                }
+                if(seen){
+                    continue;
+                }
+                for(int r = 0; r < span; r++){
+                    morphRunRow(origin + (long)(top + r) * srcStride, width, cx0, cx1, dilate, tmp + (size_t)r * width, g, h);
+                }
+                for(int k = i; k < se->height; k++){
+                    int kdy;
+                    if(!seRowRun(se, k, dilate, &kdy, &dx0, &dx1) || dx0 != cx0 || dx1 != cx1){
+                        continue;
+                    }
+                    for(int y = 0; y < rows; y++){
+                        morphCombine(dst + (size_t)y * dstStride, dst + (size_t)y * dstStride,
+                                     tmp + (size_t)(y + kdy - top) * width, width, dilate);
+                    }
+                }
+            }
+            break;
+        }
+        case SE_OFFSETS: {
+            // One pass over the block per offset
+            for(int y = 0; y < rows; y++){
+                memset(dst + (size_t)y * dstStride, dilate ? MIN_BRIGHTNESS : MAX_BRIGHTNESS, width);
+            }
+            for(int i = 0; i < se->height; i++){
+                for(int j = 0; j < se->width; j++){
+                    if(!se->data[i * se->width + j]){
+                        continue;
+                    }
+                    int ox = dilate ? se->cx - j : j - se->cx;
+                    int oy = dilate ? se->cy - i : i - se->cy;
+                    for(int y = 0; y < rows; y++){
+                        morphCombine(dst + (size_t)y * dstStride, dst + (size_t)y * dstStride,
+                                     origin + (long)(y + oy) * srcStride + ox, width, dilate);
+                    }
+                }
+            }
+            break;
+        }
+    }
+
+    free(g);
+    free(tmp);
+    return true;
+}
+
+// Copy image rows [y0, y1) into a block padded by padX columns on both sides,
+// with identity outside the image; block row 0 is image row y0
+static void morphFillBlock(BMP8Image* img, int y0, int y1, int padX, unsigned char identity,
+                           unsigned char* block, int blockStride){
+    int rowSize = (img->width + 3) & ~3;
+    for(int y = y0; y < y1; y++){
+        unsigned char* row = block + (size_t)(y - y0) * blockStride;
+        if(y < 0 || y >= img->height){
+            memset(row, identity, blockStride);
+            continue;
+        }
+        memset(row, identity, padX);
+        memcpy(row + padX, img->data + (size_t)y * rowSize, img->width);
+        memset(row + padX + img->width, identity, padX);
+    }
+}
+
+// Apply a morphological operation with the given element, writing into a caller-supplied image
+// Bands of MORPH_BAND rows run in parallel (OpenMP); opening, closing and the top-hats keep
+// their intermediate result in a band-sized buffer instead of a whole image
+// Pixels outside the image are ignored; dst must have the size of img and must not alias it
+bool BMP8MorphologyInto(BMP8Image* img, const structuringElement* se, morphOperation op, BMP8Image* dst){
+    if(!img || !se){
+        fprintf(stderr, "Morphology Error: Either there is no image or structuring element.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+    if(dst->data == img->data){
+        fprintf(stderr, "Morphology Error: In-place morphology is not supported.\n");
+        return false;
+    }
+
+    bool firstDilate = op == MORPH_DILATE || op == MORPH_CLOSE || op == MORPH_BLACKHAT;
+    bool twoPasses = op != MORPH_ERODE && op != MORPH_DILATE;
+    unsigned char firstIdentity = firstDilate ? MIN_BRIGHTNESS : MAX_BRIGHTNESS;
+    unsigned char secondIdentity = firstDilate ? MAX_BRIGHTNESS : MIN_BRIGHTNESS;
+
+    int rx = seReachX(se), ry = seReachY(se);
+    int stride = img->width + 2 * rx;
+    int rowSize = (img->width + 3) & ~3;
+    int bands = (img->height + MORPH_BAND - 1) / MORPH_BAND;
+    bool ok = true;
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int b = 0; b < bands; b++){
+        int y0 = b * MORPH_BAND, y1 = MIN(y0 + MORPH_BAND, img->height);
+        // The second pass needs ry more rows on each side, the first ry more again
+        int margin = twoPasses ? 2 * ry : ry;
+        unsigned char* source = malloc((size_t)(y1 - y0 + 2 * margin) * stride);
+        unsigned char* middle = twoPasses ? malloc((size_t)(y1 - y0 + 2 * ry) * stride) : NULL;
+        bool done = source && (middle || !twoPasses);
+        if(done){
+            morphFillBlock(img, y0 - margin, y1 + margin, rx, firstIdentity, source, stride);
+            if(!twoPasses){
+                done = morphRows(source, stride, img->width, y1 - y0, se, firstDilate, dst->data + (size_t)y0 * rowSize, rowSize);
+            } else {
+                // Intermediate rows [y0 - ry, y1 + ry) inside the image, identity of the second
+                // pass elsewhere, then the second pass straight into dst
+                memset(middle, secondIdentity, (size_t)(y1 - y0 + 2 * ry) * stride);
+                int m0 = MAX(y0 - ry, 0), m1 = MIN(y1 + ry, img->height);
+                done = morphRows(source + (size_t)(m0 - (y0 - ry)) * stride, stride, img->width, m1 - m0, se, firstDilate,
+                                 middle + (size_t)(m0 - (y0 - ry)) * stride + rx, stride) &&
+                       morphRows(middle, stride, img->width, y1 - y0, se, !firstDilate, dst->data + (size_t)y0 * rowSize, rowSize);
+            }
+        }
+        if(done && (op == MORPH_TOPHAT || op == MORPH_BLACKHAT)){
+            for(int y = y0; y < y1; y++){
+                unsigned char* o = dst->data + (size_t)y * rowSize;
+                const unsigned char* in = img->data + (size_t)y * rowSize;
+                for(int x = 0; x < img->width; x++){
+                    o[x] = op == MORPH_TOPHAT ? in[x] - o[x] : o[x] - in[x];
+                }
+            }
+        }
+        if(!done){
+            fprintf(stderr, "Memory allocation failed for morphology band!\n");
+            #pragma omp atomic write
+            ok = false;
+        }
+        free(source);
+        free(middle);
+    }
+    return ok;
+}
+
+// Allocating variant of BMP8MorphologyInto
+BMP8Image* BMP8Morphology(BMP8Image* img, const structuringElement* se, morphOperation op){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8MorphologyInto(img, se, op, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
+
+// Erosion: minimum over the element
+BMP8Image* BMP8Erode(BMP8Image* img, const structuringElement* se){
+    return BMP8Morphology(img, se, MORPH_ERODE);
+}
+
+// Dilation: maximum over the reflected element
+BMP8Image* BMP8Dilate(BMP8Image* img, const structuringElement* se){
+    return BMP8Morphology(img, se, MORPH_DILATE);
+}
+
+// Opening: removes bright details smaller than the element
+BMP8Image* BMP8Open(BMP8Image* img, const structuringElement* se){
+    return BMP8Morphology(img, se, MORPH_OPEN);
+}
+
+// Closing: removes dark details smaller than the element
+BMP8Image* BMP8Close(BMP8Image* img, const structuringElement* se){
+    return BMP8Morphology(img, se, MORPH_CLOSE);
+}
+
+// White top-hat: bright details smaller than the element
+BMP8Image* BMP8TopHat(BMP8Image* img, const structuringElement* se){
+    return BMP8Morphology(img, se, MORPH_TOPHAT);
+}
+
+// Black top-hat: dark details smaller than the element
+BMP8Image* BMP8BlackTopHat(BMP8Image* img, const structuringElement* se){
+    return BMP8Morphology(img, se, MORPH_BLACKHAT);
+}
+
+// Current monotonic time in seconds
+static double secondsNow(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(){
+    const char* inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
+
+    // Read the input BMP image
+    BMP8Image *image = BMP8read(inputFile);
+    if(!image){
+        return 1;
+    }
+
+    // Structuring elements of every kind
+    structuringElement* disk = seCreateDisk(7);
+    structuringElement* square = seCreateRectangle(15, 15);
+    structuringElement* cross = seCreateCross(9);
+    structuringElement* line = seCreateLine(21, 30.0f);
+    if(!disk || !square || !cross || !line){
+        BMP8Free(image);
+        return 1;
+    }
+
+    // One output per operation and element
+    struct {
+        morphOperation op;
+        structuringElement* se;
+        const char* name;
+        const char* outputFile;
+    } runs[] = {
+        {MORPH_ERODE, square, "erode, square 15", "images/lizard_erode_square15.bmp"},
+        {MORPH_DILATE, cross, "dilate, cross 9", "images/lizard_dilate_cross9.bmp"},
+        {MORPH_OPEN, disk, "open, disk r=7", "images/lizard_open_disk7.bmp"},
+        {MORPH_CLOSE, line, "close, line 21 at 30 deg", "images/lizard_close_line21.bmp"},
+        {MORPH_TOPHAT, disk, "top-hat, disk r=7", "images/lizard_tophat_disk7.bmp"},
+        {MORPH_BLACKHAT, disk, "black top-hat, disk r=7", "images/lizard_blackhat_disk7.bmp"},
+    };
+    for(int i = 0; i < (int)(sizeof(runs) / sizeof(runs[0])); i++){
+        double start = secondsNow();
+        BMP8Image* result = BMP8Morphology(image, runs[i].se, runs[i].op);
+        double elapsed = secondsNow() - start;
+        if(result){
+            printf("%-26s %7.2f ms\n", runs[i].name, elapsed * 1e3);
+            BMP8save(runs[i].outputFile, result);
+            BMP8Free(result);
+        }
+    }
+
+    // Free allocated memory
+    seFree(disk);
+    seFree(square);
+    seFree(cross);
+    seFree(line);
+    BMP8Free(image);
+
+    return 0;
+}
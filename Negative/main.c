@@ -70,48 +70,108 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-BMP8Image* BMP8Negative(BMP8Image* img) {
-    if (!img) return NULL;
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
+        return NULL;
+    }
 
-    // Allocate memory for negative image
-    BMP8Image* negativeImg = malloc(sizeof(BMP8Image));
-    if (!negativeImg) {
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
-    // Copy metadata
-    memcpy(negativeImg->header, img->header, BMP_HEADER_SIZE);
-    negativeImg->width = img->width;
-    negativeImg->height = img->height;
-    negativeImg->bitDepth = img->bitDepth;
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
-    // Copy color table if 8-bit
+    // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(negativeImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
-    // Compute padded row size
+    // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    negativeImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
     // Allocate memory for pixel data
-    negativeImg->data = malloc(negativeImg->imgSize);
-    if (!negativeImg->data) {
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(negativeImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Function to create the negative of an image, writing into a caller-supplied image
+// dst may alias img (every pixel only depends on itself)
+bool BMP8NegativeInto(BMP8Image* img, BMP8Image* dst) {
+    if (!BMP8CheckDestination(img, dst)) {
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
 
     // Compute negative: invert each pixel
     for (int y = 0; y < img->height; y++) {
         for (int x = 0; x < img->width; x++) {
             int idx = y * rowSize + x;
-            negativeImg->data[idx] = 255 - img->data[idx];
+            dst->data[idx] = 255 - img->data[idx];
         }
     }
 
-    return negativeImg;
+    return true;
+}
+
+// Function to create the negative of an 8-bit BMP image
+BMP8Image* BMP8Negative(BMP8Image* img){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8NegativeInto(img, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 // Function to save an 8-bit BMP image to a file
 void BMP8save(const char* filename, BMP8Image* img) {
@@ -133,14 +193,6 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
-        free(img);
-    }
-}
-
 
 int main() {
     // Input BMP file path (8-bit grayscale)
@@ -81,46 +81,93 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-// Add Gaussian noise to an 8-bit BMP image
-BMP8Image* BMP8NoiseGaussian(BMP8Image* img, float mean, float var){
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
     if(!img){
-        fprintf(stderr, "Noise Error: Image does not exists.\n");
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
-    // Allocate memory for the new image
-    BMP8Image* noisedImg = malloc(sizeof(BMP8Image));
-    if(!noisedImg){
-        fprintf(stderr, "Noise Error: Memory allocation failed!\n");
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
+        fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
-    // Copy image metadata
-    memcpy(noisedImg->header, img->header, BMP_HEADER_SIZE);
-    noisedImg->width = img->width;
-    noisedImg->height = img->height;
-    noisedImg->bitDepth = img->bitDepth;
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
-    // Copy color table if 8-bit grayscale
+    // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(noisedImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
-    // Compute padded row size
+    // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    noisedImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
     // Allocate memory for pixel data
-    noisedImg->data = malloc(noisedImg->imgSize);
-    if (!noisedImg->data) {
-        fprintf(stderr, "Noise Error: Memory allocation failed for pixel data!\n");
-        free(noisedImg);
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
+
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Add Gaussian noise to an image, writing into a caller-supplied image
+// dst may alias img (every pixel only depends on itself)
+bool BMP8NoiseGaussianInto(BMP8Image* img, float mean, float var, BMP8Image* dst){
+    if(!img){
+        fprintf(stderr, "Noise Error: Image does not exists.\n");
+        return false;
+    }
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
 
     // Iterate through every pixel
-    for(int j = 0; j < noisedImg->height; j++){
-        for(int i = 0; i < noisedImg->width; i++){
+    for(int j = 0; j < img->height; j++){
+        for(int i = 0; i < img->width; i++){
             // Generate two uniform random numbers in (0,1]
             float u1 = ((float)rand() + 1) / ((float)RAND_MAX + 1);
             float u2 = ((float)rand() + 1) / ((float)RAND_MAX + 1);
@@ -139,11 +186,24 @@ BMP8Image* BMP8NoiseGaussian(BMP8Image* img, float mean, float var){
             px = MIN(MAX_BRIGHTNESS, px);
 
             // Store the result
-            noisedImg->data[j * rowSize + i] = (unsigned char)px;
+            dst->data[j * rowSize + i] = (unsigned char)px;
         }
     }
 
-    return noisedImg;
+    return true;
+}
+
+// Add Gaussian noise to an image and return a newly allocated result
+BMP8Image* BMP8NoiseGaussian(BMP8Image* img, float mean, float var){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8NoiseGaussianInto(img, mean, var, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
 }
 
 
@@ -167,14 +227,6 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
-        free(img);
-    }
-}
-
 
 int main(){
     const char* inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
@@ -8,6 +8,8 @@
 #define BMP_HEADER_SIZE 54
 // Size of color table for 8-bit BMP
 #define BMP_COLOR_TABLE_SIZE 1024
+// Rows of one variant processed together by a sweep
+#define SWEEP_BAND 64
 
 // Structure to hold 8-bit BMP image data
 typedef struct {
@@ -71,58 +73,175 @@ BMP8Image* BMP8read(const char* filename) {
     return img;
 }
 
-BMP8Image* BMP8NoiseSaltPepper(BMP8Image* img, float prob){
-    if(prob < 0 || prob > 1){
-        fprintf(stderr, "Probability should be between 0 and 1!\n");
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Allocate an image with the same geometry, header and color table as img
+BMP8Image* BMP8CreateLike(BMP8Image* img){
+    if(!img){
+        fprintf(stderr, "Error: No image provided.\n");
         return NULL;
     }
 
-    // Allocate memory for the new image
-    BMP8Image* noisedImg = malloc(sizeof(BMP8Image));
-    if(!noisedImg){
+    // Allocate memory for new image
+    BMP8Image* newImg = malloc(sizeof(BMP8Image));
+    if(!newImg){
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
 
-    // Copy image metadata
-    memcpy(noisedImg->header, img->header, BMP_HEADER_SIZE);
-    noisedImg->width = img->width;
-    noisedImg->height = img->height;
-    noisedImg->bitDepth = img->bitDepth;
+    // Copy BMP header and metadata
+    memcpy(newImg->header, img->header, BMP_HEADER_SIZE);
+    newImg->width = img->width;
+    newImg->height = img->height;
+    newImg->bitDepth = img->bitDepth;
 
-    // Copy color table if 8-bit grayscale
+    // Copy color table if grayscale (8-bit)
     if (img->bitDepth <= 8) {
-        memcpy(noisedImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        memcpy(newImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
     }
 
-    // Compute padded row size
+    // Compute padded row size and total image size
     int rowSize = (img->width + 3) & ~3;
-    noisedImg->imgSize = rowSize * img->height;
+    newImg->imgSize = rowSize * img->height;
 
     // Allocate memory for pixel data
-    noisedImg->data = malloc(noisedImg->imgSize);
-    if (!noisedImg->data) {
+    newImg->data = malloc(newImg->imgSize);
+    if (!newImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(noisedImg);
+        free(newImg);
         return NULL;
     }
+    return newImg;
+}
+
+// Check that dst can receive the result of a same-size operator applied to img
+// On success dst takes over the header and color table of img
+bool BMP8CheckDestination(BMP8Image* img, BMP8Image* dst){
+    if(!img || !dst || !dst->data){
+        fprintf(stderr, "Error: Either there is no image or destination.\n");
+        return false;
+    }
+    if(dst->width != img->width || dst->height != img->height){
+        fprintf(stderr, "Error: Destination size does not match the image.\n");
+        return false;
+    }
 
-    for(int j = 0; j < noisedImg->height; j++){
-        for(int i = 0; i < noisedImg->width; i++){
+    // Destination describes the same image format as the source
+    if(dst != img){
+        memcpy(dst->header, img->header, BMP_HEADER_SIZE);
+        dst->bitDepth = img->bitDepth;
+        if (img->bitDepth <= 8) {
+            memcpy(dst->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+        }
+    }
+    return true;
+}
+
+// Add salt and pepper noise to an image, writing into a caller-supplied image
+// dst may alias img (every pixel only depends on itself)
+bool BMP8NoiseSaltPepperInto(BMP8Image* img, float prob, BMP8Image* dst){
+    if(!BMP8CheckDestination(img, dst)){
+        return false;
+    }
+
+    // Compute padded row size
+    int rowSize = (img->width + 3) & ~3;
+
+    for(int j = 0; j < img->height; j++){
+        for(int i = 0; i < img->width; i++){
             float r = (float)rand() / RAND_MAX;
             if(r < prob / 2.0f){
-                noisedImg->data[j * rowSize + i] = 0;
+                dst->data[j * rowSize + i] = 0;
             } else if(r > 1.0f - prob / 2.0f){
-                noisedImg->data[j * rowSize + i] = 255;
+                dst->data[j * rowSize + i] = 255;
             } else {
-                noisedImg->data[j * rowSize + i] = img->data[j * rowSize + i];
+                dst->data[j * rowSize + i] = img->data[j * rowSize + i];
             }
         }
     }
 
-    return noisedImg;
+    return true;
 }
 
+// Add salt and pepper noise to an image and return a newly allocated result
+BMP8Image* BMP8NoiseSaltPepper(BMP8Image* img, float prob){
+    BMP8Image* dst = BMP8CreateLike(img);
+    if(!dst){
+        return NULL;
+    }
+    if(!BMP8NoiseSaltPepperInto(img, prob, dst)){
+        BMP8Free(dst);
+        return NULL;
+    }
+    return dst;
+}
+
+
+// Salt and pepper noise of several probabilities over one image, in parallel.
+// results[k] receives a newly allocated image with noise probability probs[k].
+// The uniform random number of every pixel is drawn once, in the order
+// BMP8NoiseSaltPepperInto draws them, and shared by all variants: from the same
+// seed each variant equals BMP8NoiseSaltPepper(img, probs[k]), and the noisy pixels
+// of a lower probability stay noisy at every higher one, so variants differ only by
+// their probability
+bool BMP8NoiseSaltPepperSweep(BMP8Image* img, const float* probs, int count, BMP8Image** results){
+    if(!img || !probs || !results || count < 1){
+        fprintf(stderr, "Noise Error: Either there is no image or no probabilities.\n");
+        return false;
+    }
+
+    float* field = malloc((size_t)img->width * img->height * sizeof(float));
+    bool ok = field != NULL;
+    for(int k = 0; k < count; k++){
+        results[k] = ok ? BMP8CreateLike(img) : NULL;
+        ok = ok && results[k] != NULL;
+    }
+    if(!ok){
+        fprintf(stderr, "Noise Error: Memory allocation failed!\n");
+        free(field);
+        for(int k = 0; k < count; k++){
+            BMP8Free(results[k]);
+            results[k] = NULL;
+        }
+        return false;
+    }
+    for(size_t i = 0; i < (size_t)img->width * img->height; i++){
+        field[i] = (float)rand() / RAND_MAX;
+    }
+
+    // Every band of every variant is independent
+    int rowSize = (img->width + 3) & ~3;
+    int bands = (img->height + SWEEP_BAND - 1) / SWEEP_BAND;
+    #pragma omp parallel for collapse(2) schedule(dynamic)
+    for(int k = 0; k < count; k++){
+        for(int band = 0; band < bands; band++){
+            float low = probs[k] / 2.0f, high = 1.0f - probs[k] / 2.0f;
+            int y0 = band * SWEEP_BAND, y1 = y0 + SWEEP_BAND < img->height ? y0 + SWEEP_BAND : img->height;
+            for(int j = y0; j < y1; j++){
+                const float* r = field + (size_t)j * img->width;
+                const unsigned char* in = img->data + (size_t)j * rowSize;
+                unsigned char* out = results[k]->data + (size_t)j * rowSize;
+                memcpy(out, in, rowSize);
+                for(int i = 0; i < img->width; i++){
+                    if(r[i] < low){
+                        out[i] = 0;
+                    } else if(r[i] > high){
+                        out[i] = 255;
+                    }
+                }
+            }
+        }
+    }
+
+    free(field);
+    return true;
+}
 
 // Function to save an 8-bit BMP image to a file
 void BMP8save(const char* filename, BMP8Image* img) {
@@ -144,34 +263,31 @@ void BMP8save(const char* filename, BMP8Image* img) {
 }
 
 
-// Free memory used by BMP8Image
-void BMP8Free(BMP8Image* img) {
-    if (img) {
-        free(img->data);
-        free(img);
-    }
-}
-
 
 int main(){
     const char* inputFile = "../Test_Images/lizard_greyscale8bit.bmp";
-    const char* outputFile = "images/lizard_saltpepper_1.bmp";
     srand(time(NULL));
 
-    // Read original BMP image
+    // Read original BMP image once for every probability
     BMP8Image *image = BMP8read(inputFile);
     if(!image){
         return 1;
     }
-    BMP8Image *noised = BMP8NoiseSaltPepper(image, 0.01);
-    if(!noised){
+    const float probs[] = {0.01f, 0.03f, 0.10f, 0.20f, 0.60f};
+    const int count = sizeof(probs) / sizeof(probs[0]);
+    BMP8Image *noised[sizeof(probs) / sizeof(probs[0])];
+    if(!BMP8NoiseSaltPepperSweep(image, probs, count, noised)){
         BMP8Free(image);
         return 1;
     }
-    BMP8save(outputFile, noised);
+    for(int k = 0; k < count; k++){
+        char outputFile[64];
+        sprintf(outputFile, "images/lizard_saltpepper_%d.bmp", (int)(probs[k] * 100.0f + 0.5f));
+        BMP8save(outputFile, noised[k]);
+        BMP8Free(noised[k]);
+    }
 
     BMP8Free(image);
-    BMP8Free(noised);
 
     return 0;
 }
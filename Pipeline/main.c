@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline.h"
+
+// Function to read an 8-bit BMP image from file
+BMP8Image* BMP8read(const char* filename) {
+    // open file in binary mode
+    FILE *fInput = fopen(filename, "rb");
+    if (!fInput) {
+        fprintf(stderr, "Unable to open file %s!\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for image structure
+    BMP8Image *img = (BMP8Image*)malloc(sizeof(BMP8Image));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        fclose(fInput);
+        return NULL;
+    }
+
+    // Read header (54 bytes)
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, fInput);
+
+    // Extract metadata from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Compute row size (aligned to 4 bytes)
+    int rowSize = (img->width + 3) & ~3;
+    img->imgSize = rowSize * img->height;
+
+    // Read color table (only if <= 8-bit image)
+    if (img->bitDepth <= 8) {
+        fread(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fInput);
+    }
+
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->imgSize);
+    if (!img->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(img);
+        fclose(fInput);
+        return NULL;
+    }
+
+    // Read pixel data
+    fread(img->data, sizeof(unsigned char), img->imgSize, fInput);
+    fclose(fInput);
+
+    return img;
+}
+
+// Function to save an 8-bit BMP image to a file
+void BMP8save(const char* filename, BMP8Image* img) {
+    FILE *fOutput = fopen(filename, "wb");
+    if (!fOutput) {
+        fprintf(stderr, "Unable to create file %s!\n", filename);
+        return;
+    }
+
+    // Write BMP header
+    fwrite(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, fOutput);
+
+    // Write color table if <= 8-bit image
+    if (img->bitDepth <= 8) {
+        fwrite(img->colorTable, sizeof(unsigned char), BMP_COLOR_TABLE_SIZE, fOutput);
+    }
+
+    // Write pixel data
+    fwrite(img->data, sizeof(unsigned char), img->imgSize, fOutput);
+
+    fclose(fOutput);
+}
+
+// Function to free allocated memory
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+
+
+int main(){
+    const char *inputFile = "../Test_Images/lizard.bmp";
+    const char *outputFile = "images/lizard_edges_fused.bmp";
+
+    BMP24Image *image = BMP24Read(inputFile);
+    if (!image) {
+        return 1;
+    }
+
+    // greyscale -> 3x3 blur -> Sobel -> threshold, described lazily
+    pipeline *p = pipelineCreate();
+    pipeNode *grey = pipelineSource24(p, image);
+    pipeNode *blurred = pipelineBlur(p, grey, 3);
+    pipeNode *edges = pipelineSobel(p, blurred);
+    pipeNode *binary = pipelineThreshold(p, edges, 64);
+
+    // The whole chain runs in one fused pass; no intermediate image is allocated
+    BMP8Image *result = pipelineRun(p, binary);
+    if (result) {
+        BMP8save(outputFile, result);
+        BMP8Free(result);
+        printf("Fused pipeline completed! Saved result as %s\n", outputFile);
+    }
+
+    pipelineFree(p);
+    BMP24Free(image);
+    return 0;
+}
@@ -0,0 +1,613 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "pipeline.h"
+
+// Maximum value of a pixel
+#define MAX_BRIGHTNESS 255
+// Minimum value of a pixel
+#define MIN_BRIGHTNESS 0
+// Number of output rows produced by one tile of a fused pass
+#define TILE_ROWS 32
+
+// Macro definitions for minimum and maximum values
+#define MIN(a, b) ((a) < (b) ? (a) : (b))   // returns the smaller of (a) and (b)
+#define MAX(a, b) ((a) > (b) ? (a) : (b))   // returns the larger of (a) and (b)
+
+// A neighborhood operator of a compiled pipeline, with the point operators
+// that precede it folded into a single lookup table
+typedef struct {
+    pipeNode *node;             // Blur, convolution or Sobel node
+    unsigned char pre[256];     // Fused point operators applied to incoming rows
+    bool hasPre;                // False when pre is the identity
+    int above;                  // Input rows needed above an output row
+    int below;                  // Input rows needed below an output row
+} pipeStage;
+
+// Execution plan produced by fusing a chain of nodes
+typedef struct {
+    pipeNode *source;           // Source node at the head of the chain
+    pipeStage *stages;          // Neighborhood stages in execution order
+    int stageCount;             // Number of neighborhood stages
+    unsigned char post[256];    // Point operators after the last neighborhood stage
+    bool hasPost;               // False when post is the identity
+    int width;                  // Image width in pixels
+    int height;                 // Image height in pixels
+} pipePlan;
+
+// Ring of input rows feeding one neighborhood stage
+// Holds rows [next - ringSize, next) at slot (row % ringSize)
+typedef struct {
+    unsigned char *rows;        // ringSize rows of width bytes
+    int ringSize;               // above + below + 1
+    int next;                   // Next input row to load (-1 while empty)
+    unsigned char *scratch;     // Two rows of gradients for Sobel stages
+} lineBuffer;
+
+// Per-tile execution state: one line buffer per stage
+typedef struct {
+    pipePlan *plan;
+    lineBuffer *buffers;
+} pipeRunState;
+
+// Convert RGB color to grayscale (same weights as RGBtoGreyScale)
+static unsigned char rgbToGray(unsigned char r, unsigned char g, unsigned char b) {
+    return (unsigned char)(0.3*r + 0.59*g + 0.11*b);
+}
+
+// Create an empty pipeline
+pipeline* pipelineCreate(void) {
+    pipeline *p = malloc(sizeof(pipeline));
+    if (!p) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    p->nodes = NULL;
+    return p;
+}
+
+// Free a pipeline and every node created through it
+// Source images are owned by the caller and are not freed
+void pipelineFree(pipeline* p) {
+    if (!p) {
+        return;
+    }
+    pipeNode *node = p->nodes;
+    while (node) {
+        pipeNode *next = node->next;
+        maskFree(node->m);
+        free(node);
+        node = next;
+    }
+    free(p);
+}
+
+// Allocate a node of the given kind and register it with the pipeline
+static pipeNode* pipelineAddNode(pipeline* p, pipeNodeKind kind, pipeNode* input) {
+    if (!p) {
+        fprintf(stderr, "Pipeline Error: No pipeline provided.\n");
+        return NULL;
+    }
+    pipeNode *node = calloc(1, sizeof(pipeNode));
+    if (!node) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    node->kind = kind;
+    node->input = input;
+    node->next = p->nodes;
+    p->nodes = node;
+    return node;
+}
+
+// Start a graph from an 8-bit image
+pipeNode* pipelineSource8(pipeline* p, BMP8Image* img) {
+    if (!img) {
+        fprintf(stderr, "Pipeline Error: No image provided.\n");
+        return NULL;
+    }
+    pipeNode *node = pipelineAddNode(p, NODE_SOURCE8, NULL);
+    if (node) {
+        node->source8 = img;
+    }
+    return node;
+}
+
+// Start a graph from a 24-bit image; pixels are converted to greyscale as they are read
+pipeNode* pipelineSource24(pipeline* p, BMP24Image* img) {
+    if (!img) {
+        fprintf(stderr, "Pipeline Error: No image provided.\n");
+        return NULL;
+    }
+    pipeNode *node = pipelineAddNode(p, NODE_SOURCE24, NULL);
+    if (node) {
+        node->source24 = img;
+    }
+    return node;
+}
+
+// Apply an arbitrary 256-entry lookup table to every pixel
+pipeNode* pipelineLookup(pipeline* p, pipeNode* in, const unsigned char lut[256]) {
+    // A failed upstream node propagates, so calls can be chained without checks
+    if (!in) {
+        return NULL;
+    }
+    pipeNode *node = pipelineAddNode(p, NODE_POINT, in);
+    if (node) {
+        memcpy(node->lut, lut, 256);
+    }
+    return node;
+}
+
+// Invert every pixel (same result as BMP8Negative)
+pipeNode* pipelineNegative(pipeline* p, pipeNode* in) {
+    unsigned char lut[256];
+    for (int v = 0; v < 256; v++) {
+        lut[v] = (unsigned char)(MAX_BRIGHTNESS - v);
+    }
+    return pipelineLookup(p, in, lut);
+}
+
+// Add delta to every pixel, clamped to [0, 255] (BMP8Increase/DecreaseBrightness)
+pipeNode* pipelineBrightness(pipeline* p, pipeNode* in, int delta) {
+    unsigned char lut[256];
+    for (int v = 0; v < 256; v++) {
+        int value = v + delta;
+        value = MIN(value, MAX_BRIGHTNESS);
+        value = MAX(value, MIN_BRIGHTNESS);
+        lut[v] = (unsigned char)value;
+    }
+    return pipelineLookup(p, in, lut);
+}
+
+// Set pixels above threshold to white and the rest to black (same result as BMP8Binarize)
+pipeNode* pipelineThreshold(pipeline* p, pipeNode* in, int threshold) {
+    unsigned char lut[256];
+    for (int v = 0; v < 256; v++) {
+        lut[v] = (v > threshold) ? MAX_BRIGHTNESS : MIN_BRIGHTNESS;
+    }
+    return pipelineLookup(p, in, lut);
+}
+
+// Box blur with a size x size kernel (same result as BMP8Blur)
+pipeNode* pipelineBlur(pipeline* p, pipeNode* in, unsigned int size) {
+    if (!in) {
+        return NULL;
+    }
+    if (size % 2 == 0) {
+        fprintf(stderr, "Pipeline Error: Blur size must be odd.\n");
+        return NULL;
+    }
+    pipeNode *node = pipelineAddNode(p, NODE_BLUR, in);
+    if (node) {
+        node->size = size;
+    }
+    return node;
+}
+
+// Convolution with an arbitrary mask (same result as BMP8Convolution)
+// The mask is copied, so the caller may free it right away
+pipeNode* pipelineConvolution(pipeline* p, pipeNode* in, mask* m) {
+    if (!in) {
+        return NULL;
+    }
+    if (!m || !m->data) {
+        fprintf(stderr, "Pipeline Error: No mask provided.\n");
+        return NULL;
+    }
+    pipeNode *node = pipelineAddNode(p, NODE_CONVOLUTION, in);
+    if (!node) {
+        return NULL;
+    }
+    // A node without its mask stays unreachable and is released by pipelineFree
+    node->m = maskCreate(m->rows, m->cols);
+    if (!node->m || !node->m->data) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    memcpy(node->m->data, m->data, m->rows * m->cols * sizeof(float));
+    return node;
+}
+
+// Combined Sobel edge magnitude (same result as BMP8EdgeDetectionSobelCombined)
+pipeNode* pipelineSobel(pipeline* p, pipeNode* in) {
+    if (!in) {
+        return NULL;
+    }
+    return pipelineAddNode(p, NODE_SOBEL, in);
+}
+
+
+// Compose two lookup tables: result[v] = second[first[v]]
+static void lutCompose(unsigned char* first, const unsigned char* second) {
+    for (int v = 0; v < 256; v++) {
+        first[v] = second[first[v]];
+    }
+}
+
+// Reset a lookup table to the identity
+static void lutIdentity(unsigned char* lut) {
+    for (int v = 0; v < 256; v++) {
+        lut[v] = (unsigned char)v;
+    }
+}
+
+// Apply a lookup table to one row in place
+static void lutApply(const unsigned char* lut, unsigned char* row, int width) {
+    for (int x = 0; x < width; x++) {
+        row[x] = lut[row[x]];
+    }
+}
+
+// Fuse the chain ending at out into a plan
+// Runs of point operators collapse into one table that is applied either as rows
+// enter the next neighborhood stage or as the final rows are written
+static bool pipelineCompile(pipeNode* out, pipePlan* plan) {
+    // Walk back to the source, counting neighborhood stages
+    int chainLength = 0;
+    int stageCount = 0;
+    pipeNode *node = out;
+    for (; node && node->input; node = node->input) {
+        chainLength++;
+        if (node->kind != NODE_POINT) {
+            stageCount++;
+        }
+    }
+    if (!node) {
+        fprintf(stderr, "Pipeline Error: Graph has no source.\n");
+        return false;
+    }
+
+    // Collect the chain in execution order (source first)
+    pipeNode **chain = malloc((chainLength + 1) * sizeof(pipeNode*));
+    plan->stages = malloc((stageCount + 1) * sizeof(pipeStage));
+    if (!chain || !plan->stages) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        free(chain);
+        free(plan->stages);
+        return false;
+    }
+    int i = chainLength;
+    for (node = out; node; node = node->input) {
+        chain[i--] = node;
+    }
+
+    plan->source = chain[0];
+    if (plan->source->kind == NODE_SOURCE8) {
+        plan->width = plan->source->source8->width;
+        plan->height = plan->source->source8->height;
+    } else {
+        plan->width = plan->source->source24->width;
+        plan->height = plan->source->source24->height;
+    }
+
+    // Fold point operators into the table of whatever consumes them next
+    unsigned char pending[256];
+    bool hasPending = false;
+    lutIdentity(pending);
+    plan->stageCount = 0;
+    for (i = 1; i <= chainLength; i++) {
+        node = chain[i];
+        if (node->kind == NODE_POINT) {
+            lutCompose(pending, node->lut);
+            hasPending = true;
+            continue;
+        }
+
+        pipeStage *stage = &plan->stages[plan->stageCount++];
+        stage->node = node;
+        memcpy(stage->pre, pending, 256);
+        stage->hasPre = hasPending;
+        switch (node->kind) {
+            case NODE_BLUR:
+                stage->above = stage->below = node->size / 2;
+                break;
+            case NODE_CONVOLUTION:
+                stage->above = node->m->rows / 2;
+                stage->below = node->m->rows - 1 - node->m->rows / 2;
+                break;
+            default:
+                stage->above = stage->below = 1;
+                break;
+        }
+        lutIdentity(pending);
+        hasPending = false;
+    }
+    memcpy(plan->post, pending, 256);
+    plan->hasPost = hasPending;
+
+    free(chain);
+    return true;
+}
+
+// Copy row y of the source into out, converting 24-bit pixels to greyscale
+static void sourceRow(pipeNode* source, int y, unsigned char* out, int width) {
+    if (source->kind == NODE_SOURCE8) {
+        int rowSize = (width + 3) & ~3;
+        memcpy(out, source->source8->data + y * rowSize, width);
+        return;
+    }
+    const unsigned char *row = source->source24->data + y * source->source24->rowSize;
+    for (int x = 0; x < width; x++) {
+        const unsigned char *pixel = row + x * 3;
+        out[x] = rgbToGray(pixel[2], pixel[1], pixel[0]);
+    }
+}
+
+// Return row y held by a line buffer
+static unsigned char* lineBufferRow(lineBuffer* lb, int y, int width) {
+    return lb->rows + (size_t)(y % lb->ringSize) * width;
+}
+
+// Convolve row y of a neighborhood with a mask, zero padding outside the image
+// Arithmetic mirrors BMP8ConvolutionInto so fused and unfused results match bit for bit
+static void convolveRow(lineBuffer* lb, const float* coeffs, int rows, int cols, int y, int width, int height, unsigned char* out) {
+    int iCenter = rows / 2;
+    int jCenter = cols / 2;
+
+    for (int x = 0; x < width; x++) {
+        float val = 0.0f;
+        for (int i = 0; i < rows; i++) {
+            int idy = y + (i - iCenter);
+            if (idy < 0 || idy >= height) {
+                continue;
+            }
+            const unsigned char *in = lineBufferRow(lb, idy, width);
+            for (int j = 0; j < cols; j++) {
+                int idx = x + (j - jCenter);
+                if (idx >= 0 && idx < width) {
+                    float ms = coeffs[i * cols + j];
+                    float im = in[idx];
+                    val += ms * im;
+                }
+            }
+        }
+
+        // Clamp to valid grayscale range [0..255]
+        val = MIN(val, MAX_BRIGHTNESS);
+        val = MAX(val, MIN_BRIGHTNESS);
+        out[x] = (unsigned char)val;
+    }
+}
+
+// Box blur of row y, copying pixels closer than size/2 to the border
+// Arithmetic mirrors BMP8BlurInto so fused and unfused results match bit for bit
+static void blurRow(lineBuffer* lb, unsigned int size, int y, int width, int height, unsigned char* out) {
+    int offset = size / 2;
+    const unsigned char *center = lineBufferRow(lb, y, width);
+
+    // Border rows are copied unchanged
+    if (y < offset || y >= height - offset) {
+        memcpy(out, center, width);
+        return;
+    }
+
+    float value = 1.0f / (size * size);
+    for (int x = 0; x < width; x++) {
+        if (x < offset || x >= width - offset) {
+            out[x] = center[x];
+            continue;
+        }
+
+        float sum = 0.0f;
+        for (int j = -offset; j <= offset; j++) {
+            const unsigned char *in = lineBufferRow(lb, y + j, width);
+            for (int i = -offset; i <= offset; i++) {
+                int pixelVal = in[x + i];
+                sum += value * pixelVal;
+            }
+        }
+
+        if (sum < 0) sum = 0;
+        if (sum > 255) sum = 255;
+        out[x] = (unsigned char)sum;
+    }
+}
+
+// Combined Sobel magnitude of row y
+// Each gradient is clamped to [0, 255] first, as BMP8EdgeDetectionSobelCombined does
+static void sobelRow(lineBuffer* lb, int y, int width, int height, unsigned char* out) {
+    static const float sobelH[9] = {-1, -2, -1,  0, 0, 0,  1, 2, 1};
+    static const float sobelV[9] = {-1,  0,  1, -2, 0, 2, -1, 0, 1};
+
+    unsigned char *horizontal = lb->scratch;
+    unsigned char *vertical = lb->scratch + width;
+    convolveRow(lb, sobelH, 3, 3, y, width, height, horizontal);
+    convolveRow(lb, sobelV, 3, 3, y, width, height, vertical);
+
+    for (int x = 0; x < width; x++) {
+        int gx = horizontal[x];
+        int gy = vertical[x];
+        int g = (int)(sqrt(gx*gx + gy*gy));
+        out[x] = (unsigned char)MIN(g, MAX_BRIGHTNESS);
+    }
+}
+
+static void stageRow(pipeRunState* state, int k, int y, unsigned char* out);
+
+// Produce row y of the input of stage k (after its fused point operators)
+static void stageInputRow(pipeRunState* state, int k, int y, unsigned char* out) {
+    pipePlan *plan = state->plan;
+    if (k == 0) {
+        sourceRow(plan->source, y, out, plan->width);
+    } else {
+        stageRow(state, k - 1, y, out);
+    }
+    if (plan->stages[k].hasPre) {
+        lutApply(plan->stages[k].pre, out, plan->width);
+    }
+}
+
+// Produce output row y of stage k
+// Rows must be requested in increasing order; the line buffer only ever
+// loads each input row once and drops it when it leaves the window
+static void stageRow(pipeRunState* state, int k, int y, unsigned char* out) {
+    pipePlan *plan = state->plan;
+    pipeStage *stage = &plan->stages[k];
+    lineBuffer *lb = &state->buffers[k];
+
+    // Load every input row this output row depends on
+    int first = MAX(y - stage->above, 0);
+    int last = MIN(y + stage->below, plan->height - 1);
+    if (lb->next < 0) {
+        lb->next = first;
+    }
+    while (lb->next <= last) {
+        stageInputRow(state, k, lb->next, lineBufferRow(lb, lb->next, plan->width));
+        lb->next++;
+    }
+
+    switch (stage->node->kind) {
+        case NODE_BLUR:
+            blurRow(lb, stage->node->size, y, plan->width, plan->height, out);
+            break;
+        case NODE_CONVOLUTION:
+            convolveRow(lb, stage->node->m->data, stage->node->m->rows, stage->node->m->cols, y, plan->width, plan->height, out);
+            break;
+        case NODE_SOBEL:
+            sobelRow(lb, y, plan->width, plan->height, out);
+            break;
+        default:
+            break;
+    }
+}
+
+// Fill the header and color table of dst for the plan's output
+static void pipelineOutputHeader(pipePlan* plan, BMP8Image* dst) {
+    if (plan->source->kind == NODE_SOURCE8) {
+        BMP8Image *src = plan->source->source8;
+        memcpy(dst->header, src->header, BMP_HEADER_SIZE);
+        memcpy(dst->colorTable, src->colorTable, BMP_COLOR_TABLE_SIZE);
+        dst->bitDepth = src->bitDepth;
+        return;
+    }
+
+    // Greyscale output of a 24-bit source, laid out as in BMP24ConvertTo8
+    memcpy(dst->header, plan->source->source24->header, BMP_HEADER_SIZE);
+    *(short*)&dst->header[28] = 8;
+    *(int*)&dst->header[10] = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE;
+    *(int*)&dst->header[34] = dst->imgSize;
+    for (int i = 0; i < 256; i++) {
+        dst->colorTable[i*4 + 0] = i;
+        dst->colorTable[i*4 + 1] = i;
+        dst->colorTable[i*4 + 2] = i;
+        dst->colorTable[i*4 + 3] = 0;
+    }
+    dst->bitDepth = 8;
+}
+
+// Evaluate the graph ending at out in one fused, tiled pass, writing into dst
+// Only the source and dst are full images; every intermediate lives in line
+// buffers of (above + below + 1) rows per neighborhood stage. Tiles of TILE_ROWS
+// output rows run in parallel, each re-reading the few halo rows it needs
+bool pipelineRunInto(pipeline* p, pipeNode* out, BMP8Image* dst) {
+    if (!p || !out || !dst || !dst->data) {
+        fprintf(stderr, "Pipeline Error: Either there is no graph or destination.\n");
+        return false;
+    }
+
+    pipePlan plan;
+    if (!pipelineCompile(out, &plan)) {
+        return false;
+    }
+    if (dst->width != plan.width || dst->height != plan.height) {
+        fprintf(stderr, "Pipeline Error: Destination size does not match the source.\n");
+        free(plan.stages);
+        return false;
+    }
+    if (plan.source->kind == NODE_SOURCE8 && dst->data == plan.source->source8->data && plan.stageCount > 0) {
+        fprintf(stderr, "Pipeline Error: In-place evaluation is only supported for point operators.\n");
+        free(plan.stages);
+        return false;
+    }
+    pipelineOutputHeader(&plan, dst);
+
+    int rowSize = (plan.width + 3) & ~3;
+    int tiles = (plan.height + TILE_ROWS - 1) / TILE_ROWS;
+    bool ok = true;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int t = 0; t < tiles; t++) {
+        // Line buffers are private to the tile
+        pipeRunState state;
+        state.plan = &plan;
+        state.buffers = calloc(plan.stageCount + 1, sizeof(lineBuffer));
+        bool allocated = state.buffers != NULL;
+        for (int k = 0; allocated && k < plan.stageCount; k++) {
+            lineBuffer *lb = &state.buffers[k];
+            lb->ringSize = plan.stages[k].above + plan.stages[k].below + 1;
+            lb->next = -1;
+            lb->rows = malloc((size_t)lb->ringSize * plan.width);
+            lb->scratch = malloc(2 * (size_t)plan.width);
+            allocated = lb->rows != NULL && lb->scratch != NULL;
+        }
+
+        if (allocated) {
+            int yEnd = MIN((t + 1) * TILE_ROWS, plan.height);
+            for (int y = t * TILE_ROWS; y < yEnd; y++) {
+                unsigned char *row = dst->data + y * rowSize;
+                if (plan.stageCount == 0) {
+                    sourceRow(plan.source, y, row, plan.width);
+                } else {
+                    stageRow(&state, plan.stageCount - 1, y, row);
+                }
+                if (plan.hasPost) {
+                    lutApply(plan.post, row, plan.width);
+                }
+            }
+        } else {
+            fprintf(stderr, "Memory allocation failed for line buffers!\n");
+            #pragma omp atomic write
+            ok = false;
+        }
+
+        if (state.buffers) {
+            for (int k = 0; k < plan.stageCount; k++) {
+                free(state.buffers[k].rows);
+                free(state.buffers[k].scratch);
+            }
+            free(state.buffers);
+        }
+    }
+
+    free(plan.stages);
+    return ok;
+}
+
+// Evaluate the graph ending at out into a newly allocated image
+BMP8Image* pipelineRun(pipeline* p, pipeNode* out) {
+    if (!out) {
+        fprintf(stderr, "Pipeline Error: No graph provided.\n");
+        return NULL;
+    }
+
+    // Walk to the source to find the output geometry
+    pipeNode *source = out;
+    while (source->input) {
+        source = source->input;
+    }
+
+    BMP8Image *dst = malloc(sizeof(BMP8Image));
+    if (!dst) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    dst->width = source->kind == NODE_SOURCE8 ? source->source8->width : source->source24->width;
+    dst->height = source->kind == NODE_SOURCE8 ? source->source8->height : source->source24->height;
+    dst->imgSize = ((dst->width + 3) & ~3) * dst->height;
+    // calloc keeps the row padding bytes zeroed
+    dst->data = calloc(dst->imgSize, 1);
+    if (!dst->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(dst);
+        return NULL;
+    }
+
+    if (!pipelineRunInto(p, out, dst)) {
+        free(dst->data);
+        free(dst);
+        return NULL;
+    }
+    return dst;
+}
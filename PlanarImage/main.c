@@ -0,0 +1,505 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+// Define BMP header size
+#define BMP_HEADER_SIZE 54
+// Size of color table for 8-bit BMP
+#define BMP_COLOR_TABLE_SIZE 1024
+// Alignment of every plane in bytes (one cache line / AVX-512 register)
+#define PLANE_ALIGNMENT 64
+// Number of color channels in a 24-bit image
+#define CHANNELS 3
+
+// Structure to store 24-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // BMP file header
+    unsigned char *data;                   // Pointer to pixel data (BGR format)
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int bitDepth;                          // Bits per pixel (should be 24)
+    int rowSize;                           // Size of one row including padding
+} BMP24Image;
+
+// Structure to hold 8-bit BMP image data
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE];          // BMP file header (54 bytes)
+    unsigned char colorTable[BMP_COLOR_TABLE_SIZE]; // Color table for 8-bit BMP (256 * 4 bytes)
+    unsigned char *data;                            // Pointer to pixel data
+    int width;                                      // Image width in pixels
+    int height;                                     // Image height in pixels
+    int bitDepth;                                   // Bits per pixel (8 for grayscale)
+    int imgSize;                                    // Total size of pixel data in bytes
+} BMP8Image;
+
+// Structure to store a 24-bit image as three separate 8-bit planes (SoA)
+// Every plane uses the 8-bit BMP row layout, so it can be handed to the
+// 8-bit operators unchanged, and starts on a PLANE_ALIGNMENT boundary
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE]; // Header of the source 24-bit BMP
+    unsigned char *planes[CHANNELS];       // Blue, green and red planes
+    int width;                             // Image width in pixels
+    int height;                            // Image height in pixels
+    int stride;                            // Bytes between rows of a plane
+} BMP24Planar;
+
+// Signature of an 8-bit operator that can be applied to every plane
+typedef BMP8Image* (*BMP8Operator)(BMP8Image* img, void* arg);
+
+// Read a 24-bit BMP image from file
+BMP24Image* BMP24Read(const char* filename) {
+    // Open file in binary read mode
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    // Allocate memory for BMP24Image structure
+    BMP24Image *img = (BMP24Image*)malloc(sizeof(BMP24Image));
+    // Read BMP header from file
+    fread(img->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+
+    // Extract image width, height and bit depth from BMP header
+    img->width = *(int*)&img->header[18];
+    img->height = *(int*)&img->header[22];
+    img->bitDepth = *(short*)&img->header[28];
+
+    // Check if the image is 24-bit
+    if (img->bitDepth != 24) {
+        fprintf(stderr, "Not a 24-bit BMP\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Calculate row size including padding to multiple of 4 bytes
+    img->rowSize = (img->width * 3 + 3) & (~3);
+    // Allocate memory for pixel data
+    img->data = (unsigned char*)malloc(img->rowSize * img->height);
+    // Read pixel data from file
+    fread(img->data, sizeof(unsigned char), img->rowSize * img->height, file);
+
+    // Close file
+    fclose(file);
+    return img;
+}
+
+// Save a 24-bit BMP image to file
+void BMP24Save(const char* filename, BMP24Image* img24) {
+    // Open file in binary write mode
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot create file %s\n", filename);
+        return;
+    }
+    // Write BMP header to file
+    fwrite(img24->header, sizeof(unsigned char), BMP_HEADER_SIZE, file);
+    // Write pixel data to file
+    fwrite(img24->data, sizeof(unsigned char), img24->rowSize * img24->height, file);
+    // Close file
+    fclose(file);
+}
+
+// Free memory allocated for 24-bit BMP image
+void BMP24Free(BMP24Image* img24) {
+    if (img24 != NULL){
+        free(img24->data);
+        free(img24);
+    }
+}
+
+// Free memory used by BMP8Image
+void BMP8Free(BMP8Image* img) {
+    if (img) {
+        free(img->data);
+        free(img);
+    }
+}
+
+// Function to blur image using averaging filter
+BMP8Image* BMP8Blur(BMP8Image* img, unsigned int size) {
+    // Allocate memory for blurred image structure
+    BMP8Image* blurredImg = malloc(sizeof(BMP8Image));
+    if (!blurredImg) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // Copy BMP header and metadata
+    memcpy(blurredImg->header, img->header, BMP_HEADER_SIZE);
+    blurredImg->width = img->width;
+    blurredImg->height = img->height;
+    blurredImg->bitDepth = img->bitDepth;
+
+    // Copy color table if image is 8-bit
+    if (img->bitDepth <= 8) {
+        memcpy(blurredImg->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    }
+
+    // Compute padded row size (each row aligned to 4 bytes)
+    int rowSize = (img->width + 3) & ~3;
+    blurredImg->imgSize = rowSize * img->height;
+
+    // Allocate memory for pixel data of blurred image
+    blurredImg->data = malloc(blurredImg->imgSize);
+    if (!blurredImg->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(blurredImg);
+        return NULL;
+    }
+
+    // Copy original image data to blurred image (so border pixels remain unchanged)
+    memcpy(blurredImg->data, img->data, blurredImg->imgSize);
+
+    // Convolution offset (half of kernel size)
+    int offset = size / 2;
+    // Equal weight of every tap of the averaging kernel
+    float value = 1.0f / (size * size);
+
+    // Apply averaging filter (ignoring border pixels)
+    for (int y = offset; y < img->height - offset; y++) {
+        for (int x = offset; x < img->width - offset; x++) {
+            float sum = 0.0f;
+
+            for (int j = -offset; j <= offset; j++) {
+                for (int i = -offset; i <= offset; i++) {
+                    sum += value * img->data[(y + j) * rowSize + (x + i)];
+                }
+            }
+
+            // Clamp result to valid grayscale range [0, 255]
+            if (sum < 0) sum = 0;
+            if (sum > 255) sum = 255;
+
+            blurredImg->data[y * rowSize + x] = (unsigned char)sum;
+        }
+    }
+
+    return blurredImg;
+}
+
+// Function to compute the normalized histogram of an 8-bit BMP image
+float* BMP8Histogram(BMP8Image* img){
+    // raw histogram counts
+    long int ihist[256] = {0};
+    // normalized histogram
+    float* hist = malloc(256 * sizeof(float));
+    if(!hist){
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    // row size including padding
+    int rowSize = (img->width + 3) & ~3;
+
+    // Count occurrences of each intensity
+    for(int y = 0; y < img->height; y++){
+        for(int x = 0; x < img->width; x++){
+            ihist[img->data[y * rowSize + x]]++;
+        }
+    }
+
+    // Normalize histogram
+    long int totalPixels = (long int)img->width * img->height;
+    for(int i = 0; i < 256; i++){
+        hist[i] = (float)ihist[i] / (float)totalPixels;
+    }
+    return hist;
+}
+
+// Allocate an empty planar image with aligned planes
+BMP24Planar* BMP24PlanarCreate(int width, int height, const unsigned char* header) {
+    BMP24Planar* planar = malloc(sizeof(BMP24Planar));
+    if (!planar) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+
+    memcpy(planar->header, header, BMP_HEADER_SIZE);
+    planar->width = width;
+    planar->height = height;
+    // Same row padding as an 8-bit BMP
+    planar->stride = (width + 3) & ~3;
+
+    // aligned_alloc requires the size to be a multiple of the alignment
+    size_t planeSize = ((size_t)planar->stride * height + PLANE_ALIGNMENT - 1) & ~(size_t)(PLANE_ALIGNMENT - 1);
+    for (int c = 0; c < CHANNELS; c++) {
+        planar->planes[c] = aligned_alloc(PLANE_ALIGNMENT, planeSize);
+        if (!planar->planes[c]) {
+            fprintf(stderr, "Memory allocation failed for plane %d!\n", c);
+            for (int p = 0; p < c; p++) {
+                free(planar->planes[p]);
+            }
+            free(planar);
+            return NULL;
+        }
+        // Zero so the padding bytes of every row are defined
+        memset(planar->planes[c], 0, planeSize);
+    }
+    return planar;
+}
+
+// Free memory allocated for a planar image
+void BMP24PlanarFree(BMP24Planar* planar) {
+    if (planar) {
+        for (int c = 0; c < CHANNELS; c++) {
+            free(planar->planes[c]);
+        }
+        free(planar);
+    }
+}
+
+// Split one row of interleaved BGR pixels into three planes
+static void deinterleaveRow(const unsigned char* src, unsigned char* b, unsigned char* g, unsigned char* r, int width) {
+    int x = 0;
+#ifdef __SSSE3__
+    // Vector path: 16 pixels (48 bytes) per iteration
+    for (; x + 16 <= width; x += 16) {
+        const unsigned char* p = src + x * 3;
+        __m128i v0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p + 32));
+
+        __m128i blue = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+        __m128i green = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+        __m128i red = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+
+        _mm_storeu_si128((__m128i*)(b + x), blue);
+        _mm_storeu_si128((__m128i*)(g + x), green);
+        _mm_storeu_si128((__m128i*)(r + x), red);
+    }
+#endif
+    // Scalar tail
+    for (; x < width; x++) {
+        b[x] = src[x * 3];
+        g[x] = src[x * 3 + 1];
+        r[x] = src[x * 3 + 2];
+    }
+}
+
+// Merge one row of three planes into interleaved BGR pixels
+static void interleaveRow(const unsigned char* b, const unsigned char* g, const unsigned char* r, unsigned char* dst, int width) {
+    int x = 0;
+#ifdef __SSSE3__
+    // Vector path: 16 pixels (48 bytes) per iteration
+    for (; x + 16 <= width; x += 16) {
+        __m128i blue = _mm_loadu_si128((const __m128i*)(b + x));
+        __m128i green = _mm_loadu_si128((const __m128i*)(g + x));
+        __m128i red = _mm_loadu_si128((const __m128i*)(r + x));
+
+        __m128i v0 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(blue, _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5)),
+            _mm_shuffle_epi8(green, _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1))),
+            _mm_shuffle_epi8(red, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+        __m128i v1 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(blue, _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1)),
+            _mm_shuffle_epi8(green, _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10))),
+            _mm_shuffle_epi8(red, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1)));
+        __m128i v2 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(blue, _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1)),
+            _mm_shuffle_epi8(green, _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1))),
+            _mm_shuffle_epi8(red, _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15)));
+
+        unsigned char* p = dst + x * 3;
+        _mm_storeu_si128((__m128i*)p, v0);
+        _mm_storeu_si128((__m128i*)(p + 16), v1);
+        _mm_storeu_si128((__m128i*)(p + 32), v2);
+    }
+#endif
+    // Scalar tail
+    for (; x < width; x++) {
+        dst[x * 3] = b[x];
+        dst[x * 3 + 1] = g[x];
+        dst[x * 3 + 2] = r[x];
+    }
+}
+
+// Convert an interleaved 24-bit BMP image to planar form
+BMP24Planar* BMP24ToPlanar(BMP24Image* img24) {
+    if (!img24) {
+        fprintf(stderr, "Planar Error: No image provided.\n");
+        return NULL;
+    }
+
+    BMP24Planar* planar = BMP24PlanarCreate(img24->width, img24->height, img24->header);
+    if (!planar) {
+        return NULL;
+    }
+
+    #pragma omp parallel for
+    for (int y = 0; y < img24->height; y++) {
+        int offset = y * planar->stride;
+        deinterleaveRow(img24->data + y * img24->rowSize,
+                        planar->planes[0] + offset, planar->planes[1] + offset, planar->planes[2] + offset,
+                        img24->width);
+    }
+    return planar;
+}
+
+// Convert a planar image back to an interleaved 24-bit BMP image
+BMP24Image* BMP24FromPlanar(BMP24Planar* planar) {
+    if (!planar) {
+        fprintf(stderr, "Planar Error: No image provided.\n");
+        return NULL;
+    }
+
+    BMP24Image* img24 = malloc(sizeof(BMP24Image));
+    if (!img24) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return NULL;
+    }
+    memcpy(img24->header, planar->header, BMP_HEADER_SIZE);
+    img24->width = planar->width;
+    img24->height = planar->height;
+    img24->bitDepth = 24;
+    img24->rowSize = (img24->width * 3 + 3) & (~3);
+
+    // Zeroed so the row padding bytes are defined
+    img24->data = calloc(img24->rowSize * img24->height, 1);
+    if (!img24->data) {
+        fprintf(stderr, "Memory allocation failed for pixel data!\n");
+        free(img24);
+        return NULL;
+    }
+
+    #pragma omp parallel for
+    for (int y = 0; y < planar->height; y++) {
+        int offset = y * planar->stride;
+        interleaveRow(planar->planes[0] + offset, planar->planes[1] + offset, planar->planes[2] + offset,
+                      img24->data + y * img24->rowSize, planar->width);
+    }
+    return img24;
+}
+
+// Describe one plane as an 8-bit greyscale BMP without copying pixel data
+// The view borrows the plane memory and must not be passed to BMP8Free
+void BMP24PlanarChannelView(BMP24Planar* planar, int channel, BMP8Image* view) {
+    memcpy(view->header, planar->header, BMP_HEADER_SIZE);
+    view->width = planar->width;
+    view->height = planar->height;
+    view->bitDepth = 8;
+    view->imgSize = planar->stride * planar->height;
+    view->data = planar->planes[channel];
+
+    // Patch header to describe an 8-bit image with a color table
+    *(short*)&view->header[28] = 8;
+    *(int*)&view->header[10] = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE;
+    *(int*)&view->header[34] = view->imgSize;
+
+    // Greyscale color table
+    for (int i = 0; i < 256; i++) {
+        view->colorTable[i*4 + 0] = i;
+        view->colorTable[i*4 + 1] = i;
+        view->colorTable[i*4 + 2] = i;
+        view->colorTable[i*4 + 3] = 0;
+    }
+}
+
+// Apply an 8-bit operator to every plane, processing the planes in parallel
+BMP24Planar* BMP24PlanarApply(BMP24Planar* planar, BMP8Operator op, void* arg) {
+    if (!planar || !op) {
+        fprintf(stderr, "Planar Error: Either there is no image or operator.\n");
+        return NULL;
+    }
+
+    BMP24Planar* result = BMP24PlanarCreate(planar->width, planar->height, planar->header);
+    if (!result) {
+        return NULL;
+    }
+
+    int failed = 0;
+    #pragma omp parallel for reduction(|:failed)
+    for (int c = 0; c < CHANNELS; c++) {
+        BMP8Image view;
+        BMP24PlanarChannelView(planar, c, &view);
+
+        BMP8Image* out = op(&view, arg);
+        // Operators must keep the image geometry
+        if (!out || out->width != planar->width || out->height != planar->height) {
+            failed = 1;
+        } else {
+            memcpy(result->planes[c], out->data, (size_t)result->stride * result->height);
+        }
+        BMP8Free(out);
+    }
+
+    if (failed) {
+        fprintf(stderr, "Planar Error: Operator failed on at least one plane.\n");
+        BMP24PlanarFree(result);
+        return NULL;
+    }
+    return result;
+}
+
+// Adapter exposing BMP8Blur as a plane operator
+static BMP8Image* blurOperator(BMP8Image* img, void* arg) {
+    return BMP8Blur(img, *(unsigned int*)arg);
+}
+
+int main() {
+    const char* channelNames[CHANNELS] = {"blue", "green", "red"};
+
+    // Read 24-bit BMP image
+    BMP24Image *img24 = BMP24Read("../Test_Images/lizard.bmp");
+    if (!img24) {
+        return 1;
+    }
+
+    // Split interleaved BGR data into aligned planes
+    BMP24Planar *planar = BMP24ToPlanar(img24);
+    if (!planar) {
+        BMP24Free(img24);
+        return 1;
+    }
+
+    // Per-channel histograms computed directly on the planes
+    for (int c = 0; c < CHANNELS; c++) {
+        BMP8Image view;
+        BMP24PlanarChannelView(planar, c, &view);
+        float* hist = BMP8Histogram(&view);
+        if (!hist) {
+            continue;
+        }
+
+        char filename[100];
+        sprintf(filename, "data/lizard_%s_histogram.txt", channelNames[c]);
+        FILE* fptr = fopen(filename, "w");
+        if (fptr) {
+            for (int i = 0; i < 256; i++) {
+                fprintf(fptr, "%f\n", hist[i]);
+            }
+            fclose(fptr);
+        }
+        free(hist);
+    }
+
+    // Blur every plane with the 8-bit engine, all planes in parallel
+    unsigned int kernelSize = 5;
+    BMP24Planar *blurredPlanar = BMP24PlanarApply(planar, blurOperator, &kernelSize);
+    BMP24Image *blurred = BMP24FromPlanar(blurredPlanar);
+    if (blurred) {
+        BMP24Save("images/lizard_blurred_5x5.bmp", blurred);
+    }
+
+    // Free allocated memory
+    BMP24Free(img24);
+    BMP24Free(blurred);
+    BMP24PlanarFree(planar);
+    BMP24PlanarFree(blurredPlanar);
+
+    fprintf(stdout, "Planar processing completed.\n");
+    return 0;
+}
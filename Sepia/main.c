@@ -1,6 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 // Define BMP header size
 #define BMP_HEADER_SIZE 54     
@@ -68,54 +71,248 @@ BMP24Image* BMP24Read(const char* filename) {
     return img;
 }
 
-// Apply sepia filter to 24-bit BMP image
-BMP24Image* BMP24Sepia(BMP24Image* img){
-    // Allocate new BMP image structure for sepia image
-    BMP24Image* sepiaImg = malloc(sizeof(BMP24Image));
-    if (!sepiaImg) {
+// Number of fractional bits used by the fixed-point color matrix kernel
+#define COLOR_MATRIX_SHIFT 12
+// Fixed-point representation of 1.0
+#define COLOR_MATRIX_ONE (1 << COLOR_MATRIX_SHIFT)
+
+// Structure describing a 3x3 color transform with an offset vector
+// out = m * in + offset, where in/out are (R, G, B) column vectors
+typedef struct {
+    float m[3][3];     // rows: output R, G, B; columns: input R, G, B
+    float offset[3];   // value added to output R, G, B
+} colorMatrix;
+
+// Fixed-point form of a color matrix in BGR memory order
+typedef struct {
+    int k[3][3];       // rows: output B, G, R; columns: input B, G, R
+    int bias[3];       // offset plus rounding term for output B, G, R
+} colorMatrixFixed;
+
+// Sepia tone (classic Microsoft coefficients)
+colorMatrix colorMatrixSepia(void) {
+    colorMatrix cm = {
+        {{0.393f, 0.769f, 0.189f},
+         {0.349f, 0.686f, 0.168f},
+         {0.272f, 0.534f, 0.131f}},
+        {0.0f, 0.0f, 0.0f}
+    };
+    return cm;
+}
+
+// Saturation adjustment: 0 gives greyscale, 1 identity, >1 boosts colors
+colorMatrix colorMatrixSaturation(float s) {
+    // Luminance weights (same as RGB to greyscale conversion)
+    const float lr = 0.3f, lg = 0.59f, lb = 0.11f;
+    colorMatrix cm = {
+        {{lr * (1 - s) + s, lg * (1 - s),     lb * (1 - s)},
+         {lr * (1 - s),     lg * (1 - s) + s, lb * (1 - s)},
+         {lr * (1 - s),     lg * (1 - s),     lb * (1 - s) + s}},
+        {0.0f, 0.0f, 0.0f}
+    };
+    return cm;
+}
+
+// White balance: independent gain for each channel
+colorMatrix colorMatrixWhiteBalance(float gainR, float gainG, float gainB) {
+    colorMatrix cm = {
+        {{gainR, 0.0f,  0.0f},
+         {0.0f,  gainG, 0.0f},
+         {0.0f,  0.0f,  gainB}},
+        {0.0f, 0.0f, 0.0f}
+    };
+    return cm;
+}
+
+// Channel mixer: each output channel is a weighted sum of the input channels
+colorMatrix colorMatrixChannelMix(const float mix[3][3]) {
+    colorMatrix cm = {{{0}}, {0.0f, 0.0f, 0.0f}};
+    memcpy(cm.m, mix, sizeof(cm.m));
+    return cm;
+}
+
+// Full-range BT.601 RGB to YCbCr (Y stored in R, Cb in G, Cr in B)
+colorMatrix colorMatrixRGBtoYCbCr(void) {
+    colorMatrix cm = {
+        {{ 0.299f,     0.587f,     0.114f},
+         {-0.168736f, -0.331264f,  0.5f},
+         { 0.5f,      -0.418688f, -0.081312f}},
+        {0.0f, 128.0f, 128.0f}
+    };
+    return cm;
+}
+
+// Convert a float color matrix to fixed point in BGR memory order
+// Coefficients must lie in (-8, 8) so they fit a signed 16-bit lane
+static void colorMatrixToFixed(const colorMatrix* cm, colorMatrixFixed* fx) {
+    for (int o = 0; o < 3; o++) {
+        // Output channel o in BGR order is row (2 - o) in RGB order
+        int row = 2 - o;
+        for (int i = 0; i < 3; i++) {
+            float c = cm->m[row][2 - i] * COLOR_MATRIX_ONE;
+            c = MIN(c, 32767.0f);
+            c = MAX(c, -32768.0f);
+            fx->k[o][i] = (int)(c < 0 ? c - 0.5f : c + 0.5f);
+        }
+        fx->bias[o] = (int)(cm->offset[row] * COLOR_MATRIX_ONE) + COLOR_MATRIX_ONE / 2;
+    }
+}
+
+// Transform a single BGR pixel with the fixed-point matrix
+static inline void colorMatrixPixel(const unsigned char* src, unsigned char* dst, const colorMatrixFixed* fx) {
+    int b = src[0], g = src[1], r = src[2];
+    for (int o = 0; o < 3; o++) {
+        int v = (fx->k[o][0] * b + fx->k[o][1] * g + fx->k[o][2] * r + fx->bias[o]) >> COLOR_MATRIX_SHIFT;
+        v = MIN(v, MAX_BRIGHTNESS);
+        v = MAX(v, MIN_BRIGHTNESS);
+        dst[o] = (unsigned char)v;
+    }
+}
+
+#ifdef __SSSE3__
+// Weighted sum of 8 pixels for one output channel (16-bit B, G, R lanes)
+static inline __m128i colorMatrixSum8(__m128i b, __m128i g, __m128i r, const colorMatrixFixed* fx, int o) {
+    // Coefficient pairs (kB, kG) and (kR, 0) for _mm_madd_epi16
+    __m128i kBG = _mm_set1_epi32((fx->k[o][1] << 16) | (fx->k[o][0] & 0xFFFF));
+    __m128i kR = _mm_set1_epi32(fx->k[o][2] & 0xFFFF);
+    __m128i bias = _mm_set1_epi32(fx->bias[o]);
+    __m128i zero = _mm_setzero_si128();
+
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(b, g), kBG),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(r, zero), kR));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(b, g), kBG),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(r, zero), kR));
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, bias), COLOR_MATRIX_SHIFT);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, bias), COLOR_MATRIX_SHIFT);
+    // Saturate to signed 16-bit, clamping to [0, 255] happens on the final pack
+    return _mm_packs_epi32(lo, hi);
+}
+
+// Transform 16 interleaved BGR pixels (48 bytes)
+static inline void colorMatrix16(const unsigned char* src, unsigned char* dst, const colorMatrixFixed* fx) {
+    __m128i a = _mm_loadu_si128((const __m128i*)src);
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+
+    // Deinterleave BGR into three planes of 16 bytes
+    __m128i blue = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    __m128i green = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    __m128i red = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(a, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(c, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+
+    // Widen to 16-bit lanes
+    __m128i zero = _mm_setzero_si128();
+    __m128i bLo = _mm_unpacklo_epi8(blue, zero), bHi = _mm_unpackhi_epi8(blue, zero);
+    __m128i gLo = _mm_unpacklo_epi8(green, zero), gHi = _mm_unpackhi_epi8(green, zero);
+    __m128i rLo = _mm_unpacklo_epi8(red, zero), rHi = _mm_unpackhi_epi8(red, zero);
+
+    // Compute each output plane and clamp to [0, 255]
+    __m128i outB = _mm_packus_epi16(colorMatrixSum8(bLo, gLo, rLo, fx, 0), colorMatrixSum8(bHi, gHi, rHi, fx, 0));
+    __m128i outG = _mm_packus_epi16(colorMatrixSum8(bLo, gLo, rLo, fx, 1), colorMatrixSum8(bHi, gHi, rHi, fx, 1));
+    __m128i outR = _mm_packus_epi16(colorMatrixSum8(bLo, gLo, rLo, fx, 2), colorMatrixSum8(bHi, gHi, rHi, fx, 2));
+
+    // Interleave the planes back into BGR order
+    a = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(outB, _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5)),
+        _mm_shuffle_epi8(outG, _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1))),
+        _mm_shuffle_epi8(outR, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+    b = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(outB, _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1)),
+        _mm_shuffle_epi8(outG, _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10))),
+        _mm_shuffle_epi8(outR, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1)));
+    c = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(outB, _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1)),
+        _mm_shuffle_epi8(outG, _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1))),
+        _mm_shuffle_epi8(outR, _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15)));
+
+    _mm_storeu_si128((__m128i*)dst, a);
+    _mm_storeu_si128((__m128i*)(dst + 16), b);
+    _mm_storeu_si128((__m128i*)(dst + 32), c);
+}
+#endif
+
+// Transform one row of interleaved BGR pixels (src and dst may alias)
+static void colorMatrixRow(const unsigned char* src, unsigned char* dst, int width, const colorMatrixFixed* fx) {
+    int x = 0;
+#ifdef __SSSE3__
+    // Vector path: 16 pixels per iteration
+    for (; x + 16 <= width; x += 16) {
+        colorMatrix16(src + x * 3, dst + x * 3, fx);
+    }
+#endif
+    // Scalar tail (same fixed-point arithmetic as the vector path)
+    for (; x < width; x++) {
+        colorMatrixPixel(src + x * 3, dst + x * 3, fx);
+    }
+}
+
+// Apply a color matrix to a 24-bit BMP image in place
+void BMP24ColorMatrixInPlace(BMP24Image* img, const colorMatrix* cm) {
+    if (!img || !cm) {
+        fprintf(stderr, "Color Matrix Error: Either there is no image or matrix.\n");
+        return;
+    }
+
+    colorMatrixFixed fx;
+    colorMatrixToFixed(cm, &fx);
+
+    for (int y = 0; y < img->height; y++) {
+        unsigned char *row = img->data + y * img->rowSize;
+        colorMatrixRow(row, row, img->width, &fx);
+    }
+}
+
+// Apply a color matrix to a 24-bit BMP image and return a new image
+BMP24Image* BMP24ColorMatrix(BMP24Image* img, const colorMatrix* cm) {
+    if (!img || !cm) {
+        fprintf(stderr, "Color Matrix Error: Either there is no image or matrix.\n");
+        return NULL;
+    }
+
+    // Allocate new BMP image structure for the result
+    BMP24Image* outImg = malloc(sizeof(BMP24Image));
+    if (!outImg) {
         fprintf(stderr, "Memory allocation failed!\n");
         return NULL;
     }
     // Copy header and metadata
-    memcpy(sepiaImg->header, img->header, BMP_HEADER_SIZE);
-    sepiaImg->width = img->width;
-    sepiaImg->height = img->height;
-    sepiaImg->bitDepth = img->bitDepth;
-    sepiaImg->rowSize = img->rowSize;
-
-    // Allocate memory for sepia pixel data
-    sepiaImg->data = malloc(sepiaImg->rowSize * sepiaImg->height);
-    if (!sepiaImg->data) {
+    memcpy(outImg->header, img->header, BMP_HEADER_SIZE);
+    outImg->width = img->width;
+    outImg->height = img->height;
+    outImg->bitDepth = img->bitDepth;
+    outImg->rowSize = img->rowSize;
+
+    // Allocate memory for pixel data (zeroed so row padding stays clean)
+    outImg->data = calloc(outImg->rowSize * outImg->height, 1);
+    if (!outImg->data) {
         fprintf(stderr, "Memory allocation failed for pixel data!\n");
-        free(sepiaImg);
+        free(outImg);
         return NULL;
     }
 
-    // Loop through each pixel
-    for (int y = 0; y < sepiaImg->height; y++) {
-        for (int x = 0; x < sepiaImg->width; x++) {
-            
-            int idx = y * sepiaImg->rowSize + x * 3;
-            // Extract original BGR components
-            int blue = img->data[idx];
-            int green = img->data[idx + 1];
-            int red = img->data[idx + 2];
-
-            // Apply sepia transformation
-            int tr = (int)(0.393 * red + 0.769 * green + 0.189 * blue);
-            int tg = (int)(0.349 * red + 0.686 * green + 0.168 * blue);
-            int tb = (int)(0.272 * red + 0.534 * green + 0.131 * blue);
-
-            // Clamp values to maximum brightness
-            // Blue
-            sepiaImg->data[idx] = MIN(tb, 255);
-            // Green
-            sepiaImg->data[idx + 1] = MIN(tg, 255);
-            // Red
-            sepiaImg->data[idx + 2] = MIN(tr, 255);
-        }
+    colorMatrixFixed fx;
+    colorMatrixToFixed(cm, &fx);
+
+    for (int y = 0; y < img->height; y++) {
+        colorMatrixRow(img->data + y * img->rowSize, outImg->data + y * outImg->rowSize, img->width, &fx);
     }
-    return sepiaImg;
+    return outImg;
+}
+
+// Apply sepia filter to 24-bit BMP image
+// Results are rounded to nearest; the former double-precision version truncated,
+// so a channel can be 1 higher than before (tolerance +-1 against older outputs)
+BMP24Image* BMP24Sepia(BMP24Image* img){
+    colorMatrix cm = colorMatrixSepia();
+    return BMP24ColorMatrix(img, &cm);
 }
 
 // Save a 24-bit BMP image to file
@@ -154,6 +351,11 @@ int main() {
     // Save sepia image to file
     BMP24Save("images/lizard_sepia.bmp", sepiaImg);
 
+    // Boost saturation in place using the same color matrix engine
+    colorMatrix saturation = colorMatrixSaturation(1.5f);
+    BMP24ColorMatrixInPlace(img24, &saturation);
+    BMP24Save("images/lizard_saturation150.bmp", img24);
+
     // Free allocated memory
     BMP24Free(img24);
     BMP24Free(sepiaImg);